@@ -108,6 +108,10 @@ func keyboardKey(event: (key: Int32, scancode: Int32, action: Int32, mods: Int32
 
 func main() {
     
+    // Set SWIFTTA_TRACE to a file path to record a Chrome trace of the session to it.
+    let tracePath = ProcessInfo.processInfo.environment["SWIFTTA_TRACE"]
+    if tracePath != nil { Trace.start() }
+    
     glfwSetErrorCallback() { (error, description) in
         fputs(description, stderr)
     }
@@ -146,6 +150,10 @@ func main() {
             else {
                 throw RuntimeError("Failed to initialize renderer.")
         }
+        // Set SWIFTTA_INDEXED_TEXTURES to keep the map & unit textures as 8-bit palette indices on the GPU.
+        if ProcessInfo.processInfo.environment["SWIFTTA_INDEXED_TEXTURES"] != nil {
+            renderer.textureFormat = .paletteIndex
+        }
         renderer.load(state: gameState)
         
         let manager = GameManager(state: gameState, renderer: renderer)
@@ -184,6 +192,11 @@ func main() {
     }
     
     game.manager.stop()
+    if let path = tracePath {
+        Trace.stop()
+        do { try Trace.write(to: URL(fileURLWithPath: path)) }
+        catch { print("Failed to write trace to \(path): \(error)") }
+    }
     glfwDestroyWindow(window)
     glfwTerminate()
     exit(EXIT_SUCCESS)
@@ -14,6 +14,9 @@ let package = Package(
         .library(
             name: "SwiftTA-Core",
             targets: ["SwiftTA-Core"]),
+        .executable(
+            name: "SwiftTA-Bench",
+            targets: ["SwiftTA-Bench"]),
     ],
     dependencies: [
         .package(path: "../SwiftTA-Ctypes"),
@@ -24,6 +27,9 @@ let package = Package(
         .target(
             name: "SwiftTA-Core",
             dependencies: ["SwiftTA-Ctypes"]),
+        .target(
+            name: "SwiftTA-Bench",
+            dependencies: ["SwiftTA-Core"]),
         .testTarget(
             name: "SwiftTA-CoreTests",
             dependencies: ["SwiftTA-Core"]),
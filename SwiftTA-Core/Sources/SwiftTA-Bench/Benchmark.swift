@@ -0,0 +1,338 @@
+//
+//  Benchmark.swift
+//  SwiftTA-Bench
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+import SwiftTA_Core
+
+
+/// Everything measured by a benchmark run; written out as JSON.
+struct BenchmarkResults: Codable {
+    var configuration: SyntheticAssets.Configuration
+    var iterations: Int
+    var assets: Assets
+    var mount: Mount
+    var load: Load
+    var gafDecode: GafDecode
+    var atlasPacking: AtlasPacking
+    var simulation: Simulation
+
+    struct Assets: Codable {
+        var files: Int
+        var bytes: Int
+        var archives: [SyntheticAssets.ArchiveInfo]
+        var generateSeconds: Double
+    }
+
+    struct Mount: Codable {
+        /// Mounting by parsing every archive's directory.
+        var parsed: Samples
+        /// Mounting from an up-to-date index file.
+        var indexed: Samples
+    }
+
+    struct Load: Codable {
+        var total: Samples
+        var map: Samples
+        var units: Samples
+        var features: Samples
+        var sides: Samples
+        var unitsLoaded: Int
+        var featuresLoaded: Int
+        /// Loading with every unit model & script already in an `AssetBakeCache`.
+        var baked: Samples
+        var bakedUnits: Samples
+    }
+
+    struct GafDecode: Codable {
+        var decoded: Samples
+        /// Loading every frame from an `AssetBakeCache`.
+        var baked: Samples
+    }
+
+    struct AtlasPacking: Codable {
+        /// Building a `UnitTextureAtlas` for every unit.
+        var unitAtlases: Samples
+        var unitAtlasPixels: Int
+        /// The fraction of every unit atlas' pixels covered by textures.
+        var unitAtlasOccupancy: Double
+        /// Every model texture, packed together.
+        var modelTextures: Pages
+        /// Every frame of the feature GAFs, packed together.
+        var featureFrames: Pages
+
+        struct Pages: Codable {
+            var textures: Int
+            var seconds: Samples
+            var pages: Int
+            var pagePixels: Int
+            var occupancy: Double
+        }
+    }
+
+    struct Simulation: Codable {
+        var ticks: Int
+        var units: Int
+        var total: Double
+        var perTick: Samples
+        var heightQueries: HeightQueries
+
+        /// Terrain heights of the same random positions; queried one at a time, and then as a batch.
+        struct HeightQueries: Codable {
+            var positions: Int
+            var single: Samples
+            var batched: Samples
+        }
+    }
+}
+
+/// A summary of repeated measurements, in seconds.
+struct Samples: Codable {
+    var count: Int
+    var min: Double
+    var median: Double
+    var mean: Double
+    var p95: Double
+    var max: Double
+
+    init(_ samples: [Double]) {
+        let sorted = samples.sorted()
+        count = sorted.count
+        min = sorted.first ?? 0
+        max = sorted.last ?? 0
+        mean = sorted.isEmpty ? 0 : sorted.reduce(0, +) / Double(sorted.count)
+        median = Samples.percentile(0.5, of: sorted)
+        p95 = Samples.percentile(0.95, of: sorted)
+    }
+
+    private static func percentile(_ p: Double, of sorted: [Double]) -> Double {
+        guard !sorted.isEmpty else { return 0 }
+        let index = Int((Double(sorted.count - 1) * p).rounded())
+        return sorted[index]
+    }
+}
+
+/// Runs `work` and returns its result along with how long it took, in seconds.
+func measure<T>(_ work: () throws -> T) rethrows -> (result: T, seconds: Double) {
+    let start = DispatchTime.now().uptimeNanoseconds
+    let result = try work()
+    let end = DispatchTime.now().uptimeNanoseconds
+    return (result, Double(end - start) / 1_000_000_000)
+}
+
+/**
+ A renderer that draws nothing; it only holds the view state that the `GameManager` constructs each update.
+ This lets the game run with no window or graphics context.
+ */
+final class HeadlessRenderer: GameRenderer {
+
+    var viewState: GameViewState
+
+    init?(loadedState: GameState, viewState: GameViewState) {
+        self.viewState = viewState
+    }
+
+}
+
+/// A GAF frame, as the atlas packer sees it.
+struct PackedFrame: PackableTexture {
+    var size: Size2<Int>
+}
+
+// MARK:- Stages
+
+struct Benchmark {
+
+    let directory: URL
+    let iterations: Int
+
+    /// Where the `AssetBakeCache` measurements bake their assets; emptied before each stage that uses it.
+    var bakeDirectory: URL { return directory.appendingPathComponent("bake", isDirectory: true) }
+
+    /// Mounts the archives in `directory`; first by parsing them and then from an index.
+    func mount() throws -> (fileSystem: FileSystem, results: BenchmarkResults.Mount) {
+        var parsed: [Double] = []
+        var fileSystem = FileSystem()
+        for _ in 0 ..< iterations {
+            let (mounted, seconds) = try measure { try FileSystem(mergingHpisIn: directory) }
+            parsed.append(seconds)
+            fileSystem = mounted
+        }
+
+        let indexURL = directory.appendingPathComponent("filesystem.index")
+        try? FileManager.default.removeItem(at: indexURL)
+        _ = try FileSystem(mergingHpisIn: directory, indexURL: indexURL)
+
+        var indexed: [Double] = []
+        for _ in 0 ..< iterations {
+            indexed.append(try measure { try FileSystem(mergingHpisIn: directory, indexURL: indexURL) }.seconds)
+        }
+
+        return (fileSystem, BenchmarkResults.Mount(parsed: Samples(parsed), indexed: Samples(indexed)))
+    }
+
+    /**
+     Loads the synthetic map (and every unit) into a `GameState`;
+     first decoding everything and then with every unit already baked.
+     */
+    func load(from fileSystem: FileSystem) throws -> (state: GameState, results: BenchmarkResults.Load) {
+        var timings: [GameState.LoadTimings] = []
+        var state: GameState? = nil
+        for _ in 0 ..< iterations {
+            let loaded = try GameState(loadFrom: fileSystem, mapName: SyntheticAssets.mapName, units: nil)
+            timings.append(loaded.loadTimings)
+            state = loaded
+        }
+
+        let bakeCache = try AssetBakeCache(directory: bakeDirectory)
+        try bakeCache.removeAll()
+        _ = try GameState(loadFrom: fileSystem, mapName: SyntheticAssets.mapName, units: nil, bakeCache: bakeCache)
+
+        var baked: [GameState.LoadTimings] = []
+        for _ in 0 ..< iterations {
+            baked.append(try GameState(loadFrom: fileSystem, mapName: SyntheticAssets.mapName, units: nil, bakeCache: bakeCache).loadTimings)
+        }
+
+        let results = BenchmarkResults.Load(
+            total: Samples(timings.map { $0.total }),
+            map: Samples(timings.map { $0.map }),
+            units: Samples(timings.map { $0.units }),
+            features: Samples(timings.map { $0.features }),
+            sides: Samples(timings.map { $0.sides }),
+            unitsLoaded: state?.units.count ?? 0,
+            featuresLoaded: state?.features.count ?? 0,
+            baked: Samples(baked.map { $0.total }),
+            bakedUnits: Samples(baked.map { $0.units }))
+        return (state!, results)
+    }
+
+    /// Decodes every frame of every GAF at `paths`; and then loads them all again, already baked.
+    func decodeGafs(at paths: [String], from fileSystem: FileSystem) throws -> BenchmarkResults.GafDecode {
+
+        func extractAll(times: Int, _ extract: (GafItem, FileSystem.FileHandle) throws -> [GafItem.Frame]) throws -> [Double] {
+            return try (0 ..< times).map { _ in
+                try measure {
+                    for path in paths {
+                        let gaf = try fileSystem.openFile(at: path)
+                        let listing = try GafListing(withContentsOf: gaf)
+                        for item in listing.items {
+                            _ = try extract(item, gaf)
+                        }
+                    }
+                }.seconds
+            }
+        }
+
+        let decoded = try extractAll(times: iterations) { try $0.extractFrames(from: $1) }
+
+        let bakeCache = try AssetBakeCache(directory: bakeDirectory)
+        try bakeCache.removeAll()
+        _ = try extractAll(times: 1) { try bakeCache.frames(of: $0, in: $1) }
+        let baked = try extractAll(times: iterations) { try bakeCache.frames(of: $0, in: $1) }
+
+        return BenchmarkResults.GafDecode(decoded: Samples(decoded), baked: Samples(baked))
+    }
+
+    /**
+     Builds every unit's texture atlas (from the textures in the `ModelTexturePack`);
+     then packs every model texture, and every frame of the GAFs at `featureGafPaths`, onto 1024x1024 atlas pages.
+     */
+    func packAtlases(for units: [UnitData], featureGafPaths: [String], from fileSystem: FileSystem) throws -> BenchmarkResults.AtlasPacking {
+        let texturePack = ModelTexturePack(loadFrom: fileSystem)
+
+        var atlases: [UnitTextureAtlas] = []
+        let unitAtlases = (0 ..< iterations).map { _ in
+            measure { atlases = units.map { UnitTextureAtlas(for: $0.model.textures, from: texturePack) } }.seconds
+        }
+        let atlasPixels = atlases.reduce(0) { $0 + $1.size.area }
+        let texturePixels = atlases.reduce(0.0) { $0 + $1.occupancy * Double($1.size.area) }
+
+        func packPages(_ frames: [PackedFrame]) -> BenchmarkResults.AtlasPacking.Pages {
+            var packing: TextureAtlasPacker.Packing! = nil
+            let seconds = (0 ..< iterations).map { _ in
+                measure { packing = TextureAtlasPacker.pack(frames, maxPageSize: Size2(1024, 1024)) }.seconds
+            }
+            return .init(textures: frames.count, seconds: Samples(seconds), pages: packing.pages.count,
+                         pagePixels: packing.pages.reduce(0) { $0 + $1.size.area }, occupancy: packing.occupancy)
+        }
+
+        let texturePaths = fileSystem.root[directory: "textures"]?.items
+            .compactMap { $0.asFile() }
+            .filter { $0.hasExtension("gaf") }
+            .map { "textures/" + $0.name } ?? []
+
+        return BenchmarkResults.AtlasPacking(
+            unitAtlases: Samples(unitAtlases),
+            unitAtlasPixels: atlasPixels,
+            unitAtlasOccupancy: atlasPixels > 0 ? texturePixels / Double(atlasPixels) : 0,
+            modelTextures: packPages(try frames(in: texturePaths, from: fileSystem, firstOnly: true)),
+            featureFrames: packPages(try frames(in: featureGafPaths, from: fileSystem, firstOnly: false)))
+    }
+
+    /// The size of every frame (or just the first of each item) in the GAFs at `paths`.
+    private func frames(in paths: [String], from fileSystem: FileSystem, firstOnly: Bool) throws -> [PackedFrame] {
+        return try paths.flatMap { path -> [PackedFrame] in
+            let gaf = try fileSystem.openFile(at: path)
+            return try GafListing(withContentsOf: gaf).items.flatMap { item in
+                try (0 ..< (firstOnly ? min(item.numberOfFrames, 1) : item.numberOfFrames)).map {
+                    PackedFrame(size: try item.readFrameMetadata(atIndex: $0, from: gaf).size)
+                }
+            }
+        }
+    }
+
+    /**
+     Spawns `unitCount` units spread over the map, each driving towards the opposite side,
+     and then runs `ticks` game updates back-to-back.
+     */
+    func simulate(_ state: GameState, unitCount: Int, ticks: Int, seed: UInt64) -> BenchmarkResults.Simulation {
+        let viewState = state.generateInitialViewState(viewportSize: Size2(1024, 768))
+        let renderer = HeadlessRenderer(loadedState: state, viewState: viewState)!
+        let game = GameManager(state: state, renderer: renderer, spawningDemoUnits: false)
+
+        var random = SplitMix64(seed: seed)
+        let types = state.units.keys.sorted { $0.name < $1.name }
+        let world = Size2f(state.map.resolution)
+        for i in 0 ..< unitCount where !types.isEmpty {
+            let start = Point2f(GameFloat(random.nextDouble()) * world.width, GameFloat(random.nextDouble()) * world.height)
+            let end = Point2f(world.width - start.x, world.height - start.y)
+            game.spawnUnit(types[i % types.count], at: start, movingTo: end)
+        }
+
+        var perTick: [Double] = []
+        perTick.reserveCapacity(ticks)
+        let total = measure {
+            for _ in 0 ..< ticks {
+                perTick.append(measure { game.step() }.seconds)
+            }
+        }.seconds
+
+        return BenchmarkResults.Simulation(ticks: ticks, units: unitCount, total: total, perTick: Samples(perTick),
+                                           heightQueries: queryHeights(state.map.heightMap, over: world, count: 64 * 1024, seed: seed))
+    }
+
+    /// Queries the terrain height at `count` random positions within `world`; one at a time, and then all at once.
+    func queryHeights(_ heightMap: HeightMap, over world: Size2f, count: Int, seed: UInt64) -> BenchmarkResults.Simulation.HeightQueries {
+        var random = SplitMix64(seed: seed)
+        let positions = (0 ..< count).map { _ in
+            Point2f(GameFloat(random.nextDouble()) * world.width, GameFloat(random.nextDouble()) * world.height)
+        }
+
+        var single: [Double] = []
+        var batched: [Double] = []
+        var checksum: GameFloat = 0
+        for _ in 0 ..< iterations {
+            single.append(measure { checksum += positions.reduce(0) { $0 + heightMap.height(atWorldPosition: $1) } }.seconds)
+            batched.append(measure { checksum -= heightMap.heights(atWorldPositions: positions).reduce(0, +) }.seconds)
+        }
+        // Keeps the queries from being optimized away; the two sums should cancel out exactly.
+        if checksum != 0 { log("!!! Batched heights differ from single queries (\(checksum))") }
+
+        return BenchmarkResults.Simulation.HeightQueries(positions: count, single: Samples(single), batched: Samples(batched))
+    }
+
+}
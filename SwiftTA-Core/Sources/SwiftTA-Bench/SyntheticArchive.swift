@@ -0,0 +1,319 @@
+//
+//  SyntheticArchive.swift
+//  SwiftTA-Bench
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+#if canImport(zlib)
+import zlib
+#elseif canImport(Czlib)
+import Czlib
+#endif
+
+
+/**
+ Writes Total Annihilation HPI archives.
+
+ File contents are stored as TA does: either whole & uncompressed, or split into 64 KB chunks
+ that are each LZ77 or ZLib compressed (and optionally chunk-encrypted).
+ If the archive is encrypted, everything after the header is encrypted with the archive key.
+ */
+struct SyntheticArchive {
+
+    enum Compression: String, Codable {
+        case none
+        case lz77
+        case zlib
+    }
+
+    var compression: Compression
+    var encrypted: Bool
+
+    /// A tree of files to write; every directory in a path is created as needed.
+    private var root = Node.directory([:])
+
+    init(compression: Compression, encrypted: Bool) {
+        self.compression = compression
+        self.encrypted = encrypted
+    }
+
+    mutating func add(_ contents: [UInt8], at path: String) {
+        root.insert(contents, at: path.split(separator: "/").map(String.init)[...])
+    }
+
+    /// Writes the archive to `url`, returning the number of bytes written.
+    @discardableResult
+    func write(to url: URL) throws -> Int {
+        var out = ByteWriter()
+
+        let headerKey: Int32 = encrypted ? 0x7D : 0
+        out.append(UInt32(0x49504148)) // 'HAPI'
+        out.append(UInt32(0x00010000)) // Total Annihilation
+        let directorySizeAt = out.count
+        out.append(UInt32(0))
+        out.append(headerKey)
+        out.append(UInt32(20))
+
+        // The directory comes first; each file's contents follow it, and their offsets are patched in afterwards.
+        var pendingFiles: [(entryAt: Int, contents: [UInt8])] = []
+        appendDirectory(root, to: &out, pending: &pendingFiles)
+        out.patch(UInt32(out.count - 20), at: directorySizeAt)
+
+        for (entryAt, contents) in pendingFiles {
+            out.patch(UInt32(out.count), at: entryAt)
+            appendFile(contents, to: &out)
+        }
+
+        if encrypted {
+            let key = ~((headerKey &* 4) | (headerKey >> 6))
+            out.encryptArchive(from: 20, key: key)
+        }
+
+        try Data(out.bytes).write(to: url)
+        return out.count
+    }
+
+}
+
+// MARK:- Directory
+
+private extension SyntheticArchive {
+
+    indirect enum Node {
+        case file([UInt8])
+        case directory([String: Node])
+
+        mutating func insert(_ contents: [UInt8], at path: ArraySlice<String>) {
+            guard case var .directory(children) = self, let name = path.first else { return }
+            if path.count == 1 {
+                children[name] = .file(contents)
+            }
+            else {
+                var child = children[name] ?? .directory([:])
+                child.insert(contents, at: path.dropFirst())
+                children[name] = child
+            }
+            self = .directory(children)
+        }
+    }
+
+    /// Appends a TA_HPI_DIR_HEADER and its entries; all offsets are absolute.
+    func appendDirectory(_ node: Node, to out: inout ByteWriter, pending: inout [(entryAt: Int, contents: [UInt8])]) {
+        guard case let .directory(children) = node else { return }
+        let sorted = children.sorted { $0.key.lowercased() < $1.key.lowercased() }
+
+        out.append(UInt32(sorted.count))
+        out.append(UInt32(out.count + 4))
+        let entryArray = out.count
+        out.append(zeros: sorted.count * 9)
+
+        for (i, (name, child)) in sorted.enumerated() {
+            let entryAt = entryArray + i * 9
+            out.patch(UInt32(out.count), at: entryAt)
+            out.append(cString: name)
+            out.patch(UInt32(out.count), at: entryAt + 4)
+            switch child {
+            case let .file(contents):
+                out.bytes[entryAt + 8] = 0
+                pending.append((out.count, contents))
+                out.append(UInt32(0)) // offset to file data; patched later
+                out.append(UInt32(contents.count))
+                out.append(UInt8(contents.isEmpty ? 0 : compressionType))
+            case .directory:
+                out.bytes[entryAt + 8] = 1
+                appendDirectory(child, to: &out, pending: &pending)
+            }
+        }
+    }
+
+    var compressionType: UInt8 {
+        switch compression {
+        case .none: return 0
+        case .lz77: return 1
+        case .zlib: return 2
+        }
+    }
+
+}
+
+// MARK:- File Data
+
+private extension SyntheticArchive {
+
+    static let chunkSize = 65536
+
+    func appendFile(_ contents: [UInt8], to out: inout ByteWriter) {
+        guard compression != .none, !contents.isEmpty else {
+            out.append(contents)
+            return
+        }
+
+        let chunks = stride(from: 0, to: contents.count, by: SyntheticArchive.chunkSize).map {
+            makeChunk(contents[$0 ..< min($0 + SyntheticArchive.chunkSize, contents.count)])
+        }
+        for chunk in chunks { out.append(UInt32(chunk.count)) }
+        for chunk in chunks { out.append(chunk) }
+    }
+
+    /// A TA_HPI_CHUNK header followed by its compressed (and possibly encrypted) data.
+    func makeChunk(_ data: ArraySlice<UInt8>) -> [UInt8] {
+        var compressed = compression == .zlib ? SyntheticArchive.deflate(data) : SyntheticArchive.compressLZ77(data)
+        if encrypted {
+            for i in compressed.indices {
+                let x = UInt8(truncatingIfNeeded: i)
+                compressed[i] = (compressed[i] ^ x) &+ x
+            }
+        }
+
+        var chunk = ByteWriter()
+        chunk.append(UInt32(0x48535153)) // 'SQSH'
+        chunk.append(UInt8(2))
+        chunk.append(compressionType)
+        chunk.append(UInt8(encrypted ? 1 : 0))
+        chunk.append(UInt32(compressed.count))
+        chunk.append(UInt32(data.count))
+        chunk.append(compressed.reduce(UInt32(0)) { $0 &+ UInt32($1) })
+        chunk.append(compressed)
+        return chunk.bytes
+    }
+
+    /**
+     Compresses `input` into the LZ77 variant that TA uses (see `decompressLZ77` in hpi.swift).
+     A simple greedy encoder; matching on the most recent occurence of each 2-byte prefix.
+     */
+    static func compressLZ77(_ input: ArraySlice<UInt8>) -> [UInt8] {
+        let input = Array(input)
+        var out: [UInt8] = []
+        out.reserveCapacity(input.count + input.count / 8 + 3)
+
+        var recent = [Int](repeating: -1, count: 1 << 16)
+        var flagsAt = 0
+        var bit = 8
+
+        func beginToken(isMatch: Bool) {
+            if bit == 8 {
+                flagsAt = out.count
+                out.append(0)
+                bit = 0
+            }
+            if isMatch { out[flagsAt] |= UInt8(1 << bit) }
+            bit += 1
+        }
+
+        func prefix(at i: Int) -> Int {
+            return Int(input[i]) | (Int(input[i + 1]) << 8)
+        }
+
+        var i = 0
+        while i < input.count {
+            var length = 0
+            var position = 0
+
+            if i + 1 < input.count {
+                let candidate = recent[prefix(at: i)]
+                let distance = i - candidate
+                position = (i + 1 - distance) & 0xFFF
+                if candidate >= 0 && distance < 0x1000 && position != 0 {
+                    let limit = min(17, input.count - i)
+                    while length < limit && input[candidate + length] == input[i + length] { length += 1 }
+                }
+            }
+
+            let step: Int
+            if length >= 2 {
+                beginToken(isMatch: true)
+                let token = (position << 4) | (length - 2)
+                out.append(UInt8(token & 0xFF))
+                out.append(UInt8(token >> 8))
+                step = length
+            }
+            else {
+                beginToken(isMatch: false)
+                out.append(input[i])
+                step = 1
+            }
+
+            for j in i ..< i + step where j + 1 < input.count {
+                recent[prefix(at: j)] = j
+            }
+            i += step
+        }
+
+        // Position zero marks the end of the stream.
+        beginToken(isMatch: true)
+        out.append(0)
+        out.append(0)
+        return out
+    }
+
+    static func deflate(_ input: ArraySlice<UInt8>) -> [UInt8] {
+        var bound = compressBound(uLong(input.count))
+        var out = [UInt8](repeating: 0, count: Int(bound))
+        let result = input.withUnsafeBufferPointer { source in
+            compress2(&out, &bound, source.baseAddress, uLong(source.count), Z_DEFAULT_COMPRESSION)
+        }
+        precondition(result == Z_OK, "compress2 failed: \(result)")
+        return Array(out[..<Int(bound)])
+    }
+
+}
+
+// MARK:- Bytes
+
+/// A growable little-endian byte buffer, for writing the various TA binary formats.
+struct ByteWriter {
+
+    var bytes: [UInt8] = []
+
+    var count: Int { return bytes.count }
+
+    mutating func append(_ value: UInt8) { bytes.append(value) }
+    mutating func append(_ value: UInt16) { withUnsafeBytes(of: value.littleEndian) { bytes.append(contentsOf: $0) } }
+    mutating func append(_ value: Int16) { append(UInt16(bitPattern: value)) }
+    mutating func append(_ value: UInt32) { withUnsafeBytes(of: value.littleEndian) { bytes.append(contentsOf: $0) } }
+    mutating func append(_ value: Int32) { append(UInt32(bitPattern: value)) }
+    mutating func append<C: Collection>(_ other: C) where C.Element == UInt8 { bytes.append(contentsOf: other) }
+
+    mutating func append(zeros count: Int) {
+        bytes.append(contentsOf: repeatElement(0, count: count))
+    }
+
+    mutating func append(cString string: String) {
+        bytes.append(contentsOf: string.utf8)
+        bytes.append(0)
+    }
+
+    /// Appends `string` as a zero padded, fixed size field.
+    mutating func append(_ string: String, paddedTo size: Int) {
+        let utf8 = Array(string.utf8.prefix(size - 1))
+        bytes.append(contentsOf: utf8)
+        append(zeros: size - utf8.count)
+    }
+
+    /// Appends a placeholder for a 32-bit value, to be patched later; returns its offset.
+    mutating func reserveUInt32() -> Int {
+        let at = count
+        append(UInt32(0))
+        return at
+    }
+
+    mutating func patch(_ value: UInt32, at offset: Int) {
+        withUnsafeBytes(of: value.littleEndian) { bytes.replaceSubrange(offset ..< offset + 4, with: $0) }
+    }
+
+    mutating func patch(_ value: Int32, at offset: Int) {
+        patch(UInt32(bitPattern: value), at: offset)
+    }
+
+    /// The inverse of `HpiItem.decrypt`: every byte `d` at offset `o` becomes `~(d ^ (o ^ key))`.
+    mutating func encryptArchive(from start: Int, key: Int32) {
+        let key8 = UInt8(truncatingIfNeeded: key)
+        for o in start ..< bytes.count {
+            bytes[o] = ~(bytes[o] ^ (UInt8(truncatingIfNeeded: o) ^ key8))
+        }
+    }
+
+}
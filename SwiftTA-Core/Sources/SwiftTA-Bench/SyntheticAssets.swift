@@ -0,0 +1,715 @@
+//
+//  SyntheticAssets.swift
+//  SwiftTA-Bench
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+
+/**
+ Generates a synthetic (but format-valid) Total Annihilation game:
+ a map (TNT & OTA), units (FBI, 3DO & COB), features (TDF & GAF), side data and some filler files.
+ Everything is derived from a seed, so the same configuration always generates the same bytes.
+ */
+struct SyntheticAssets {
+
+    struct Configuration: Codable {
+        var seed: UInt64
+        /// The number of units; half ARM & half CORE.
+        var units: Int
+        /// The number of pieces in each unit's model.
+        var piecesPerUnit: Int
+        /// The map's size in map units (16 pixels each); both dimensions are even.
+        var mapSize: Int
+        /// The number of distinct features placed on the map.
+        var featureTypes: Int
+        /// The fraction of map cells with a feature on them.
+        var featureDensity: Double
+        /// The number of frames in each feature's GAF sequence.
+        var framesPerFeature: Int
+        /// The number of unrelated files (eg. sounds) padding out the archives.
+        var fillerFiles: Int
+        /// The number of archives the files are spread across.
+        var archives: Int
+    }
+
+    static let mapName = "Synthetic Plains"
+
+    let configuration: Configuration
+    /// Every generated file, keyed by its path in the game's filesystem.
+    private(set) var files: [String: [UInt8]] = [:]
+    /// The name of every generated unit.
+    private(set) var unitNames: [String] = []
+
+    init(_ configuration: Configuration) {
+        self.configuration = configuration
+        var random = SplitMix64(seed: configuration.seed)
+
+        let features = (0 ..< configuration.featureTypes).map { "synfeat\($0)" }
+        unitNames = (0 ..< configuration.units).map { i in
+            let side = i % 2 == 0 ? "arm" : "cor"
+            return i < 2 ? side + "com" : side + String(format: "syn%04d", i / 2)
+        }
+
+        generateMap(features: features, random: &random)
+        generateFeatures(features, random: &random)
+        for (i, name) in unitNames.enumerated() {
+            generateUnit(name, side: i % 2 == 0 ? "ARM" : "CORE", random: &random)
+        }
+        generateTextures(random: &random)
+        generateSides()
+        generateFiller(random: &random)
+    }
+
+    /**
+     Writes every file into `configuration.archives` archives in `directory`.
+     The archives cycle through every combination of compression (LZ77 & ZLib) and encryption;
+     files are dealt out to them round-robin, so most directories are merged from several archives.
+     */
+    func writeArchives(to directory: URL) throws -> [ArchiveInfo] {
+        let variants: [(SyntheticArchive.Compression, Bool)] = [(.lz77, false), (.zlib, false), (.lz77, true), (.zlib, true)]
+        var archives = (0 ..< max(configuration.archives, 1)).map { (i) -> SyntheticArchive in
+            let (compression, encrypted) = variants[i % variants.count]
+            return SyntheticArchive(compression: compression, encrypted: encrypted)
+        }
+
+        for (i, path) in files.keys.sorted().enumerated() {
+            archives[i % archives.count].add(files[path]!, at: path)
+        }
+
+        return try archives.enumerated().map { (i, archive) -> ArchiveInfo in
+            let name = String(format: "synthetic%02d.hpi", i)
+            let size = try archive.write(to: directory.appendingPathComponent(name))
+            return ArchiveInfo(name: name, compression: archive.compression, encrypted: archive.encrypted, bytes: size)
+        }
+    }
+
+    struct ArchiveInfo: Codable {
+        var name: String
+        var compression: SyntheticArchive.Compression
+        var encrypted: Bool
+        var bytes: Int
+    }
+
+    /// The gaf files generated, as paths in the game's filesystem.
+    var gafPaths: [String] {
+        return files.keys.filter { $0.hasSuffix(".gaf") }.sorted()
+    }
+
+    /// The name of every texture the unit models refer to; each an item of `textures/synthetic.gaf`.
+    var textureNames: [String] {
+        return unitNames.flatMap { unit in SyntheticAssets.texturedPieces.flatMap { piece in SyntheticAssets.texturedFaces.map { "\(unit)tex\(piece)_\($0)" } } }
+    }
+
+    /// The unit models' pieces share textures in turn: a unit has this many sets of them.
+    static let texturedPieces = 0 ..< 4
+    /// The faces of each piece with a texture; the others are flat colored.
+    static let texturedFaces = [0, 1, 3, 4, 6]
+
+}
+
+// MARK:- Map
+
+private extension SyntheticAssets {
+
+    mutating func generateMap(features: [String], random: inout SplitMix64) {
+        let size = configuration.mapSize & ~1
+        let tileCount = 256
+        let tileIndexCount = (size / 2) * (size / 2)
+
+        var tnt = ByteWriter()
+        tnt.append(Int32(0x2000))
+        tnt.append(UInt32(size))
+        tnt.append(UInt32(size))
+        let offsetToTileIndexArray = tnt.reserveUInt32()
+        let offsetToMapInfoArray = tnt.reserveUInt32()
+        let offsetToTileArray = tnt.reserveUInt32()
+        tnt.append(UInt32(tileCount))
+        tnt.append(UInt32(features.count))
+        let offsetToFeatureEntryArray = tnt.reserveUInt32()
+        tnt.append(UInt32(20)) // sea level
+        let offsetToMiniMap = tnt.reserveUInt32()
+        tnt.append(UInt32(1))
+        tnt.append(zeros: 16)
+
+        tnt.patch(UInt32(tnt.count), at: offsetToTileIndexArray)
+        for _ in 0 ..< tileIndexCount {
+            tnt.append(UInt16(random.next(below: tileCount)))
+        }
+
+        // Rolling hills; with a feature on some fraction of the cells.
+        tnt.patch(UInt32(tnt.count), at: offsetToMapInfoArray)
+        for y in 0 ..< size {
+            for x in 0 ..< size {
+                let hills = sin(Double(x) * 0.07) * cos(Double(y) * 0.05) + sin(Double(x + y) * 0.013)
+                tnt.append(UInt8(clamping: Int(64 + hills * 30)))
+                let hasFeature = !features.isEmpty && random.nextDouble() < configuration.featureDensity
+                tnt.append(UInt16(hasFeature ? random.next(below: features.count) : 0xFFFF))
+                tnt.append(UInt8(0))
+            }
+        }
+
+        tnt.patch(UInt32(tnt.count), at: offsetToTileArray)
+        for tile in 0 ..< tileCount {
+            for p in 0 ..< 32 * 32 {
+                tnt.append(UInt8(truncatingIfNeeded: tile &+ (p / 32) &* 3 &+ (p % 32) / 4))
+            }
+        }
+
+        tnt.patch(UInt32(tnt.count), at: offsetToFeatureEntryArray)
+        for (i, name) in features.enumerated() {
+            tnt.append(UInt32(i))
+            tnt.append(name, paddedTo: 128)
+        }
+
+        tnt.patch(UInt32(tnt.count), at: offsetToMiniMap)
+        let minimapSize = 252
+        tnt.append(UInt32(minimapSize))
+        tnt.append(UInt32(minimapSize))
+        for p in 0 ..< minimapSize * minimapSize {
+            tnt.append(UInt8(truncatingIfNeeded: p / minimapSize + p % minimapSize))
+        }
+
+        files["maps/\(SyntheticAssets.mapName).tnt"] = tnt.bytes
+
+        let resolution = size * 16
+        files["maps/\(SyntheticAssets.mapName).ota"] = Array("""
+            [GlobalHeader]
+            \t{
+            \tmissionname=\(SyntheticAssets.mapName);
+            \tmissiondescription=A generated map for benchmarking.;
+            \tplanet=Green Planet;
+            \tmissionhint=;
+            \tbrief=;
+            \tnarration=;
+            \tglamour=;
+            \tlineofsight=1;
+            \tmapping=1;
+            \ttidalstrength=20;
+            \tsolarstrength=20;
+            \tlavaworld=0;
+            \tkillmul=50;
+            \ttimemul=0;
+            \tminwindspeed=0;
+            \tmaxwindspeed=2000;
+            \tgravity=112;
+            \tnumplayers=2, 4;
+            \tsize=\(size / 32) x \(size / 32);
+            \tmemory=32 mb;
+            \tuseonlyunits=;
+            \tSCHEMACOUNT=1;
+            \t[Schema 0]
+            \t\t{
+            \t\tType=Network 1;
+            \t\taiprofile=DEFAULT;
+            \t\tSurfaceMetal=3;
+            \t\tMohoMetal=30;
+            \t\tHumanMetal=1000;
+            \t\tComputerMetal=1000;
+            \t\tHumanEnergy=1000;
+            \t\tComputerEnergy=1000;
+            \t\tMeteorWeapon=;
+            \t\tMeteorRadius=0;
+            \t\tMeteorDensity=0;
+            \t\tMeteorDuration=0;
+            \t\tMeteorInterval=0;
+            \t\t[specials]
+            \t\t\t{
+            \t\t\t[special0]
+            \t\t\t\t{
+            \t\t\t\tspecialwhat=StartPos1;
+            \t\t\t\tXPos=\(resolution / 4);
+            \t\t\t\tZPos=\(resolution / 4);
+            \t\t\t\t}
+            \t\t\t[special1]
+            \t\t\t\t{
+            \t\t\t\tspecialwhat=StartPos2;
+            \t\t\t\tXPos=\(resolution * 3 / 4);
+            \t\t\t\tZPos=\(resolution * 3 / 4);
+            \t\t\t\t}
+            \t\t\t}
+            \t\t}
+            \t}
+
+            """.utf8)
+    }
+
+}
+
+// MARK:- Features
+
+private extension SyntheticAssets {
+
+    /// The map's features go in the planet's directory, eight to a TDF; each has a GAF sequence (and shadow) in one shared GAF.
+    mutating func generateFeatures(_ features: [String], random: inout SplitMix64) {
+        for (file, group) in stride(from: 0, to: features.count, by: 8).map({ ($0 / 8, features[$0 ..< min($0 + 8, features.count)]) }) {
+            files["features/green/synthetic\(file).tdf"] = Array(group.map { name in
+                featureTDF(name, world: "greenworld", footprint: 1 + random.next(below: 3), gaf: "synfeat", dead: "smudge01")
+            }.joined().utf8)
+        }
+        files["features/All Worlds/smudges.tdf"] = Array(featureTDF("smudge01", world: "allworld", footprint: 2, gaf: "smudges", dead: nil).utf8)
+
+        let sequences = features.flatMap { [$0, $0 + "sh"] }
+        files["anims/synfeat.gaf"] = gaf(sequences, random: &random)
+        files["anims/smudges.gaf"] = gaf(["smudge01"], random: &random)
+    }
+
+    /// A unit's corpse and the heap it becomes.
+    mutating func generateCorpses(for unit: String) {
+        files["features/corpses/\(unit)_dead.tdf"] = Array((
+            featureTDF("\(unit)_dead", world: "allworld", footprint: 2, gaf: nil, dead: "\(unit)_heap") +
+            featureTDF("\(unit)_heap", world: "allworld", footprint: 2, gaf: nil, dead: nil)
+            ).utf8)
+    }
+
+    func featureTDF(_ name: String, world: String, footprint: Int, gaf: String?, dead: String?) -> String {
+        return """
+            [\(name)]
+            \t{
+            \tworld=\(world);
+            \tdescription=Synthetic \(name);
+            \tcategory=\(gaf == nil ? "corpses" : "trees");
+            \tfootprintx=\(footprint);
+            \tfootprintz=\(footprint);
+            \theight=20;
+            \tblocking=1;
+            \thitdensity=5;
+            \tdamage=100;
+            \treclaimable=1;
+            \tenergy=25;
+            \tmetal=0;
+            \tflamable=1;
+            \tsparktime=4;
+            \tspreadchance=90;
+            \tburnmin=5;
+            \tburnmax=15;
+            \tburnweapon=TreeBurn;
+            \tfeatureburnt=\(dead ?? "smudge01");
+            \tfeaturereclamate=\(dead ?? "smudge01");
+            \(dead.map { "\tfeaturedead=\($0);\n" } ?? "")\
+            \(gaf.map { "\tfilename=\($0);\n\tseqname=\(name);\n\tseqnameshad=\(name)sh;\n" } ?? "\tobject=\(name);\n")\
+            \t}
+
+            """
+    }
+
+    /**
+     A GAF with one entry per sequence name, `frames` (or `framesPerFeature`) frames each.
+     Frames alternate between TA's run-length encoding and uncompressed, and are 16-64 pixels to a side;
+     or, if given, one of `sideLengths`.
+     */
+    func gaf(_ sequences: [String], frames: Int? = nil, sideLengths: [Int]? = nil, random: inout SplitMix64) -> [UInt8] {
+        var out = ByteWriter()
+        out.append(UInt32(0x00010100))
+        out.append(UInt32(sequences.count))
+        out.append(UInt32(0))
+        let entryPointers = out.count
+        out.append(zeros: sequences.count * 4)
+
+        for (i, name) in sequences.enumerated() {
+            out.patch(UInt32(out.count), at: entryPointers + i * 4)
+            let frameCount = max(frames ?? configuration.framesPerFeature, 1)
+            out.append(UInt16(frameCount))
+            out.append(UInt16(1))
+            out.append(UInt32(0))
+            out.append(name, paddedTo: 32)
+
+            let frameEntries = out.count
+            out.append(zeros: frameCount * 8)
+
+            for f in 0 ..< frameCount {
+                out.patch(UInt32(out.count), at: frameEntries + f * 8)
+                let width = sideLengths.map { $0[random.next(below: $0.count)] } ?? 16 + random.next(below: 48)
+                let height = sideLengths.map { $0[random.next(below: $0.count)] } ?? 16 + random.next(below: 48)
+                let compressed = f % 2 == 0
+                let pixels = frameImage(width: width, height: height, color: UInt8(truncatingIfNeeded: 16 + i * 7 + f))
+
+                out.append(UInt16(width))
+                out.append(UInt16(height))
+                out.append(Int16(width / 2))
+                out.append(Int16(height - 4))
+                out.append(UInt8(0)) // transparency index; the same as the background
+                out.append(UInt8(compressed ? 1 : 0))
+                out.append(UInt16(0)) // no subframes
+                out.append(UInt32(0))
+                let offsetToFrameData = out.reserveUInt32()
+                out.append(UInt32(0))
+
+                out.patch(UInt32(out.count), at: offsetToFrameData)
+                out.append(compressed ? runLengthEncode(pixels, width: width) : pixels)
+            }
+        }
+
+        return out.bytes
+    }
+
+    /// A rough, banded ellipse on a transparent (zero) background.
+    func frameImage(width: Int, height: Int, color: UInt8) -> [UInt8] {
+        var pixels = [UInt8](repeating: 0, count: width * height)
+        let cx = Double(width) / 2, cy = Double(height) / 2
+        for y in 0 ..< height {
+            for x in 0 ..< width {
+                let dx = (Double(x) - cx) / cx, dy = (Double(y) - cy) / cy
+                if dx * dx + dy * dy < 1 {
+                    pixels[y * width + x] = (y / 4) % 3 == 0 ? color : color &+ UInt8(truncatingIfNeeded: x)
+                }
+            }
+        }
+        return pixels
+    }
+
+    /// Encodes `pixels` as the line-by-line run-length encoding decoded by `GafItem`.
+    func runLengthEncode(_ pixels: [UInt8], width: Int) -> [UInt8] {
+        var out: [UInt8] = []
+        for line in stride(from: 0, to: pixels.count, by: width) {
+            let row = pixels[line ..< line + width]
+            var encoded: [UInt8] = []
+            var x = row.startIndex
+            while x < row.endIndex {
+                var run = 1
+                while x + run < row.endIndex && row[x + run] == row[x] { run += 1 }
+
+                if row[x] == 0 {
+                    run = min(run, 127)
+                    encoded.append(UInt8(run << 1) | 1)
+                    x += run
+                }
+                else if run > 1 {
+                    run = min(run, 64)
+                    encoded.append(UInt8((run - 1) << 2) | 2)
+                    encoded.append(row[x])
+                    x += run
+                }
+                else {
+                    // Copy literally up to the next run (or transparent pixel).
+                    var count = 1
+                    while x + count < row.endIndex && count < 64 && row[x + count] != 0
+                        && !(x + count + 1 < row.endIndex && row[x + count + 1] == row[x + count]) { count += 1 }
+                    encoded.append(UInt8((count - 1) << 2))
+                    encoded.append(contentsOf: row[x ..< x + count])
+                    x += count
+                }
+            }
+            out.append(UInt8(encoded.count & 0xFF))
+            out.append(UInt8(encoded.count >> 8))
+            out.append(contentsOf: encoded)
+        }
+        return out
+    }
+
+}
+
+// MARK:- Units
+
+private extension SyntheticAssets {
+
+    mutating func generateUnit(_ name: String, side: String, random: inout SplitMix64) {
+        let pieces = ["base", "turret", "barrel"] + (0 ..< max(configuration.piecesPerUnit - 3, 0)).map { "wheel\($0)" }
+        let footprint = 2 + random.next(below: 3)
+
+        files["units/\(name).fbi"] = Array("""
+            [UNITINFO]
+            \t{
+            \tUnitName=\(name.uppercased());
+            \tVersion=1.2;
+            \tSide=\(side);
+            \tObjectName=\(name.uppercased());
+            \tDesignation=\(name.uppercased());
+            \tName=Synthetic \(name);
+            \tDescription=Generated Benchmark Unit;
+            \tFootprintX=\(footprint);
+            \tFootprintZ=\(footprint);
+            \tBuildCostEnergy=\(1000 + random.next(below: 9000));
+            \tBuildCostMetal=\(100 + random.next(below: 900));
+            \tMaxDamage=\(500 + random.next(below: 3000));
+            \tMaxWaterDepth=20;
+            \tMaxSlope=15;
+            \tEnergyUse=0;
+            \tBuildTime=\(2000 + random.next(below: 8000));
+            \tWorkerTime=0;
+            \tBMcode=1;
+            \tBuilder=0;
+            \tThreeD=1;
+            \tZBuffer=1;
+            \tNoAutoFire=0;
+            \tSightDistance=\(200 + random.next(below: 400));
+            \tRadarDistance=0;
+            \tSoundCategory=\(side)_TANK;
+            \tEnergyStorage=0;
+            \tMetalStorage=0;
+            \tExplodeAs=MEDIUM_UNITEX;
+            \tSelfDestructAs=MEDIUM_UNIT;
+            \tCategory=\(side) TANK LEVEL1 WEAPON NOTAIR NOTSUB CTRL_W;
+            \tTEDClass=TANK;
+            \tCorpse=\(name)_dead;
+            \tCanMove=1;
+            \tCanStop=1;
+            \tCanAttack=1;
+            \tCanGuard=1;
+            \tCanPatrol=1;
+            \tMovementClass=TANKSH2;
+            \tMaxVelocity=\(1 + random.next(below: 3)).\(random.next(below: 10));
+            \tBrakeRate=0.\(1 + random.next(below: 9));
+            \tAcceleration=0.0\(1 + random.next(below: 9));
+            \tTurnRate=\(300 + random.next(below: 700));
+            \tSteeringMode=1;
+            \tShootMe=1;
+            \tWeapon1=\(side)_LIGHTLASER;
+            \tDefaultMissionType=Standby;
+            \tMobileStandOrders=1;
+            \tStandingFireOrder=2;
+            \tStandingMoveOrder=1;
+            \t}
+
+            """.utf8)
+
+        files["objects3d/\(name).3do"] = model(pieces, textures: name, random: &random)
+        files["scripts/\(name).cob"] = script(pieces)
+        generateCorpses(for: name)
+    }
+
+    /**
+     A 3DO model of `pieces`: a base, with a turret (and barrel) and every other piece (the wheels) as its children.
+     Every piece is a box, most of its faces textured with one of the `textures` set (see `textureNames`);
+     the base also has the ground plate.
+     */
+    func model(_ pieces: [String], textures: String, random: inout SplitMix64) -> [UInt8] {
+        var out = ByteWriter()
+        let faces: [[UInt16]] = [[0, 1, 3, 2], [4, 6, 7, 5], [0, 4, 5, 1], [2, 3, 7, 6], [0, 2, 6, 4], [1, 5, 7, 3], [0, 1, 5, 4]]
+
+        func children(of index: Int) -> [Int] {
+            switch index {
+            case 0: return [1] + Array(3 ..< max(pieces.count, 3))
+            case 1: return [2]
+            default: return []
+            }
+        }
+
+        /// Appends a TA_3DO_OBJECT (and everything it refers to); returns the offset of its sibling field, to be linked by the caller.
+        func appendObject(_ index: Int) -> (offset: Int, siblingField: Int) {
+            let at = out.count
+            let isRoot = index == 0
+            let primitiveCount = isRoot ? faces.count : faces.count - 1
+            let size = Int32(8 + random.next(below: 16)) << 16
+
+            out.append(UInt32(1))
+            out.append(UInt32(8))
+            out.append(UInt32(primitiveCount))
+            out.append(Int32(isRoot ? faces.count - 1 : -1)) // ground plate
+            out.append(isRoot ? 0 : Int32(random.next(below: 16) - 8) << 16)
+            out.append(isRoot ? 0 : Int32(4) << 16)
+            out.append(isRoot ? 0 : Int32(random.next(below: 16) - 8) << 16)
+            let offsetToObjectName = out.reserveUInt32()
+            out.append(UInt32(0))
+            let offsetToVertexArray = out.reserveUInt32()
+            let offsetToPrimitiveArray = out.reserveUInt32()
+            let offsetToSiblingObject = out.reserveUInt32()
+            let offsetToChildObject = out.reserveUInt32()
+
+            out.patch(UInt32(out.count), at: offsetToObjectName)
+            out.append(cString: pieces[index])
+
+            out.patch(UInt32(out.count), at: offsetToVertexArray)
+            for v in 0 ..< 8 {
+                out.append(v & 1 == 0 ? -size : size)
+                out.append(v & 2 == 0 ? 0 : size)
+                out.append(v & 4 == 0 ? -size : size)
+            }
+
+            // TA_3DO_PRIMITIVE is 32 bytes: color, index count, unknown, offset to indices, offset to texture name & 3 unknowns.
+            out.patch(UInt32(out.count), at: offsetToPrimitiveArray)
+            let primitives = out.count
+            out.append(zeros: primitiveCount * 32)
+            for p in 0 ..< primitiveCount {
+                let primitive = primitives + p * 32
+                out.patch(UInt32(p), at: primitive)
+                out.patch(UInt32(faces[p].count), at: primitive + 4)
+                out.patch(UInt32(out.count), at: primitive + 12)
+                faces[p].forEach { out.append($0) }
+                if SyntheticAssets.texturedFaces.contains(p) {
+                    out.patch(UInt32(out.count), at: primitive + 16)
+                    out.append(cString: "\(textures)tex\(index % SyntheticAssets.texturedPieces.count)_\(p)")
+                }
+            }
+
+            var previousSibling: Int? = nil
+            for child in children(of: index) {
+                let (childAt, siblingField) = appendObject(child)
+                out.patch(UInt32(childAt), at: previousSibling ?? offsetToChildObject)
+                previousSibling = siblingField
+            }
+
+            return (at, offsetToSiblingObject)
+        }
+
+        _ = appendObject(0)
+        return out.bytes
+    }
+
+    /**
+     A COB script with the modules the game runs:
+     `Create` spins the wheels and swings the turret back & forth forever (sleeping every swing);
+     `StartMoving` & `StopMoving` spin the base's first wheel up & down; `Killed` does nothing.
+     */
+    func script(_ pieces: [String]) -> [UInt8] {
+        typealias Op = UInt32
+        let push: Op = 0x10021001, pushLocal: Op = 0x10021002, stackAllocate: Op = 0x10022000, setLocal: Op = 0x10023002
+        let add: Op = 0x10031000, turn: Op = 0x10002000, startSpin: Op = 0x10003000, stopSpin: Op = 0x10004000
+        let sleep: Op = 0x10013000, jump: Op = 0x10064000, ret: Op = 0x10065000
+        let wheel: UInt32 = pieces.count > 3 ? 3 : 0
+        let degrees = { (d: Int32) in UInt32(bitPattern: d * 182) }
+
+        var code: [UInt32] = []
+        var modules: [(name: String, offset: Int)] = []
+
+        modules.append(("Create", code.count))
+        code += [stackAllocate]
+        for p in 3 ..< max(pieces.count, 3) {
+            code += [push, degrees(30), push, degrees(180), startSpin, UInt32(p), 0]
+        }
+        let loop = UInt32(code.count)
+        code += [pushLocal, 0, push, 1, add, setLocal, 0]
+        code += [push, degrees(90), push, degrees(30), turn, 1, 1, push, 0, sleep]
+        code += [push, degrees(90), push, degrees(-30), turn, 1, 1, push, 0, sleep]
+        code += [jump, loop]
+
+        modules.append(("StartMoving", code.count))
+        code += [push, degrees(60), push, degrees(360), startSpin, wheel, 0, push, 0, ret]
+
+        modules.append(("StopMoving", code.count))
+        code += [push, degrees(120), stopSpin, wheel, 0, push, 0, ret]
+
+        modules.append(("Killed", code.count))
+        code += [push, 0, ret]
+
+        var out = ByteWriter()
+        out.append(UInt32(4))
+        out.append(UInt32(modules.count))
+        out.append(UInt32(pieces.count))
+        out.append(UInt32(code.count))
+        out.append(UInt32(0)) // static variables
+        out.append(Int32(0))
+        let offsetToModulePointerArray = out.reserveUInt32()
+        let offsetToModuleNameOffsetArray = out.reserveUInt32()
+        let offsetToPieceNameOffsetArray = out.reserveUInt32()
+        let offsetToFirstModule = out.reserveUInt32()
+        let offsetToNameArray = out.reserveUInt32()
+        let offsetToSoundNameArray = out.reserveUInt32()
+        out.append(UInt32(0)) // sounds
+
+        out.patch(UInt32(out.count), at: offsetToFirstModule)
+        code.forEach { out.append($0) }
+
+        out.patch(UInt32(out.count), at: offsetToModulePointerArray)
+        modules.forEach { out.append(UInt32($0.offset)) }
+
+        let moduleNameOffsets = out.count
+        out.patch(UInt32(moduleNameOffsets), at: offsetToModuleNameOffsetArray)
+        out.append(zeros: modules.count * 4)
+        let pieceNameOffsets = out.count
+        out.patch(UInt32(pieceNameOffsets), at: offsetToPieceNameOffsetArray)
+        out.append(zeros: pieces.count * 4)
+        out.patch(UInt32(out.count), at: offsetToSoundNameArray)
+
+        out.patch(UInt32(out.count), at: offsetToNameArray)
+        for (i, module) in modules.enumerated() {
+            out.patch(UInt32(out.count), at: moduleNameOffsets + i * 4)
+            out.append(cString: module.name)
+        }
+        for (i, piece) in pieces.enumerated() {
+            out.patch(UInt32(out.count), at: pieceNameOffsets + i * 4)
+            out.append(cString: piece)
+        }
+
+        return out.bytes
+    }
+
+}
+
+// MARK:- Textures
+
+private extension SyntheticAssets {
+
+    /// Every unit texture, in a single GAF; each a single frame of 8-64 pixels (a power of two) to a side.
+    mutating func generateTextures(random: inout SplitMix64) {
+        files["textures/synthetic.gaf"] = gaf(textureNames, frames: 1, sideLengths: [8, 16, 32, 64], random: &random)
+    }
+
+}
+
+// MARK:- Sides & Filler
+
+private extension SyntheticAssets {
+
+    mutating func generateSides() {
+        files["gamedata/sidedata.tdf"] = Array("""
+            [SIDE0]
+            \t{
+            \tname=ARM;
+            \tnameprefix=ARM;
+            \tcommander=ARMCOM;
+            \tintgaf=ARMINT;
+            \tfont=armfont;
+            \tpalette=armbar;
+            \tenergycolor=208;
+            \tmetalcolor=224;
+            \t}
+            [SIDE1]
+            \t{
+            \tname=CORE;
+            \tnameprefix=COR;
+            \tcommander=CORCOM;
+            \tintgaf=CORINT;
+            \tfont=corfont;
+            \tpalette=corbar;
+            \tenergycolor=208;
+            \tmetalcolor=224;
+            \t}
+
+            """.utf8)
+    }
+
+    /// Sound-like files: mostly noise (which barely compresses) with some silence (which compresses well).
+    mutating func generateFiller(random: inout SplitMix64) {
+        for i in 0 ..< configuration.fillerFiles {
+            let size = 256 + random.next(below: 16 * 1024)
+            let bytes = (0 ..< size).map { (p: Int) -> UInt8 in
+                (p / 1024) % 2 == 0 ? UInt8(truncatingIfNeeded: random.next()) : 128
+            }
+            files["sounds/synth\(i % 16)/sound\(i).wav"] = bytes
+        }
+    }
+
+}
+
+// MARK:- Random
+
+/// A small, seedable random number generator; so that generated assets are reproducible.
+struct SplitMix64: RandomNumberGenerator {
+
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+
+    mutating func next(below bound: Int) -> Int {
+        return Int(next() % UInt64(bound))
+    }
+
+    mutating func nextDouble() -> Double {
+        return Double(next() >> 11) / Double(1 << 53)
+    }
+
+}
@@ -0,0 +1,205 @@
+//
+//  main.swift
+//  SwiftTA-Bench
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+import SwiftTA_Core
+
+
+/*
+ A headless benchmark of SwiftTA's loading & simulation; no game data, window or graphics context required.
+
+ A synthetic game (HPI archives of a map, units, features, etc.) is generated at the requested scale.
+ The benchmark then times mounting the archives, loading a GameState from them, decoding their GAFs
+ (each of these last two both with and without an AssetBakeCache), packing texture atlases (reporting their occupancy)
+ and running a number of game updates; and writes the results as JSON.
+ Progress is logged to stderr.
+
+ Usage: SwiftTA-Bench [options]
+   --scale small|medium|large   A preset for every generator option below (default: medium)
+   --units N                    Number of unit types
+   --pieces N                   Number of pieces in each unit's model
+   --map-size N                 Map size, in map units
+   --feature-types N            Number of distinct map features
+   --feature-density F          Fraction of map cells with a feature
+   --frames N                   Frames per feature animation
+   --filler N                   Number of filler files
+   --archives N                 Number of archives to spread the files across
+   --seed N                     Seed for the generated assets
+   --spawn N                    Number of units in the simulation
+   --ticks N                    Number of simulation updates to run
+   --iterations N               Number of times to repeat each load measurement (default: 5)
+   --assets DIR                 Write the archives to DIR (and keep them); otherwise a temporary directory is used
+   --output PATH                Where to write the JSON results (default: bench-results.json)
+   --trace PATH                 Record a Chrome trace of the whole run to PATH
+ */
+
+struct Options {
+    var assets: SyntheticAssets.Configuration
+    var spawn: Int
+    var ticks: Int
+    var iterations = 5
+    var assetsDirectory: URL? = nil
+    var output = "bench-results.json"
+    var trace: URL? = nil
+
+    static func preset(_ name: String) -> Options? {
+        switch name {
+        case "small":
+            return Options(assets: .init(seed: 1, units: 16, piecesPerUnit: 4, mapSize: 64, featureTypes: 32, featureDensity: 0.02,
+                                         framesPerFeature: 4, fillerFiles: 256, archives: 4),
+                           spawn: 32, ticks: 120)
+        case "medium":
+            return Options(assets: .init(seed: 1, units: 128, piecesPerUnit: 8, mapSize: 256, featureTypes: 256, featureDensity: 0.02,
+                                         framesPerFeature: 8, fillerFiles: 2048, archives: 4),
+                           spawn: 256, ticks: 300)
+        case "large":
+            return Options(assets: .init(seed: 1, units: 512, piecesPerUnit: 12, mapSize: 512, featureTypes: 1024, featureDensity: 0.02,
+                                         framesPerFeature: 16, fillerFiles: 8192, archives: 8),
+                           spawn: 1024, ticks: 600)
+        default:
+            return nil
+        }
+    }
+
+    enum ParseError: Error, CustomStringConvertible {
+        case unknownOption(String)
+        case badValue(String, String)
+        case missingValue(String)
+
+        var description: String {
+            switch self {
+            case .unknownOption(let option): return "Unknown option: \(option)"
+            case .badValue(let option, let value): return "Bad value for \(option): \(value)"
+            case .missingValue(let option): return "Missing value for \(option)"
+            }
+        }
+    }
+
+    static func parse(_ arguments: [String]) throws -> Options {
+        var remaining = arguments[...]
+
+        func value(for option: String) throws -> String {
+            guard let value = remaining.popFirst() else { throw ParseError.missingValue(option) }
+            return value
+        }
+        func number<T: LosslessStringConvertible>(for option: String) throws -> T {
+            let string = try value(for: option)
+            guard let number = T(string) else { throw ParseError.badValue(option, string) }
+            return number
+        }
+
+        // The scale is applied first, so that any other option overrides it.
+        var options = Options.preset("medium")!
+        if let i = arguments.firstIndex(of: "--scale"), i + 1 < arguments.count {
+            guard let preset = Options.preset(arguments[i + 1]) else { throw ParseError.badValue("--scale", arguments[i + 1]) }
+            options = preset
+        }
+
+        while let option = remaining.popFirst() {
+            switch option {
+            case "--scale": _ = try value(for: option)
+            case "--units": options.assets.units = try number(for: option)
+            case "--pieces": options.assets.piecesPerUnit = try number(for: option)
+            case "--map-size": options.assets.mapSize = try number(for: option)
+            case "--feature-types": options.assets.featureTypes = try number(for: option)
+            case "--feature-density": options.assets.featureDensity = try number(for: option)
+            case "--frames": options.assets.framesPerFeature = try number(for: option)
+            case "--filler": options.assets.fillerFiles = try number(for: option)
+            case "--archives": options.assets.archives = try number(for: option)
+            case "--seed": options.assets.seed = try number(for: option)
+            case "--spawn": options.spawn = try number(for: option)
+            case "--ticks": options.ticks = try number(for: option)
+            case "--iterations": options.iterations = max(try number(for: option), 1)
+            case "--assets": options.assetsDirectory = URL(fileURLWithPath: try value(for: option), isDirectory: true)
+            case "--output": options.output = try value(for: option)
+            case "--trace": options.trace = URL(fileURLWithPath: try value(for: option))
+            default: throw ParseError.unknownOption(option)
+            }
+        }
+        return options
+    }
+}
+
+func log(_ message: String) {
+    FileHandle.standardError.write(Data((message + "\n").utf8))
+}
+
+func run(_ options: Options) throws {
+    if options.trace != nil { Trace.start() }
+
+    let directory = options.assetsDirectory
+        ?? FileManager.default.temporaryDirectory.appendingPathComponent("SwiftTA-Bench-\(UUID().uuidString)", isDirectory: true)
+    try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    defer { if options.assetsDirectory == nil { try? FileManager.default.removeItem(at: directory) } }
+
+    log("Generating assets in \(directory.path)")
+    let ((assets, archives), generateSeconds) = try measure { () -> (SyntheticAssets, [SyntheticAssets.ArchiveInfo]) in
+        let assets = SyntheticAssets(options.assets)
+        return (assets, try assets.writeArchives(to: directory))
+    }
+    log("Generated \(assets.files.count) files in \(archives.count) archives (\(String(format: "%.2f", generateSeconds))s)")
+
+    let benchmark = Benchmark(directory: directory, iterations: options.iterations)
+
+    log("Mounting...")
+    let (fileSystem, mount) = try benchmark.mount()
+    log("Loading...")
+    let (state, load) = try benchmark.load(from: fileSystem)
+    log("Decoding GAFs...")
+    let gafDecode = try benchmark.decodeGafs(at: assets.gafPaths, from: fileSystem)
+    log("Packing atlases...")
+    let atlasPacking = try benchmark.packAtlases(for: state.units.values.sorted { $0.info.name < $1.info.name },
+                                                 featureGafPaths: assets.gafPaths.filter { $0.hasPrefix("anims/") },
+                                                 from: fileSystem)
+    log("Simulating...")
+    let simulation = benchmark.simulate(state, unitCount: options.spawn, ticks: options.ticks, seed: options.assets.seed)
+
+    let results = BenchmarkResults(
+        configuration: options.assets,
+        iterations: options.iterations,
+        assets: .init(files: assets.files.count,
+                      bytes: archives.reduce(0) { $0 + $1.bytes },
+                      archives: archives,
+                      generateSeconds: generateSeconds),
+        mount: mount,
+        load: load,
+        gafDecode: gafDecode,
+        atlasPacking: atlasPacking,
+        simulation: simulation)
+
+    let encoder = JSONEncoder()
+    encoder.outputFormatting = .prettyPrinted
+    let json = try encoder.encode(results)
+    try json.write(to: URL(fileURLWithPath: options.output), options: .atomic)
+    log("Wrote results to \(options.output)")
+
+    if let trace = options.trace {
+        Trace.stop()
+        try Trace.write(to: trace)
+        log("Wrote trace to \(trace.path)")
+    }
+
+    log(String(format: "mount %.4fs (indexed %.4fs), load %.4fs (baked %.4fs), gafs %.4fs (baked %.4fs), tick %.5fs (p95 %.5fs)",
+               mount.parsed.median, mount.indexed.median, load.total.median, load.baked.median,
+               gafDecode.decoded.median, gafDecode.baked.median,
+               simulation.perTick.median, simulation.perTick.p95))
+    log(String(format: "atlases: units %.4fs (%.1f%% occupied), textures %.4fs (%d pages, %.1f%%), features %.4fs (%d pages, %.1f%%)",
+               atlasPacking.unitAtlases.median, atlasPacking.unitAtlasOccupancy * 100,
+               atlasPacking.modelTextures.seconds.median, atlasPacking.modelTextures.pages, atlasPacking.modelTextures.occupancy * 100,
+               atlasPacking.featureFrames.seconds.median, atlasPacking.featureFrames.pages, atlasPacking.featureFrames.occupancy * 100))
+    log(String(format: "heights: %d positions, single %.5fs, batched %.5fs",
+               simulation.heightQueries.positions, simulation.heightQueries.single.median, simulation.heightQueries.batched.median))
+}
+
+do {
+    try run(try Options.parse(Array(CommandLine.arguments.dropFirst())))
+}
+catch {
+    log("Error: \(error)")
+    exit(1)
+}
@@ -0,0 +1,438 @@
+//
+//  AssetBakeCache.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/*
+ An asset bake cache is a directory of binary files, each holding one decoded asset (a `UnitModel`,
+ a `UnitScript` or the frames of a `GafItem`) in a form that can be loaded straight out of a memory mapping.
+ Loading a baked asset skips extracting its file from its archive (and decompressing it) as well as decoding it.
+
+ A baked asset is content-addressed by the identity of the archive entry it was decoded from:
+ the archive's path, size & modification time and the entry's offset & size in the archive
+ (plus any other detail that affects the decoded result; eg. which GAF frames were decoded).
+ Any change to an archive therefore changes the key of every asset in it, and stale bakes are never read.
+ The file name of a baked asset is a hash of its key; the full key is stored in the file as well and is
+ checked on load, so a hash collision is no more than a cache miss.
+
+ Layout (all integers are little-endian; floats are IEEE 754 single precision):
+
+     UInt32  magic ('STAB')
+     UInt32  version
+     UInt32  kind (1: model, 2: script, 3: GAF frames)
+     UInt32  key byte count
+     [key byte count] key {
+         String  archive path
+         UInt64  archive size
+         Int64   archive modification time (nanoseconds since 1970)
+         UInt64  offset of the entry in the archive
+         UInt64  size of the entry
+         UInt32  detail count, [detail count] UInt64
+     }
+     ...     padding to a multiple of 16 bytes
+     ...     payload
+
+ A model's payload:
+
+     UInt32  root piece, UInt32 ground plate primitive
+     UInt32  vertex count, [vertex count] { Float x, Float y, Float z }
+     UInt32  texture count, [texture count] { UInt32 type (0: color, 1: image), then either Int32 color or String name }
+     UInt32  primitive count, [primitive count] { UInt32 texture, UInt32 index count, [index count] UInt32 vertex }
+     UInt32  piece count, [piece count] {
+         String  name
+         Float x, Float y, Float z
+         UInt32  primitive count, [primitive count] UInt32
+         UInt32  child count, [child count] UInt32
+     }
+
+ A script's payload:
+
+     UInt32  static variable count
+     UInt32  code count, [code count] Int32
+     UInt32  module count, [module count] { String name, UInt32 code offset, UInt32 local count }
+     UInt32  piece count, [piece count] String
+
+ The frames' payload:
+
+     UInt32  frame count, [frame count] {
+         Int32   width, Int32 height, Int32 x offset, Int32 y offset
+         UInt32  pixel format (0: palette index, 1: 4444, 2: 1555)
+         UInt32  byte count
+         ...     padding to a multiple of 16 bytes
+         [byte count] UInt8 pixels
+     }
+
+ where String := UInt32 byte count, UTF-8 bytes
+
+ Each frame's pixels are aligned in the file (and so in the mapping), and are handed out as `Data`
+ that references the mapping directly; they are never copied on load.
+ */
+
+/**
+ A persistent cache of decoded unit models, unit scripts & GAF frames.
+ See the top of AssetBakeCache.swift for details.
+
+ Each asset is decoded as usual the first time it is asked for, and is then baked into the cache;
+ every later request (in this run or any other) maps the baked asset instead.
+ A missing, outdated or corrupt bake is simply decoded (and baked) again.
+
+ An `AssetBakeCache` is safe to use from multiple threads at once.
+ */
+public final class AssetBakeCache {
+
+    public let directory: URL
+
+    private var stamps: [URL: FileSystem.ArchiveStamp] = [:]
+    private let lock = NSLock()
+
+    static let marker: UInt32 = 0x42415453 // 'STAB'
+    /// Bumped whenever what gets baked changes; eg. 2, when GAF run-length encoded lines stopped carrying over into the next row.
+    static let version: UInt32 = 2
+
+    /// Opens (or creates) the bake cache in `directory`.
+    public init(directory: URL) throws {
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        self.directory = directory
+    }
+
+    /// The model in the 3DO file, either mapped from the cache or decoded (and then baked).
+    public func model(contentsOf file: FileSystem.FileHandle) throws -> UnitModel {
+        return try baked(.model, of: file.file, read: { try $0.readModel() }, write: { $0.write($1) }) {
+            try UnitModel(contentsOf: file)
+        }
+    }
+
+    /// The script in the COB file, either mapped from the cache or decoded (and then baked).
+    public func script(contentsOf file: FileSystem.FileHandle) throws -> UnitScript {
+        return try baked(.script, of: file.file, read: { try $0.readScript() }, write: { $0.write($1) }) {
+            try UnitScript(contentsOf: file)
+        }
+    }
+
+    /// Every frame of `item` in the GAF file, either mapped from the cache or decoded (and then baked).
+    public func frames(of item: GafItem, in gaf: FileSystem.FileHandle) throws -> [GafItem.Frame] {
+        return try baked(.frames, of: gaf.file, detail: item.frameOffsets, read: { try $0.readFrames() }, write: { $0.write($1) }) {
+            try item.extractFrames(from: gaf)
+        }
+    }
+
+    /// Removes every baked asset from the cache.
+    public func removeAll() throws {
+        let contents = try FileManager.default.contentsOfDirectory(at: directory, includingPropertiesForKeys: nil)
+        for url in contents where url.pathExtension == AssetBakeCache.pathExtension {
+            try FileManager.default.removeItem(at: url)
+        }
+    }
+
+    enum Kind: UInt32 {
+        case model = 1
+        case script = 2
+        case frames = 3
+    }
+
+    public enum BakeError: Error {
+        case badMarker
+        case unsupportedVersion(Int)
+        case keyMismatch
+        case truncated
+        case badValue
+    }
+
+}
+
+// MARK:- Lookup
+
+private extension AssetBakeCache {
+
+    static let pathExtension = "bake"
+
+    func baked<T>(_ kind: Kind, of file: FileSystem.File, detail: [Int] = [],
+                  read: (inout BinaryReader) throws -> T,
+                  write: (inout BinaryWriter, T) -> Void,
+                  decode: () throws -> T) throws -> T {
+
+        // Without an archive to identify it by, the asset can't be baked at all.
+        guard let key = try? self.key(kind, of: file, detail: detail) else { return try decode() }
+        let url = self.url(for: key)
+
+        if let value = try? load(kind, key: key, from: url, read) {
+            return value
+        }
+
+        let value = try decode()
+
+        var writer = BinaryWriter()
+        writer.write(AssetBakeCache.marker)
+        writer.write(AssetBakeCache.version)
+        writer.write(kind.rawValue)
+        writer.write(UInt32(key.count))
+        writer.data.append(contentsOf: key)
+        writer.align(to: 16)
+        write(&writer, value)
+
+        do { try writer.data.write(to: url, options: .atomic) }
+        catch { print("Failed to write baked asset \(url.path): \(error)") }
+
+        return value
+    }
+
+    func load<T>(_ kind: Kind, key: [UInt8], from url: URL, _ read: (inout BinaryReader) throws -> T) throws -> T {
+        let span = Trace.begin("Load Baked", category: "load", detail: url.lastPathComponent)
+        defer { span.end() }
+
+        var reader = BinaryReader(baked: try MappedFile(contentsOf: url))
+        guard try reader.read(UInt32.self) == AssetBakeCache.marker else { throw BakeError.badMarker }
+        let version = try reader.read(UInt32.self)
+        guard version == AssetBakeCache.version else { throw BakeError.unsupportedVersion(Int(version)) }
+        guard try reader.read(UInt32.self) == kind.rawValue else { throw BakeError.keyMismatch }
+        let keyCount = Int(try reader.read(UInt32.self))
+        guard keyCount == key.count, try reader.bytes(count: keyCount).elementsEqual(key) else { throw BakeError.keyMismatch }
+        try reader.align(to: 16)
+        return try read(&reader)
+    }
+
+    /// The serialized identity of `file`'s entry in its archive.
+    func key(_ kind: Kind, of file: FileSystem.File, detail: [Int]) throws -> [UInt8] {
+        let stamp = try self.stamp(for: file.archiveURL)
+        var writer = BinaryWriter()
+        writer.write(stamp.path)
+        writer.write(stamp.size)
+        writer.write(stamp.modificationTime)
+        writer.write(UInt64(file.info.offset))
+        writer.write(UInt64(file.info.size))
+        writer.write(UInt32(detail.count))
+        detail.forEach { writer.write(UInt64(truncatingIfNeeded: $0)) }
+        return Array(writer.data)
+    }
+
+    /// The stamp of each archive is only looked up once; an archive is not expected to change while it is in use.
+    func stamp(for archiveURL: URL) throws -> FileSystem.ArchiveStamp {
+        lock.lock()
+        defer { lock.unlock() }
+        if let stamp = stamps[archiveURL] { return stamp }
+        let stamp = try FileSystem.ArchiveStamp(for: archiveURL)
+        stamps[archiveURL] = stamp
+        return stamp
+    }
+
+    /// The name of a baked asset is the 64-bit FNV-1a hash of its key.
+    func url(for key: [UInt8]) -> URL {
+        var hash: UInt64 = 0xcbf29ce484222325
+        for byte in key {
+            hash = (hash ^ UInt64(byte)) &* 0x100000001b3
+        }
+        let name = String(hash, radix: 16)
+        return directory.appendingPathComponent(String(repeating: "0", count: 16 - name.count) + name + "." + AssetBakeCache.pathExtension)
+    }
+
+}
+
+// MARK:- Models
+
+private extension BinaryReader {
+
+    mutating func readModel() throws -> UnitModel {
+        let root = Int(try read(UInt32.self))
+        let groundPlate = Int(try read(UInt32.self))
+
+        let vertexCount = Int(try read(UInt32.self))
+        let coordinates = try readArray(of: UInt32.self, count: vertexCount * 3)
+        let vertices = (0..<vertexCount).map { (i) -> Vertex3f in
+            Vertex3f(Float(bitPattern: coordinates[i*3 + 0]),
+                     Float(bitPattern: coordinates[i*3 + 1]),
+                     Float(bitPattern: coordinates[i*3 + 2]))
+        }
+
+        let textures = try (0..<read(UInt32.self)).map { _ -> UnitModel.Texture in
+            switch try read(UInt32.self) {
+            case 0: return .color(Int(try read(Int32.self)))
+            case 1: return .image(try readString())
+            default: throw AssetBakeCache.BakeError.badValue
+            }
+        }
+
+        let primitives = try (0..<read(UInt32.self)).map { _ -> UnitModel.Primitive in
+            let texture = Int(try read(UInt32.self))
+            let indices = try readArray(of: UInt32.self, count: Int(try read(UInt32.self))).map { Int($0) }
+            guard texture < textures.count, indices.allSatisfy({ $0 < vertexCount }) else { throw AssetBakeCache.BakeError.badValue }
+            return UnitModel.Primitive(texture: texture, indices: indices)
+        }
+
+        let pieceCount = Int(try read(UInt32.self))
+        let pieces = try (0..<pieceCount).map { _ -> UnitModel.Piece in
+            let name = try readString()
+            let offset = Vector3f(try read(Float.self), try read(Float.self), try read(Float.self))
+            let primitiveIndices = try readArray(of: UInt32.self, count: Int(try read(UInt32.self))).map { Int($0) }
+            let children = try readArray(of: UInt32.self, count: Int(try read(UInt32.self))).map { Int($0) }
+            guard primitiveIndices.allSatisfy({ $0 < primitives.count }), children.allSatisfy({ $0 < pieceCount }) else { throw AssetBakeCache.BakeError.badValue }
+            return UnitModel.Piece(name: name, offset: offset, primitives: primitiveIndices, children: children)
+        }
+
+        guard root < pieces.count, groundPlate < max(primitives.count, 1) else { throw AssetBakeCache.BakeError.badValue }
+        return UnitModel(pieces: pieces, primitives: primitives, vertices: vertices, textures: textures, root: root, groundPlate: groundPlate)
+    }
+
+}
+
+private extension BinaryWriter {
+
+    mutating func write(_ model: UnitModel) {
+        write(UInt32(model.root))
+        write(UInt32(model.groundPlate))
+
+        write(UInt32(model.vertices.count))
+        for vertex in model.vertices {
+            write(Float(vertex.x))
+            write(Float(vertex.y))
+            write(Float(vertex.z))
+        }
+
+        write(UInt32(model.textures.count))
+        for texture in model.textures {
+            switch texture {
+            case .color(let color):
+                write(UInt32(0))
+                write(Int32(truncatingIfNeeded: color))
+            case .image(let name):
+                write(UInt32(1))
+                write(name)
+            }
+        }
+
+        write(UInt32(model.primitives.count))
+        for primitive in model.primitives {
+            write(UInt32(primitive.texture))
+            write(UInt32(primitive.indices.count))
+            primitive.indices.forEach { write(UInt32($0)) }
+        }
+
+        write(UInt32(model.pieces.count))
+        for piece in model.pieces {
+            write(piece.name)
+            write(Float(piece.offset.x))
+            write(Float(piece.offset.y))
+            write(Float(piece.offset.z))
+            write(UInt32(piece.primitives.count))
+            piece.primitives.forEach { write(UInt32($0)) }
+            write(UInt32(piece.children.count))
+            piece.children.forEach { write(UInt32($0)) }
+        }
+    }
+
+}
+
+// MARK:- Scripts
+
+private extension BinaryReader {
+
+    mutating func readScript() throws -> UnitScript {
+        let staticCount = Int(try read(UInt32.self))
+        let code = try readArray(of: Int32.self, count: Int(try read(UInt32.self)))
+
+        let modules = try (0..<read(UInt32.self)).map { _ -> UnitScript.Module in
+            var module = UnitScript.Module(name: try readString(), offset: Int(try read(UInt32.self)))
+            module.localCount = Int(try read(UInt32.self))
+            guard module.offset < code.count else { throw AssetBakeCache.BakeError.badValue }
+            return module
+        }
+
+        let pieces = try (0..<read(UInt32.self)).map { _ in try readString() }
+
+        return UnitScript(modules: modules, code: code, numberOfStaticVariables: staticCount, pieces: pieces)
+    }
+
+}
+
+private extension BinaryWriter {
+
+    mutating func write(_ script: UnitScript) {
+        write(UInt32(script.numberOfStaticVariables))
+
+        write(UInt32(script.code.count))
+        script.code.forEach { write($0) }
+
+        write(UInt32(script.modules.count))
+        for module in script.modules {
+            write(module.name)
+            write(UInt32(module.offset))
+            write(UInt32(module.localCount))
+        }
+
+        write(UInt32(script.pieces.count))
+        script.pieces.forEach { write($0) }
+    }
+
+}
+
+// MARK:- GAF Frames
+
+private extension BinaryReader {
+
+    mutating func readFrames() throws -> [GafItem.Frame] {
+        return try (0..<read(UInt32.self)).map { _ -> GafItem.Frame in
+            let size = Size2<Int>(Int(try read(Int32.self)), Int(try read(Int32.self)))
+            let offset = Point2<Int>(Int(try read(Int32.self)), Int(try read(Int32.self)))
+            guard let format = GafItem.Frame.PixelFormat(bakedValue: try read(UInt32.self)) else { throw AssetBakeCache.BakeError.badValue }
+            let count = Int(try read(UInt32.self))
+            guard size.width >= 0, size.height >= 0, count == size.area * format.pixelLength else { throw AssetBakeCache.BakeError.badValue }
+            try align(to: 16)
+            return GafItem.Frame(try data(count: count), size, offset, format)
+        }
+    }
+
+}
+
+private extension BinaryWriter {
+
+    mutating func write(_ frames: [GafItem.Frame]) {
+        write(UInt32(frames.count))
+        for frame in frames {
+            write(Int32(frame.size.width))
+            write(Int32(frame.size.height))
+            write(Int32(frame.offset.x))
+            write(Int32(frame.offset.y))
+            write(frame.format.bakedValue)
+            write(UInt32(frame.data.count))
+            align(to: 16)
+            data.append(frame.data)
+        }
+    }
+
+}
+
+private extension GafItem.Frame.PixelFormat {
+
+    init?(bakedValue: UInt32) {
+        switch bakedValue {
+        case 0: self = .paletteIndex
+        case 1: self = .raw4444
+        case 2: self = .raw1555
+        default: return nil
+        }
+    }
+
+    var bakedValue: UInt32 {
+        switch self {
+        case .paletteIndex: return 0
+        case .raw4444: return 1
+        case .raw1555: return 2
+        }
+    }
+
+}
+
+// MARK:- Reading & Writing
+
+extension BinaryReader {
+
+    /// Reads a baked asset; running off its end throws `AssetBakeCache.BakeError.truncated`.
+    init(baked file: MappedFile) {
+        self.init(file, truncated: AssetBakeCache.BakeError.truncated)
+    }
+
+}
@@ -0,0 +1,105 @@
+//
+//  BinaryReader.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/16/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/**
+ Reads the little-endian binary files that SwiftTA writes for itself (eg. the file system index & the asset bake cache)
+ straight out of their mapping.
+
+ Every read is bounds checked; running off the end of the file throws `truncated`, the error of whichever format is being read.
+ */
+struct BinaryReader {
+
+    let file: MappedFile
+    var position: Int
+    let truncated: Error
+
+    init(_ file: MappedFile, at position: Int = 0, truncated: Error) {
+        self.file = file
+        self.position = position
+        self.truncated = truncated
+    }
+
+    mutating func read<T: FixedWidthInteger>(_ type: T.Type) throws -> T {
+        let size = MemoryLayout<T>.size
+        guard position >= 0, file.count - position >= size else { throw truncated }
+        var value: T = 0
+        withUnsafeMutableBytes(of: &value) { $0.copyMemory(from: UnsafeRawBufferPointer(rebasing: file.buffer[position ..< position + size])) }
+        position += size
+        return T(littleEndian: value)
+    }
+
+    mutating func read(_ type: Float.Type) throws -> Float {
+        return Float(bitPattern: try read(UInt32.self))
+    }
+
+    /// Reads `count` consecutive values with a single copy.
+    mutating func readArray<T: FixedWidthInteger>(of type: T.Type, count: Int) throws -> [T] {
+        let size = MemoryLayout<T>.size * count
+        guard count >= 0, position >= 0, file.count - position >= size else { throw truncated }
+        var values = [T](repeating: 0, count: count)
+        values.withUnsafeMutableBytes { $0.copyMemory(from: UnsafeRawBufferPointer(rebasing: file.buffer[position ..< position + size])) }
+        for i in values.indices { values[i] = T(littleEndian: values[i]) }
+        position += size
+        return values
+    }
+
+    /// A UTF-8 string, prefixed by its 32-bit length.
+    mutating func readString() throws -> String {
+        return String(decoding: try bytes(count: Int(try read(UInt32.self))), as: UTF8.self)
+    }
+
+    mutating func bytes(count: Int) throws -> UnsafeRawBufferPointer {
+        guard count >= 0, position >= 0, file.count - position >= count else { throw truncated }
+        defer { position += count }
+        return UnsafeRawBufferPointer(rebasing: file.buffer[position ..< position + count])
+    }
+
+    /// The next `count` bytes, without copying them out of the mapping; the result is read-only and must not be mutated.
+    mutating func data(count: Int) throws -> Data {
+        guard count >= 0, position >= 0, file.count - position >= count else { throw truncated }
+        defer { position += count }
+        return try file.data(in: position ..< position + count)
+    }
+
+    mutating func align(to alignment: Int) throws {
+        let aligned = (position + alignment - 1) / alignment * alignment
+        guard aligned <= file.count else { throw truncated }
+        position = aligned
+    }
+
+}
+
+/// Writes what a `BinaryReader` reads.
+struct BinaryWriter {
+
+    var data = Data()
+
+    mutating func write<T: FixedWidthInteger>(_ value: T) {
+        var le = value.littleEndian
+        withUnsafeBytes(of: &le) { data.append(contentsOf: $0) }
+    }
+
+    mutating func write(_ value: Float) {
+        write(value.bitPattern)
+    }
+
+    /// A UTF-8 string, prefixed by its 32-bit length.
+    mutating func write(_ string: String) {
+        let utf8 = Array(string.utf8)
+        write(UInt32(utf8.count))
+        data.append(contentsOf: utf8)
+    }
+
+    mutating func align(to alignment: Int) {
+        let padding = (alignment - data.count % alignment) % alignment
+        data.append(contentsOf: repeatElement(0, count: padding))
+    }
+
+}
@@ -0,0 +1,330 @@
+//
+//  Filesystem+Arena.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+extension FileSystem {
+
+    /**
+     The storage behind a tree of `Directory` & `File` items.
+
+     Every item in the tree is a `Node` in a single flat table. A directory's children are stored
+     contiguously in that table, sorted by name, so a directory is just a range of nodes.
+     Names are interned: each distinct name (and each distinct case-folded name) is stored once
+     and referred to by a 32-bit id. Names are case-folded ASCII-only, just as paths are compared by the `PathIndex`.
+
+     An `Arena` is immutable once built, and so can be freely shared between threads.
+     `Directory` and `Item` are lightweight views into an arena.
+     */
+    final class Arena {
+
+        typealias NodeID = UInt32
+        typealias NameID = UInt32
+
+        struct Node {
+            /// The item's name, as it appears in its archive. An index into `names`.
+            var name: NameID
+            /// The item's case-folded name. An index into `keys`. Siblings are sorted by this.
+            var key: NameID
+            /// For a directory, the id of its first child; for a file, the index of its record in `files`.
+            var first: UInt32
+            /// For a directory, the number of children; `Node.file` for a file.
+            var count: UInt32
+
+            static let file = UInt32.max
+            var isDirectory: Bool { return count != Node.file }
+            var children: Range<Int> { return Int(first) ..< Int(first) + Int(count) }
+        }
+
+        struct FileRecord {
+            var offset: Int
+            var size: Int
+            var compressedSize: Int
+            var compression: HpiFormat.FileEntryCompression
+            /// An index into `archiveURLs`.
+            var archive: UInt32
+        }
+
+        /// The root directory is always the first node.
+        static let root: NodeID = 0
+
+        let nodes: [Node]
+        let files: [FileRecord]
+        let names: [String]
+        let keys: [String]
+        let archiveURLs: [URL]
+        private let keyIndex: KeyIndex
+        /// The index of every full path in the tree; skipped for intermediate trees that are only built to be merged.
+        let paths: PathIndex?
+
+        init(nodes: [Node], files: [FileRecord], names: [String], keys: [String], archiveURLs: [URL], indexingPaths: Bool = true) {
+            self.nodes = nodes
+            self.files = files
+            self.names = names
+            self.keys = keys
+            self.archiveURLs = archiveURLs
+            keyIndex = KeyIndex(keys: keys)
+            paths = indexingPaths ? PathIndex(nodes: nodes, names: names) : nil
+        }
+
+        /// An arena with nothing but an empty root directory.
+        static let empty = Arena(nodes: [Node(name: 0, key: 0, first: 0, count: 0)], files: [], names: [""], keys: [""], archiveURLs: [])
+
+        func name(of id: NodeID) -> String {
+            return names[Int(nodes[Int(id)].name)]
+        }
+
+        func key(of id: NodeID) -> String {
+            return keys[Int(nodes[Int(id)].key)]
+        }
+
+        func item(_ id: NodeID) -> Item {
+            let node = nodes[Int(id)]
+            if node.isDirectory {
+                return .directory(Directory(arena: self, id: id))
+            }
+            else {
+                let record = files[Int(node.first)]
+                let info = HpiItem.File(name: names[Int(node.name)],
+                                        size: record.size,
+                                        offset: record.offset,
+                                        compression: record.compression,
+                                        compressedSize: record.compressedSize)
+                return .file(File(info: info, archiveURL: archiveURLs[Int(record.archive)]))
+            }
+        }
+
+        /// The child of directory `id` with the given (case-insensitive) name, if any.
+        func child(of id: NodeID, named name: String) -> NodeID? {
+            guard let key = keyIndex.id(of: name, in: keys) else { return nil }
+            return child(of: id, withKey: key)
+        }
+
+        func child(of id: NodeID, withKey key: NameID) -> NodeID? {
+            let node = nodes[Int(id)]
+            guard node.isDirectory else { return nil }
+
+            var range = node.children
+            while !range.isEmpty {
+                let mid = range.lowerBound + range.count / 2
+                let midKey = nodes[mid].key
+                if midKey == key { return NodeID(mid) }
+                else if midKey < key { range = (mid + 1) ..< range.upperBound }
+                else { range = range.lowerBound ..< mid }
+            }
+            return nil
+        }
+
+    }
+
+}
+
+// MARK:- Building
+
+extension FileSystem.Arena {
+
+    /// Builds the tree of a single archive.
+    convenience init(from directory: HpiItem.Directory, in archiveURL: URL, indexingPaths: Bool = true) {
+        var builder = Builder()
+        let archive = builder.archive(archiveURL)
+        builder.addRoot(named: directory.name)
+        builder.fill(FileSystem.Arena.root, with: directory.items, archive: archive)
+        self.init(builder, indexingPaths: indexingPaths)
+    }
+
+    /**
+     Builds the union of several trees, given in order of precedence.
+
+     For every name, the first tree to contain it determines what the merged item is.
+     A file hides any later item of the same name; a directory merges in every later directory of the same name
+     (and hides any later file).
+     */
+    convenience init(merging directories: [FileSystem.Directory]) {
+        var builder = Builder()
+        builder.addRoot(named: directories.first?.name ?? "")
+        builder.fill(FileSystem.Arena.root, merging: directories)
+        self.init(builder, indexingPaths: true)
+    }
+
+    private convenience init(_ builder: Builder, indexingPaths: Bool) {
+        self.init(nodes: builder.nodes,
+                  files: builder.files,
+                  names: builder.names.strings,
+                  keys: builder.keys.strings,
+                  archiveURLs: builder.archiveURLs,
+                  indexingPaths: indexingPaths)
+    }
+
+    private struct Builder {
+
+        var nodes: [Node] = []
+        var files: [FileRecord] = []
+        var names = InternTable()
+        var keys = InternTable()
+        var archiveURLs: [URL] = []
+        private var archiveIndices: [URL: UInt32] = [:]
+
+        mutating func archive(_ url: URL) -> UInt32 {
+            if let index = archiveIndices[url] { return index }
+            let index = UInt32(archiveURLs.count)
+            archiveURLs.append(url)
+            archiveIndices[url] = index
+            return index
+        }
+
+        mutating func addRoot(named name: String) {
+            nodes.append(Node(name: names.intern(name), key: keys.intern(FileSystem.Arena.key(for: name)), first: 0, count: 0))
+        }
+
+        /// Reserves a contiguous block of nodes for the children of `directory`.
+        private mutating func reserveChildren(of directory: NodeID, count: Int) -> Int {
+            let first = nodes.count
+            nodes.append(contentsOf: repeatElement(Node(name: 0, key: 0, first: 0, count: 0), count: count))
+            nodes[Int(directory)].first = UInt32(first)
+            nodes[Int(directory)].count = UInt32(count)
+            return first
+        }
+
+        mutating func fill(_ directory: NodeID, with items: [HpiItem], archive: UInt32) {
+
+            // Within a single archive, a later item replaces an earlier one of the same name.
+            var unique: [NameID: HpiItem] = [:]
+            for item in items {
+                unique[keys.intern(FileSystem.Arena.key(for: item.name))] = item
+            }
+            let sorted = unique.sorted { $0.key < $1.key }
+
+            let first = reserveChildren(of: directory, count: sorted.count)
+            for (i, (key, item)) in sorted.enumerated() {
+                switch item {
+                case .file(let file):
+                    nodes[first + i] = Node(name: names.intern(file.name), key: key, first: UInt32(files.count), count: Node.file)
+                    files.append(FileRecord(offset: file.offset,
+                                            size: file.size,
+                                            compressedSize: file.compressedSize,
+                                            compression: file.compression,
+                                            archive: archive))
+                case .directory(let subdirectory):
+                    nodes[first + i] = Node(name: names.intern(subdirectory.name), key: key, first: 0, count: 0)
+                }
+            }
+
+            for (i, (_, item)) in sorted.enumerated() {
+                if case .directory(let subdirectory) = item {
+                    fill(NodeID(first + i), with: subdirectory.items, archive: archive)
+                }
+            }
+        }
+
+        mutating func fill(_ directory: NodeID, merging sources: [FileSystem.Directory]) {
+
+            // Group every child of every source by case-folded name, keeping the sources' order of precedence.
+            var groups: [NameID: [(arena: FileSystem.Arena, id: NodeID)]] = [:]
+            for source in sources {
+                for child in source.arena.nodes[Int(source.id)].children {
+                    let id = NodeID(child)
+                    groups[keys.intern(source.arena.key(of: id)), default: []].append((source.arena, id))
+                }
+            }
+            let sorted = groups.sorted { $0.key < $1.key }
+
+            let first = reserveChildren(of: directory, count: sorted.count)
+            var subdirectories: [(NodeID, [FileSystem.Directory])] = []
+            for (i, (key, group)) in sorted.enumerated() {
+                let winner = group[0]
+                let node = winner.arena.nodes[Int(winner.id)]
+                let name = names.intern(winner.arena.names[Int(node.name)])
+
+                if node.isDirectory {
+                    nodes[first + i] = Node(name: name, key: key, first: 0, count: 0)
+                    let merged = group
+                        .filter { $0.arena.nodes[Int($0.id)].isDirectory }
+                        .map { FileSystem.Directory(arena: $0.arena, id: $0.id) }
+                    subdirectories.append((NodeID(first + i), merged))
+                }
+                else {
+                    var record = winner.arena.files[Int(node.first)]
+                    record.archive = archive(winner.arena.archiveURLs[Int(record.archive)])
+                    nodes[first + i] = Node(name: name, key: key, first: UInt32(files.count), count: Node.file)
+                    files.append(record)
+                }
+            }
+
+            for (id, merged) in subdirectories {
+                fill(id, merging: merged)
+            }
+        }
+
+    }
+
+    /// The case-folded `name`; its ASCII letters lowercased, and everything else left as is.
+    static func key(for name: String) -> String {
+        return String(decoding: name.utf8.map(PathHash.fold), as: UTF8.self)
+    }
+
+    /// A set of unique strings, each with a stable id.
+    struct InternTable {
+        private(set) var strings: [String] = []
+        private var ids: [String: NameID] = [:]
+
+        mutating func intern(_ string: String) -> NameID {
+            if let id = ids[string] { return id }
+            let id = NameID(strings.count)
+            strings.append(string)
+            ids[string] = id
+            return id
+        }
+    }
+
+    /**
+     Finds the id of a case-folded key from a name in any case, without folding (or allocating) a new string.
+
+     An open-addressed (linear probing) table of key ids, by the `PathHash` of each key;
+     a name is hashed the same way, and then compared ASCII case-insensitively against the keys it hashes alongside.
+     */
+    struct KeyIndex {
+
+        private let hashes: [UInt64]
+        /// Key ids, offset by one so that zero marks an empty slot.
+        private let table: [UInt32]
+        private let mask: Int
+
+        init(keys: [String]) {
+            let hashes = keys.map { PathHash.hash($0.utf8, from: PathHash.basis) }
+
+            var capacity = 16
+            while capacity < keys.count * 2 { capacity <<= 1 }
+            var table = [UInt32](repeating: 0, count: capacity)
+            let mask = capacity - 1
+            for id in keys.indices {
+                var slot = Int(truncatingIfNeeded: hashes[id]) & mask
+                while table[slot] != 0 { slot = (slot + 1) & mask }
+                table[slot] = UInt32(id + 1)
+            }
+
+            self.hashes = hashes
+            self.table = table
+            self.mask = mask
+        }
+
+        func id(of name: String, in keys: [String]) -> NameID? {
+            let hash = PathHash.hash(name.utf8, from: PathHash.basis)
+            var slot = Int(truncatingIfNeeded: hash) & mask
+            while table[slot] != 0 {
+                let candidate = Int(table[slot] - 1)
+                if hashes[candidate] == hash, keys[candidate].utf8.elementsEqual(name.utf8, by: { $0 == PathHash.fold($1) }) {
+                    return NameID(candidate)
+                }
+                slot = (slot + 1) & mask
+            }
+            return nil
+        }
+
+    }
+
+}
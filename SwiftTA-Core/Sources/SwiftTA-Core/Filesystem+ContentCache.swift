@@ -0,0 +1,135 @@
+//
+//  Filesystem+ContentCache.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+public extension FileSystem {
+
+    /**
+     A thread-safe cache of extracted file contents, bounded by a byte budget.
+
+     When the budget is exceeded, the least recently used files are evicted first.
+     Cached contents are shared as-is with every `FileHandle` that reads them; nothing is copied.
+     */
+    final class ContentCache {
+
+        /// The maximum total size, in bytes, of all cached file contents.
+        public let byteBudget: Int
+
+        public struct Statistics {
+            public var hits = 0
+            public var misses = 0
+            public var evictions = 0
+            /// The number of files currently cached.
+            public var count = 0
+            /// The total size, in bytes, of the files currently cached.
+            public var byteCount = 0
+        }
+
+        /// A file is identified by its archive and its location in that archive.
+        struct Key: Hashable {
+            var archiveURL: URL
+            var offset: Int
+        }
+
+        private let lock = NSLock()
+        private var nodes: [Key: Node] = [:]
+        private var stats = Statistics()
+
+        /// The ends of the recently-used list; every node is owned by `nodes`.
+        private weak var newest: Node?
+        private weak var oldest: Node?
+
+        public init(byteBudget: Int) {
+            self.byteBudget = byteBudget
+        }
+
+        public var statistics: Statistics {
+            lock.lock()
+            defer { lock.unlock() }
+            return stats
+        }
+
+        public func removeAll() {
+            lock.lock()
+            defer { lock.unlock() }
+            nodes.removeAll()
+            newest = nil
+            oldest = nil
+            stats.count = 0
+            stats.byteCount = 0
+        }
+
+        func data(for key: Key) -> Data? {
+            lock.lock()
+            defer { lock.unlock() }
+
+            guard let node = nodes[key] else {
+                stats.misses += 1
+                return nil
+            }
+
+            stats.hits += 1
+            unlink(node)
+            pushNewest(node)
+            return node.data
+        }
+
+        func insert(_ data: Data, for key: Key) {
+            guard data.count <= byteBudget else { return }
+
+            lock.lock()
+            defer { lock.unlock() }
+
+            guard nodes[key] == nil else { return }
+
+            let node = Node(key: key, data: data)
+            nodes[key] = node
+            pushNewest(node)
+            stats.count += 1
+            stats.byteCount += data.count
+
+            while stats.byteCount > byteBudget, let victim = oldest {
+                unlink(victim)
+                nodes[victim.key] = nil
+                stats.count -= 1
+                stats.byteCount -= victim.data.count
+                stats.evictions += 1
+            }
+        }
+
+        private final class Node {
+            let key: Key
+            let data: Data
+            weak var newer: Node?
+            weak var older: Node?
+            init(key: Key, data: Data) {
+                self.key = key
+                self.data = data
+            }
+        }
+
+        private func unlink(_ node: Node) {
+            if let newer = node.newer { newer.older = node.older }
+            else { newest = node.older }
+            if let older = node.older { older.newer = node.newer }
+            else { oldest = node.newer }
+            node.newer = nil
+            node.older = nil
+        }
+
+        private func pushNewest(_ node: Node) {
+            node.older = newest
+            newest?.newer = node
+            newest = node
+            if oldest == nil { oldest = node }
+        }
+
+    }
+
+}
@@ -0,0 +1,240 @@
+//
+//  Filesystem+FeatureIndex.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/*
+ The feature index records where every map feature is defined: the TDF file under "features/<directory>"
+ and the byte offset of the feature's object in it. Loading a feature is then a matter of parsing that one object,
+ rather than searching through every feature TDF for it.
+
+ Building the index requires scanning (though not parsing) every feature TDF. A `FileSystem` mounted with an index file
+ caches its feature index next to it; the cached feature index is only used if it was built from exactly the same archives.
+
+ Layout (all integers are little-endian):
+
+     UInt32  magic ('STAF')
+     UInt32  version
+     UInt32  archive count, [archive count] { String path, UInt64 size, Int64 modification time }  (sorted by path)
+     UInt32  file count, [file count] { String path, String directory }
+     UInt32  entry count, [entry count] { String feature name, UInt32 file, UInt64 offset }
+
+ where String := UInt32 byte count, UTF-8 bytes
+ */
+
+public extension FileSystem {
+
+    /**
+     Where every feature is defined in this `FileSystem`.
+     The index is built (or loaded from its on-disk cache) the first time it is asked for.
+     */
+    var featureIndex: FeatureIndex {
+        featureIndexLock.lock()
+        defer { featureIndexLock.unlock() }
+
+        if let index = builtFeatureIndex { return index }
+
+        let stamps = (try? archives.keys.map { try ArchiveStamp(for: $0) }.sorted { $0.path < $1.path }) ?? []
+        if let url = featureIndexURL, !stamps.isEmpty, let cached = try? FeatureIndex(contentsOf: url, archives: stamps, in: root) {
+            builtFeatureIndex = cached
+            return cached
+        }
+
+        let index = FeatureIndex(scanning: self)
+        if let url = featureIndexURL, !stamps.isEmpty {
+            do { try index.write(archives: stamps, to: url) }
+            catch { print("Failed to write feature index \(url.path): \(error)") }
+        }
+        builtFeatureIndex = index
+        return index
+    }
+
+    /**
+     A map from each feature name to every place it is defined.
+     Every subdirectory of "features" is indexed, as is every object in each of their TDF files.
+     */
+    final class FeatureIndex {
+
+        /// A TDF file defining features and the directory (in "features") that it is in.
+        struct Source {
+            var path: String
+            var file: FileSystem.File
+            var directory: String
+        }
+
+        /// The definition of a feature: the `offset` of its object (its `[`) in a TDF file.
+        public struct Entry {
+            let source: Int
+            public let offset: Int
+        }
+
+        let sources: [Source]
+        let entries: [FeatureTypeId: [Entry]]
+
+        init(sources: [Source], entries: [FeatureTypeId: [Entry]]) {
+            self.sources = sources
+            self.entries = entries
+        }
+
+        /// The number of distinct features defined.
+        public var count: Int { return entries.count }
+
+        /// Every definition of `feature`; in the order the directories (and the files in each) are listed.
+        public func entries(for feature: FeatureTypeId) -> [Entry] {
+            return entries[feature] ?? []
+        }
+
+        public func file(of entry: Entry) -> FileSystem.File {
+            return sources[entry.source].file
+        }
+
+        /// The name of the directory, in "features", that holds the entry's file.
+        public func directory(of entry: Entry) -> String {
+            return sources[entry.source].directory
+        }
+
+        /**
+         The definition of `feature` to use for a map of the given planet.
+         That is: one in the planet's own directory, or else in "corpses", or else in "All Worlds";
+         failing those, the first found.
+         */
+        public func preferredEntry(for feature: FeatureTypeId, planetDirectory: String?) -> Entry? {
+            let all = entries(for: feature)
+            guard all.count > 1 else { return all.first }
+            for preferred in [planetDirectory, "corpses", "All Worlds"] {
+                guard let preferred = preferred else { continue }
+                if let entry = all.first(where: { directory(of: $0).caseInsensitiveCompare(preferred) == .orderedSame }) {
+                    return entry
+                }
+            }
+            return all.first
+        }
+
+    }
+
+}
+
+// MARK:- Building
+
+private extension FileSystem.FeatureIndex {
+
+    convenience init(scanning filesystem: FileSystem) {
+        let span = Trace.begin("Build Feature Index", category: "load")
+        defer { span.end() }
+
+        let directories = filesystem.root[directory: "features"]?.items.compactMap { $0.asDirectory() } ?? []
+        let sources = directories.flatMap { (directory) -> [Source] in
+            directory.files(withExtension: "tdf")
+                .sorted { FileSystem.sortNames($0.name, $1.name) }
+                .map { Source(path: "features/\(directory.name)/\($0.name)", file: $0, directory: directory.name) }
+        }
+
+        // Each file is scanned for its top-level objects concurrently; only their names are turned into Strings.
+        // An unreadable file simply defines nothing.
+        let objects = (try? sources.concurrentMap { (source) -> [(name: String, offset: Int)] in
+            guard let data = try? filesystem.openFile(source.file).readDataToEndOfFile() else { return [] }
+            return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+                var found: [(name: String, offset: Int)] = []
+                var tokenizer = TdfTokenizer(bytes)
+                while let token = tokenizer.next() {
+                    guard case let .objectBegin(name) = token, tokenizer.depth == 1 else { continue }
+                    found.append((tokenizer.string(name).lowercased(), name.lowerBound - 1))
+                }
+                return found
+            }
+        }) ?? []
+
+        var entries: [FeatureTypeId: [Entry]] = [:]
+        for (source, objects) in objects.enumerated() {
+            for (name, offset) in objects {
+                entries[FeatureTypeId(named: name), default: []].append(Entry(source: source, offset: offset))
+            }
+        }
+
+        self.init(sources: sources, entries: entries)
+    }
+
+}
+
+// MARK:- Reading & Writing
+
+private extension FileSystem.FeatureIndex {
+
+    static let marker: UInt32 = 0x46415453 // 'STAF'
+    static let version: UInt32 = 1
+
+    convenience init(contentsOf url: URL, archives: [FileSystem.ArchiveStamp], in root: FileSystem.Directory) throws {
+        let file = try MappedFile(contentsOf: url)
+        var reader = BinaryReader(index: file)
+
+        guard try reader.read(UInt32.self) == FileSystem.FeatureIndex.marker else { throw FileSystem.IndexError.badMarker }
+        let version = try reader.read(UInt32.self)
+        guard version == FileSystem.FeatureIndex.version else { throw FileSystem.IndexError.unsupportedVersion(Int(version)) }
+
+        let stamps = try (0..<reader.read(UInt32.self)).map { _ in
+            FileSystem.ArchiveStamp(path: try reader.readString(), size: try reader.read(UInt64.self), modificationTime: try reader.read(Int64.self))
+        }
+        guard stamps == archives else { throw FeatureIndexError.outdated }
+
+        let sources = try (0..<reader.read(UInt32.self)).map { _ -> Source in
+            let path = try reader.readString()
+            let directory = try reader.readString()
+            guard let file = root.file(atPath: path[...]) else { throw FeatureIndexError.outdated }
+            return Source(path: path, file: file, directory: directory)
+        }
+
+        var entries: [FeatureTypeId: [Entry]] = [:]
+        let entryCount = try reader.read(UInt32.self)
+        for _ in 0..<entryCount {
+            let name = try reader.readString()
+            let source = Int(try reader.read(UInt32.self))
+            let offset = Int(try reader.read(UInt64.self))
+            guard source < sources.count else { throw FileSystem.IndexError.badArchiveIndex(source) }
+            entries[FeatureTypeId(named: name), default: []].append(Entry(source: source, offset: offset))
+        }
+
+        self.init(sources: sources, entries: entries)
+    }
+
+    func write(archives: [FileSystem.ArchiveStamp], to url: URL) throws {
+        var writer = BinaryWriter()
+        writer.write(FileSystem.FeatureIndex.marker)
+        writer.write(FileSystem.FeatureIndex.version)
+
+        writer.write(UInt32(archives.count))
+        for stamp in archives {
+            writer.write(stamp.path)
+            writer.write(stamp.size)
+            writer.write(stamp.modificationTime)
+        }
+
+        writer.write(UInt32(sources.count))
+        for source in sources {
+            writer.write(source.path)
+            writer.write(source.directory)
+        }
+
+        // Entries are written in source order, so that each feature's entries are read back in the same order.
+        let all = entries
+            .flatMap { (id, entries) in entries.map { (id.name, $0) } }
+            .sorted { ($0.1.source, $0.1.offset) < ($1.1.source, $1.1.offset) }
+        writer.write(UInt32(all.count))
+        for (name, entry) in all {
+            writer.write(name)
+            writer.write(UInt32(entry.source))
+            writer.write(UInt64(entry.offset))
+        }
+
+        try writer.data.write(to: url, options: .atomic)
+    }
+
+    enum FeatureIndexError: Error {
+        case outdated
+    }
+
+}
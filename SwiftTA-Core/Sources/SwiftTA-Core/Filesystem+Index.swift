@@ -0,0 +1,315 @@
+//
+//  Filesystem+Index.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/*
+ A FileSystem index is a binary file that caches the parsed directories of a set of archives,
+ so that mounting them again does not require parsing every archive's directory.
+
+ Each archive is identified by its path, size and modification time. The index holds the directory
+ tree of every archive on its own (so that a single changed archive can be rebuilt on its own) as well
+ as the final merged tree (so that, when nothing has changed, no merging is needed either).
+
+ Layout (all integers are little-endian):
+
+     UInt32  magic ('STAI')
+     UInt32  version
+     UInt32  archive count
+     [archive count] {
+         String  path
+         UInt64  size
+         Int64   modification time (nanoseconds since 1970)
+         UInt64  offset of the archive's directory tree
+     }
+     UInt64  offset of the merged directory tree
+     ...     directory trees
+
+ A directory tree is a serialized `Arena`:
+
+     UInt32  id of the tree's root node
+     UInt32  archive count, [archive count] UInt32 index into the list of archives above
+     UInt32  name count, [name count] String
+     UInt32  case-folded name count, [count] String
+     UInt32  node count, [node count] { UInt32 name, UInt32 folded name, UInt32 first, UInt32 count }
+     UInt32  file count, [file count] { UInt64 offset, UInt64 size, UInt64 compressed size, UInt8 compression, UInt32 archive }
+
+ where String := UInt32 byte count, UTF-8 bytes
+ */
+
+extension FileSystem {
+
+    /**
+     Merge the directories of `archives` (given in order of precedence) with the help of the index file at `indexURL`.
+
+     If every archive matches the index exactly, the merged tree is read directly from the index.
+     Otherwise, the directory of each archive that is unchanged is read from the index; only new or changed
+     archives are parsed. The index is then rewritten to match the current set of archives.
+     A missing, outdated or corrupt index is simply rebuilt.
+     */
+    static func loadMergedDirectory(of archives: [HpiArchive], usingIndexAt indexURL: URL) throws -> Directory {
+
+        let urls = archives.map { $0.url }
+        let stamps = try archives.map { try ArchiveStamp(for: $0.url) }
+        let index = try? Index(contentsOf: indexURL)
+
+        if let index = index, index.archives == stamps, let merged = try? index.mergedDirectory(archiveURLs: urls) {
+            return merged
+        }
+
+        // Only the archives missing from the index need parsing; those are parsed concurrently.
+        var cached = archives.indices.map { (i) -> Directory? in
+            guard let directory = try? index?.directory(for: stamps[i], archiveURL: archives[i].url) else { return nil }
+            return directory
+        }
+        let missing = cached.indices.filter { cached[$0] == nil }
+        let parsed = try loadDirectories(of: missing.map { archives[$0] })
+        zip(missing, parsed).forEach { cached[$0] = $1 }
+        
+        let directories = cached.map { $0! }
+        let merged = merge(directories)
+
+        do { try Index.write(archives: stamps, directories: directories, merged: merged, to: indexURL) }
+        catch { print("Failed to write filesystem index \(indexURL.path): \(error)") }
+
+        return merged
+    }
+
+    /**
+     The usual place to keep the index of the archives in `searchDirectory`: a file of its own, named for
+     the directory, in the user's caches directory. Returns nil if there is no caches directory to use.
+     */
+    public static func cachedIndexURL(for searchDirectory: URL) -> URL? {
+        guard let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else { return nil }
+        let directory = caches.appendingPathComponent("SwiftTA", isDirectory: true)
+        guard (try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)) != nil else { return nil }
+
+        // FNV-1a; stable from run to run, unlike `hashValue`.
+        let hash = searchDirectory.standardizedFileURL.path.utf8.reduce(UInt64(0xcbf29ce484222325)) { ($0 ^ UInt64($1)) &* 0x100000001b3 }
+        return directory.appendingPathComponent("\(searchDirectory.lastPathComponent)-\(String(hash, radix: 16)).index")
+    }
+
+    /// Identifies a specific version of an archive file.
+    struct ArchiveStamp: Equatable {
+        var path: String
+        var size: UInt64
+        var modificationTime: Int64
+
+        init(for url: URL) throws {
+            let attributes = try FileManager.default.attributesOfItem(atPath: url.path)
+            let date = attributes[.modificationDate] as? Date ?? Date(timeIntervalSince1970: 0)
+            path = url.standardizedFileURL.path
+            size = (attributes[.size] as? NSNumber)?.uint64Value ?? 0
+            modificationTime = Int64(date.timeIntervalSince1970 * 1_000_000_000)
+        }
+
+        init(path: String, size: UInt64, modificationTime: Int64) {
+            self.path = path
+            self.size = size
+            self.modificationTime = modificationTime
+        }
+    }
+
+    enum IndexError: Error {
+        case badMarker
+        case unsupportedVersion(Int)
+        case truncated
+        case badArchiveIndex(Int)
+        case badNode(Int)
+    }
+
+}
+
+// MARK:- Index
+
+private extension FileSystem {
+
+    struct Index {
+
+        static let marker: UInt32 = 0x49415453 // 'STAI'
+        static let version: UInt32 = 3
+
+        let file: MappedFile
+        let archives: [ArchiveStamp]
+        let treeOffsets: [Int]
+        let mergedTreeOffset: Int
+
+        init(contentsOf url: URL) throws {
+            file = try MappedFile(contentsOf: url)
+            var reader = BinaryReader(index: file)
+
+            guard try reader.read(UInt32.self) == Index.marker else { throw IndexError.badMarker }
+            let version = try reader.read(UInt32.self)
+            guard version == Index.version else { throw IndexError.unsupportedVersion(Int(version)) }
+
+            let count = Int(try reader.read(UInt32.self))
+            var archives: [ArchiveStamp] = []
+            var treeOffsets: [Int] = []
+            for _ in 0..<count {
+                let path = try reader.readString()
+                let size = try reader.read(UInt64.self)
+                let time = try reader.read(Int64.self)
+                archives.append(ArchiveStamp(path: path, size: size, modificationTime: time))
+                treeOffsets.append(Int(try reader.read(UInt64.self)))
+            }
+
+            self.archives = archives
+            self.treeOffsets = treeOffsets
+            mergedTreeOffset = Int(try reader.read(UInt64.self))
+        }
+
+        /// The merged tree; only valid if `archives` matches the archives being mounted.
+        func mergedDirectory(archiveURLs: [URL]) throws -> Directory {
+            var reader = BinaryReader(index: file, at: mergedTreeOffset)
+            return try reader.readTree(archiveURLs: archiveURLs, indexingPaths: true)
+        }
+
+        /// The tree of a single archive, if the index contains this version of it.
+        func directory(for stamp: ArchiveStamp, archiveURL: URL) throws -> Directory? {
+            guard let i = archives.firstIndex(of: stamp) else { return nil }
+            var reader = BinaryReader(index: file, at: treeOffsets[i])
+            var urls = [URL](repeating: archiveURL, count: archives.count)
+            urls[i] = archiveURL
+            return try reader.readTree(archiveURLs: urls, indexingPaths: false)
+        }
+
+        static func write(archives: [ArchiveStamp], directories: [Directory], merged: Directory, to url: URL) throws {
+
+            let archiveIndices = Dictionary(archives.indices.map { (archives[$0].path, $0) }, uniquingKeysWith: { a, _ in a })
+            let archiveIndex: (URL) -> Int = { archiveIndices[$0.standardizedFileURL.path] ?? 0 }
+
+            let trees = directories.map { (directory) -> Data in
+                var writer = BinaryWriter()
+                writer.write(directory, archiveIndex: archiveIndex)
+                return writer.data
+            }
+            var mergedWriter = BinaryWriter()
+            mergedWriter.write(merged, archiveIndex: archiveIndex)
+
+            var header = BinaryWriter()
+            header.write(Index.marker)
+            header.write(Index.version)
+            header.write(UInt32(archives.count))
+
+            let headerSize = 12 + archives.reduce(0) { $0 + 4 + $1.path.utf8.count + 8 + 8 + 8 } + 8
+            var treeOffset = headerSize
+            for (stamp, tree) in zip(archives, trees) {
+                header.write(stamp.path)
+                header.write(stamp.size)
+                header.write(stamp.modificationTime)
+                header.write(UInt64(treeOffset))
+                treeOffset += tree.count
+            }
+            header.write(UInt64(treeOffset))
+
+            var data = header.data
+            trees.forEach { data.append($0) }
+            data.append(mergedWriter.data)
+            try data.write(to: url, options: .atomic)
+        }
+
+    }
+
+}
+
+// MARK:- Reading & Writing
+
+extension BinaryReader {
+
+    /// Reads an index file; running off its end throws `FileSystem.IndexError.truncated`.
+    init(index file: MappedFile, at position: Int = 0) {
+        self.init(file, at: position, truncated: FileSystem.IndexError.truncated)
+    }
+
+    mutating func readTree(archiveURLs: [URL], indexingPaths: Bool) throws -> FileSystem.Directory {
+        typealias Arena = FileSystem.Arena
+
+        let root = try read(UInt32.self)
+
+        let archives = try (0..<read(UInt32.self)).map { _ -> URL in
+            let index = Int(try read(UInt32.self))
+            guard index < archiveURLs.count else { throw FileSystem.IndexError.badArchiveIndex(index) }
+            return archiveURLs[index]
+        }
+        let names = try (0..<read(UInt32.self)).map { _ in try readString() }
+        let keys = try (0..<read(UInt32.self)).map { _ in try readString() }
+
+        let nodeCount = Int(try read(UInt32.self))
+        let nodes = try (0..<nodeCount).map { (i) -> Arena.Node in
+            let node = Arena.Node(name: try read(UInt32.self), key: try read(UInt32.self), first: try read(UInt32.self), count: try read(UInt32.self))
+            guard node.name < names.count, node.key < keys.count else { throw FileSystem.IndexError.badNode(i) }
+            return node
+        }
+
+        let files = try (0..<read(UInt32.self)).map { _ -> Arena.FileRecord in
+            let offset = Int(try read(UInt64.self))
+            let size = Int(try read(UInt64.self))
+            let compressedSize = Int(try read(UInt64.self))
+            let compression = HpiFormat.FileEntryCompression(rawValue: try read(UInt8.self)) ?? .none
+            let archive = try read(UInt32.self)
+            guard archive < archives.count else { throw FileSystem.IndexError.badArchiveIndex(Int(archive)) }
+            return Arena.FileRecord(offset: offset, size: size, compressedSize: compressedSize, compression: compression, archive: archive)
+        }
+
+        // Every node is the child of at most one directory, and comes after it; so a corrupt index
+        // can never make walking the tree (eg. to build its path index) go around in circles.
+        var claimed = [Bool](repeating: false, count: nodes.count)
+        for (i, node) in nodes.enumerated() {
+            if node.isDirectory {
+                guard node.count == 0 || (Int(node.first) > i && node.children.upperBound <= nodes.count)
+                    else { throw FileSystem.IndexError.badNode(i) }
+                for child in node.children {
+                    guard !claimed[child] else { throw FileSystem.IndexError.badNode(child) }
+                    claimed[child] = true
+                }
+            }
+            else {
+                guard node.first < files.count else { throw FileSystem.IndexError.badNode(i) }
+            }
+        }
+        guard root < nodes.count, nodes[Int(root)].isDirectory else { throw FileSystem.IndexError.badNode(Int(root)) }
+
+        let arena = Arena(nodes: nodes, files: files, names: names, keys: keys, archiveURLs: archives, indexingPaths: indexingPaths)
+        return FileSystem.Directory(arena: arena, id: root)
+    }
+
+}
+
+extension BinaryWriter {
+
+    mutating func write(_ directory: FileSystem.Directory, archiveIndex: (URL) -> Int) {
+        let arena = directory.arena
+
+        write(directory.id)
+
+        write(UInt32(arena.archiveURLs.count))
+        arena.archiveURLs.forEach { write(UInt32(archiveIndex($0))) }
+        write(UInt32(arena.names.count))
+        arena.names.forEach { write($0) }
+        write(UInt32(arena.keys.count))
+        arena.keys.forEach { write($0) }
+
+        write(UInt32(arena.nodes.count))
+        for node in arena.nodes {
+            write(node.name)
+            write(node.key)
+            write(node.first)
+            write(node.count)
+        }
+
+        write(UInt32(arena.files.count))
+        for file in arena.files {
+            write(UInt64(file.offset))
+            write(UInt64(file.size))
+            write(UInt64(file.compressedSize))
+            write(file.compression.rawValue)
+            write(file.archive)
+        }
+    }
+
+}
@@ -0,0 +1,181 @@
+//
+//  Filesystem+PathIndex.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+extension FileSystem.Arena {
+
+    /**
+     A hash index of the full path of every node in an `Arena`,
+     so that a path can be resolved with a single hash probe rather than one lookup per path component.
+
+     Paths are hashed (and compared) ASCII case-insensitively, a byte at a time, so a lookup never needs
+     to split, lowercase or otherwise allocate a `String`. A node's path is relative to the root
+     (`units/armcom.fbi`); the path of a node relative to some other directory can be hashed by
+     continuing from that directory's hash.
+     */
+    struct PathIndex {
+
+        /// The hash of every node's full path.
+        private let hashes: [UInt64]
+        /// The parent of every node; used to verify a hash match against the actual path.
+        private let parents: [NodeID]
+        /// An open-addressed (linear probing) table of node ids, offset by one so that zero marks an empty slot.
+        private let table: [UInt32]
+        private let mask: Int
+
+        init(nodes: [Node], names: [String]) {
+            var hashes = [UInt64](repeating: PathHash.basis, count: nodes.count)
+            var parents = [NodeID](repeating: FileSystem.Arena.root, count: nodes.count)
+
+            var pending: [NodeID] = nodes.isEmpty ? [] : [FileSystem.Arena.root]
+            while let directory = pending.popLast() {
+                let prefix = PathHash.continuing(hashes[Int(directory)], from: directory)
+                for child in nodes[Int(directory)].children {
+                    parents[child] = directory
+                    hashes[child] = PathHash.hash(names[Int(nodes[child].name)].utf8, from: prefix)
+                    if nodes[child].isDirectory { pending.append(NodeID(child)) }
+                }
+            }
+
+            var capacity = 16
+            while capacity < nodes.count * 2 { capacity <<= 1 }
+            var table = [UInt32](repeating: 0, count: capacity)
+            let mask = capacity - 1
+            for id in nodes.indices where id != Int(FileSystem.Arena.root) {
+                var slot = Int(truncatingIfNeeded: hashes[id]) & mask
+                while table[slot] != 0 { slot = (slot + 1) & mask }
+                table[slot] = UInt32(id + 1)
+            }
+
+            self.hashes = hashes
+            self.parents = parents
+            self.table = table
+            self.mask = mask
+        }
+
+        /**
+         Finds the node at `path`, relative to `directory`.
+         `path` is a sequence of '/' separated names, compared ASCII case-insensitively; a single leading '/' is ignored.
+         */
+        func node(atPath path: UnsafeRawBufferPointer, in directory: NodeID, of arena: FileSystem.Arena) -> NodeID? {
+            var path = path[...]
+            if path.first == PathHash.separator { path = path.dropFirst() }
+            guard !path.isEmpty else { return nil }
+
+            let hash = PathHash.hash(path, from: PathHash.continuing(hashes[Int(directory)], from: directory))
+            var slot = Int(truncatingIfNeeded: hash) & mask
+            while table[slot] != 0 {
+                let candidate = NodeID(table[slot] - 1)
+                if hashes[Int(candidate)] == hash, matches(path, candidate, in: directory, of: arena) {
+                    return candidate
+                }
+                slot = (slot + 1) & mask
+            }
+            return nil
+        }
+
+        /// Compares `path` to the names of `node` and its ancestors, up to `directory`.
+        private func matches(_ path: Slice<UnsafeRawBufferPointer>, _ node: NodeID, in directory: NodeID, of arena: FileSystem.Arena) -> Bool {
+            var remaining = path
+            var node = node
+            while node != directory {
+                let separator = remaining.lastIndex(of: PathHash.separator)
+                let component = remaining[(separator.map { $0 + 1 } ?? remaining.startIndex)...]
+                let name = arena.names[Int(arena.nodes[Int(node)].name)].utf8
+                guard name.elementsEqual(component, by: { PathHash.fold($0) == PathHash.fold($1) }) else { return false }
+
+                guard let s = separator else {
+                    // The path is used up; so this must be a child of `directory`.
+                    return parents[Int(node)] == directory && node != FileSystem.Arena.root
+                }
+                remaining = remaining[..<s]
+                node = parents[Int(node)]
+                if node == FileSystem.Arena.root && directory != FileSystem.Arena.root { return false }
+            }
+            return false
+        }
+
+    }
+
+    /// An ASCII case-insensitive FNV-1a hash of a path; or of a single name, as with a `KeyIndex`.
+    enum PathHash {
+
+        static let basis: UInt64 = 0xcbf29ce484222325
+        static let prime: UInt64 = 0x100000001b3
+        static let separator = UInt8(ascii: "/")
+
+        @inline(__always) static func fold(_ byte: UInt8) -> UInt8 {
+            return (byte >= UInt8(ascii: "A") && byte <= UInt8(ascii: "Z")) ? byte | 0x20 : byte
+        }
+
+        @inline(__always) static func hash<S: Sequence>(_ bytes: S, from hash: UInt64) -> UInt64 where S.Element == UInt8 {
+            var hash = hash
+            for byte in bytes {
+                hash = (hash ^ UInt64(fold(byte))) &* prime
+            }
+            return hash
+        }
+
+        /// The hash to continue from when hashing the path of something within `directory`.
+        /// The root's children have no leading separator.
+        static func continuing(_ hash: UInt64, from directory: NodeID) -> UInt64 {
+            return directory == FileSystem.Arena.root ? hash : (hash ^ UInt64(separator)) &* prime
+        }
+
+    }
+
+}
+
+// MARK:- Path Lookup
+
+public extension FileSystem.Directory {
+
+    /**
+     Finds the item at `path`, relative to this directory, without allocating.
+     `path` is the UTF-8 bytes of '/' separated names (eg. `objects3d/armcom.3do`), compared ASCII case-insensitively.
+     */
+    func item(atPath path: UnsafeRawBufferPointer) -> FileSystem.Item? {
+        guard let id = node(atPath: path) else { return nil }
+        return arena.item(id)
+    }
+
+    /**
+     Finds the item at `path`, relative to this directory.
+     For a native (non-bridged) string, this does not allocate.
+     */
+    func item(atPath path: Substring) -> FileSystem.Item? {
+        guard let id = node(atPath: path) else { return nil }
+        return arena.item(id)
+    }
+
+    func file(atPath path: Substring) -> FileSystem.File? {
+        return item(atPath: path)?.asFile()
+    }
+
+    func directory(atPath path: Substring) -> FileSystem.Directory? {
+        return item(atPath: path)?.asDirectory()
+    }
+
+}
+
+extension FileSystem.Directory {
+
+    /// The node at `path` according to the arena's `PathIndex`; or nil if the path is not found (or the arena has no index).
+    func node(atPath path: UnsafeRawBufferPointer) -> FileSystem.Arena.NodeID? {
+        return arena.paths?.node(atPath: path, in: id, of: arena)
+    }
+
+    func node(atPath path: Substring) -> FileSystem.Arena.NodeID? {
+        if let found = path.utf8.withContiguousStorageIfAvailable({ node(atPath: UnsafeRawBufferPointer($0)) }) {
+            return found
+        }
+        return ContiguousArray(path.utf8).withUnsafeBytes { node(atPath: $0) }
+    }
+
+}
@@ -12,9 +12,34 @@ public class FileSystem {
     
     public let root: Directory
     
+    /// Every archive merged into `root`, kept open for extracting files.
+    let archives: [URL: HpiArchive]
+    
+    /**
+     An optional cache of extracted file contents, shared by every `FileHandle` opened from this `FileSystem`.
+     Set this before the `FileSystem` is shared between threads.
+     */
+    public var contentCache: ContentCache? = nil
+    
+    /// Where the `featureIndex` is cached on disk, if anywhere; alongside the filesystem index.
+    let featureIndexURL: URL?
+    var builtFeatureIndex: FeatureIndex? = nil
+    let featureIndexLock = NSLock()
+    
     public static let weightedArchiveExtensions = ["ufo", "gp3", "ccx", "gpf", "hpi"]
     
-    public init(mergingHpisIn searchDirectory: URL, extensions: [String] = FileSystem.weightedArchiveExtensions) throws {
+    /**
+     Mount every HPI archive in `searchDirectory` into one merged `FileSystem`.
+     Archives are merged in order of their extension's weight in `extensions`;
+     an item in an earlier archive takes precedence over the same item in a later one.
+     
+     If an `indexURL` is given, the archives' directories are cached in an index file at that location.
+     Archives that have not changed since the index was written are not parsed again
+     (see `loadMergedDirectory(of:usingIndexAt:)`). The `featureIndex` is cached next to it.
+     */
+    public init(mergingHpisIn searchDirectory: URL, extensions: [String] = FileSystem.weightedArchiveExtensions, indexURL: URL? = nil) throws {
+        let span = Trace.begin("Mount FileSystem", category: "load", detail: searchDirectory.path)
+        defer { span.end() }
 
         let weighArchives: (URL, URL) -> Bool = { (a,b) in
             let weightA = extensions.firstIndex(of: a.pathExtension) ?? -1
@@ -22,12 +47,19 @@ public class FileSystem {
             return weightA < weightB
         }
         
-        let merged = try FileSystem.listArchives(in: searchDirectory, allowedExtensions: Set(extensions))
+        let archives = try FileSystem.listArchives(in: searchDirectory, allowedExtensions: Set(extensions))
             .sorted { weighArchives($0, $1) }
-            .map { FileSystem.Directory(from: try HpiItem.loadFromArchive(contentsOf: $0), in: $0) }
-            .reduce(FileSystem.Directory()) { $0.adding(directory: $1) }
+            .map { try HpiArchive(contentsOf: $0) }
+        
+        if let indexURL = indexURL {
+            root = try FileSystem.loadMergedDirectory(of: archives, usingIndexAt: indexURL)
+        }
+        else {
+            root = FileSystem.merge(try FileSystem.loadDirectories(of: archives))
+        }
         
-        root = merged
+        self.archives = archives.reduce(into: [:]) { $0[$1.url] = $1 }
+        featureIndexURL = indexURL.map { $0.appendingPathExtension("features") }
     }
     
     #if !os(Linux)
@@ -64,14 +96,38 @@ public class FileSystem {
     }
     #endif
     
+    /**
+     Parses the directory of every archive.
+     Each archive is independent, so they are parsed concurrently;
+     the result is in the same order as `archives` regardless.
+     */
+    static func loadDirectories(of archives: [HpiArchive]) throws -> [Directory] {
+        return try archives.concurrentMap { (archive) -> Directory in
+            // These are only ever merged, so there is no point in indexing their paths.
+            let arena = Arena(from: try archive.loadDirectory(), in: archive.url, indexingPaths: false)
+            return FileSystem.Directory(arena: arena, id: Arena.root)
+        }
+    }
+    
+    /// Merges archive directories, given in order of precedence, into a single directory tree.
+    static func merge(_ directories: [Directory]) -> Directory {
+        return Directory(merging: directories)
+    }
+    
     /// Load a single HPI file's filesystem.
     public init(hpi url: URL) throws {
-        let hpi = try HpiItem.loadFromArchive(contentsOf: url)
-        root = FileSystem.Directory(from: hpi, in: url)
+        let archive = try HpiArchive(contentsOf: url)
+        root = FileSystem.Directory(from: try archive.loadDirectory(), in: url)
+        archives = [url: archive]
+        featureIndexURL = nil
     }
     
     /// Empty `FileSystem`. No files or directories.
-    public init() { root = Directory() }
+    public init() {
+        root = Directory()
+        archives = [:]
+        featureIndexURL = nil
+    }
     
 }
 
@@ -101,11 +157,16 @@ public extension FileSystem {
     /**
      A listing of contained `Item`.
      These may be Files or more Directories.
+     
+     A `Directory` is a lightweight view of a node in its tree's `Arena`;
+     copying one (or any of the items in it) copies no part of the tree.
      */
     struct Directory {
-        public var name: String
-        public var itemMap: [Int: Item]
-        public var items: Dictionary<Int, Item>.Values { return itemMap.values }
+        let arena: Arena
+        let id: Arena.NodeID
+        
+        public var name: String { return arena.name(of: id) }
+        public var items: Items { return Items(arena: arena, ids: arena.nodes[Int(id)].children) }
     }
     
 }
@@ -159,25 +220,32 @@ public extension FileSystem.File {
 
 public extension FileSystem.Directory {
     
+    /// The items directly contained in a `Directory`, in no particular order.
+    struct Items: RandomAccessCollection {
+        let arena: FileSystem.Arena
+        let ids: Range<Int>
+        
+        public var startIndex: Int { return ids.lowerBound }
+        public var endIndex: Int { return ids.upperBound }
+        public subscript(position: Int) -> FileSystem.Item { return arena.item(FileSystem.Arena.NodeID(position)) }
+    }
+    
     init(from hpiDirectory: HpiItem.Directory, in hpiURL: URL) {
-        name = hpiDirectory.name
-        itemMap = hpiDirectory.items.reduce(into: [Int: FileSystem.Item]()) {
-            let item = FileSystem.Item(from: $1, in: hpiURL)
-            let hash = FileSystem.hashName(item.name)
-            $0[hash] = item
-        }
+        self.init(arena: FileSystem.Arena(from: hpiDirectory, in: hpiURL), id: FileSystem.Arena.root)
     }
     
     init() {
-        name = ""
-        itemMap = [:]
+        self.init(arena: .empty, id: FileSystem.Arena.root)
+    }
+    
+    /// Merges several directories, given in order of precedence, into a single new tree.
+    init(merging directories: [FileSystem.Directory]) {
+        self.init(arena: FileSystem.Arena(merging: directories), id: FileSystem.Arena.root)
     }
     
     subscript(name: String) -> FileSystem.Item? {
-        let hash = FileSystem.hashName(name)
-        guard let item = itemMap[hash] else { return nil }
-        guard FileSystem.compareNames(item.name, name) else { return nil }
-        return item
+        guard let child = arena.child(of: id, named: name) else { return nil }
+        return arena.item(child)
     }
     
     subscript(directory name: String) -> FileSystem.Directory? {
@@ -192,29 +260,14 @@ public extension FileSystem.Directory {
         return item.asFile()
     }
     
+    /**
+     Returns a new tree with the contents of `directory` merged into this one.
+     Same-named subdirectories are merged recursively. Where a name is used by both,
+     the existing item is kept; unless `overwrite` is set, in which case the added item replaces it.
+     */
     func adding(directory: FileSystem.Directory, overwrite: Bool = false) -> FileSystem.Directory {
         guard !items.isEmpty else { return directory }
-        
-        var new = itemMap
-        for item in directory.itemMap {
-            if let existing = new[item.key] {
-                switch item.value {
-                case .file:
-                    if overwrite { new[item.key] = item.value }
-                case .directory(let d):
-                    if case .directory(let dd) = existing {
-                        new[item.key] = .directory(dd.adding(directory: d, overwrite: overwrite))
-                    }
-                    else if overwrite {
-                        new[item.key] = item.value
-                    }
-                }
-            }
-            else {
-                new[item.key] = item.value
-            }
-        }
-        return FileSystem.Directory(name: name, itemMap: new)
+        return FileSystem.Directory(merging: overwrite ? [directory, self] : [self, directory])
     }
     
 }
@@ -255,7 +308,16 @@ public extension FileSystem.Item {
 
 public extension FileSystem.Directory {
     
+    /**
+     Finds the item at `path`, a sequence of '/' separated names relative to this directory.
+     Names are compared ASCII case-insensitively only; any other characters must match exactly.
+     */
     func resolve(path: String) throws -> FileSystem.Item {
+        if arena.paths != nil {
+            guard let id = node(atPath: path[...]) else { throw ResolveError.notFound }
+            return arena.item(id)
+        }
+        
         var pathComponenets = path.components(separatedBy: "/")
         if pathComponenets.first == "" { pathComponenets.removeFirst() }
         return try resolve(pathComponents: pathComponenets)
@@ -321,20 +383,38 @@ public extension FileSystem {
             throw OpenError.pathIsNotFile
         }
         
-        return FileHandle(for: file)
+        return FileHandle(for: file, in: try archive(containing: file), cache: contentCache)
     }
     
     func openFile(_ file: FileSystem.File) throws -> FileHandle {
-        return FileHandle(for: file)
+        return FileHandle(for: file, in: try archive(containing: file), cache: contentCache)
     }
     
+    /// The open archive for `file`. A file from some other `FileSystem` gets its archive opened anew.
+    private func archive(containing file: FileSystem.File) throws -> HpiArchive {
+        return try archives[file.archiveURL] ?? HpiArchive(contentsOf: file.archiveURL)
+    }
+    
+    /**
+     A read handle to a single file in a `FileSystem`.
+     
+     Nothing is extracted until the first read. A large file stored as compressed chunks is then
+     only decompressed a chunk at a time, as the chunks are read; a handful of the most recently
+     read chunks are kept around. Any other file is extracted in its entirety on the first read.
+     
+     Entire files are shared with (and first looked up in) the `FileSystem`'s `contentCache`, if it has one.
+     */
     class FileHandle {
         let file: FileSystem.File
+        fileprivate let archive: HpiArchive
+        fileprivate let cache: ContentCache?
         fileprivate(set) var offsetInFile: Int = 0
-        fileprivate var buffer: Data? = nil
+        fileprivate var contents: Contents? = nil
         
-        fileprivate init(for file: FileSystem.File) {
+        fileprivate init(for file: FileSystem.File, in archive: HpiArchive, cache: ContentCache?) {
             self.file = file
+            self.archive = archive
+            self.cache = cache
         }
     }
     
@@ -351,21 +431,16 @@ extension FileSystem.FileHandle: FileReadHandle {
     }
     
     public func readData(ofLength length: Int) -> Data {
-        
-        if let data = buffer {
-            let start = offsetInFile
-            let end = min(start + length, file.info.size)
+        let start = offsetInFile
+        let end = min(start + max(length, 0), file.info.size)
+        guard start < end else { return Data() }
+        do {
+            let data = try read(start ..< end)
             offsetInFile = end
-            return data.subdata(in: start ..< end)
+            return data
         }
-        else {
-            do {
-                buffer = try HpiItem.extract(file: file.info, fromHPI: file.archiveURL)
-                return readData(ofLength: length)
-            }
-            catch {
-                return Data()
-            }
+        catch {
+            return Data()
         }
     }
     
@@ -391,3 +466,110 @@ extension FileSystem.FileHandle: FileReadHandle {
     }
     
 }
+
+// MARK:- FileHandle Contents
+
+private extension FileSystem.FileHandle {
+    
+    enum Contents {
+        /// The entire file, extracted.
+        case whole(Data)
+        /// A chunked file; and its most recently read chunks.
+        case chunked(HpiArchive.ChunkTable, ChunkCache)
+    }
+    
+    /// The number of decompressed chunks each handle keeps around.
+    static let chunkCacheCapacity = 4
+    
+    func read(_ range: Range<Int>) throws -> Data {
+        
+        if contents == nil {
+            contents = try loadContents()
+        }
+        
+        switch contents! {
+            
+        case .whole(let data):
+            return data.subdata(in: range)
+            
+        case .chunked(let chunks, let cache):
+            let needed = chunks.chunks(covering: range)
+            
+            // A read spanning more chunks than are cached (say, the whole file) might as well
+            // extract everything at once (and in parallel).
+            guard needed.count <= FileSystem.FileHandle.chunkCacheCapacity else {
+                let data = try extractWhole()
+                contents = .whole(data)
+                return data.subdata(in: range)
+            }
+            
+            var out = Data(count: range.count)
+            try out.withUnsafeMutableBytes { (buffer: UnsafeMutableRawBufferPointer) in
+                for index in needed {
+                    let chunkRange = chunks.range(ofChunk: index)
+                    let overlap = range.clamped(to: chunkRange)
+                    let chunk = try cache.chunk(index, size: chunkRange.count) { try archive.extract(chunk: index, of: chunks, into: $0) }
+                    chunk.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+                        let source = bytes[(overlap.lowerBound - chunkRange.lowerBound) ..< (overlap.upperBound - chunkRange.lowerBound)]
+                        UnsafeMutableRawBufferPointer(rebasing: buffer[(overlap.lowerBound - range.lowerBound)...]).copyMemory(from: UnsafeRawBufferPointer(rebasing: source))
+                    }
+                }
+            }
+            return out
+        }
+    }
+    
+    func loadContents() throws -> Contents {
+        
+        if let cached = cache?.data(for: cacheKey) {
+            return .whole(cached)
+        }
+        
+        // Files no larger than the chunk cache gain little from being read lazily;
+        // they are extracted whole, which also lets them be shared through the content cache.
+        if let chunks = try archive.chunkTable(for: file.info), chunks.count > FileSystem.FileHandle.chunkCacheCapacity {
+            return .chunked(chunks, ChunkCache())
+        }
+        
+        return .whole(try extractWhole())
+    }
+    
+    func extractWhole() throws -> Data {
+        let data = try archive.extract(file: file.info)
+        // There's no point caching a file that is just a view into its archive's mapping.
+        if let cache = cache, !archive.extractsWithoutCopying(file.info) {
+            cache.insert(data, for: cacheKey)
+        }
+        return data
+    }
+    
+    var cacheKey: FileSystem.ContentCache.Key {
+        return FileSystem.ContentCache.Key(archiveURL: file.archiveURL, offset: file.info.offset)
+    }
+    
+    /// A small, most-recently-used list of decompressed chunks.
+    final class ChunkCache {
+        
+        private var entries: [(index: Int, data: Data)] = []
+        
+        /// The decompressed chunk at `index`. If it is not already cached, `extract` decompresses it into a new buffer of `size` bytes.
+        func chunk(_ index: Int, size: Int, extract: (UnsafeMutableRawBufferPointer) throws -> Void) throws -> Data {
+            if let i = entries.firstIndex(where: { $0.index == index }) {
+                let entry = entries.remove(at: i)
+                entries.insert(entry, at: 0)
+                return entry.data
+            }
+            
+            var data = Data(count: size)
+            try data.withUnsafeMutableBytes { try extract($0) }
+            
+            entries.insert((index, data), at: 0)
+            if entries.count > FileSystem.FileHandle.chunkCacheCapacity {
+                entries.removeLast()
+            }
+            return data
+        }
+        
+    }
+    
+}
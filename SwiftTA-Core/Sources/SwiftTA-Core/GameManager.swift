@@ -30,11 +30,17 @@ public class GameManager: ScriptMachine {
     private let inputSyncQueue = DispatchQueue(label: "GameInput")
     private var inputQueue = [GameInput]()
     
-    public init(state: GameState, renderer: GameRenderer) {
+    /**
+     Begins a game of the `state`, viewed through `renderer`.
+     Unless `spawningDemoUnits` is false, a commander is placed at the start position and more are periodically spawned.
+     */
+    public init(state: GameState, renderer: GameRenderer, spawningDemoUnits: Bool = true) {
         loadedState = state
         self.renderer = renderer
         
         // TEMP
+        guard spawningDemoUnits else { return }
+        
         if let unit = randomStartingUnit() {
             let id = objectIdGenerator.generate()
             let startPosition = Point2f(state.startPosition)
@@ -70,6 +76,37 @@ public class GameManager: ScriptMachine {
         thread = nil
     }
     
+    /**
+     Runs a single update on the calling thread.
+     This drives the game without the update thread (ie. without `start()`); eg. for a headless benchmark.
+     */
+    public func step() {
+        objectSyncQueue.sync {
+            self.update()
+        }
+    }
+    
+    /**
+     Places a new unit of `type` on the map at `position`; and, if given a `waypoint`, starts it moving there.
+     Returns nil if the `type` was not loaded.
+     */
+    @discardableResult
+    public func spawnUnit(_ type: UnitTypeId, at position: Point2f, movingTo waypoint: Point2f? = nil) -> GameObjectId? {
+        guard let unitType = loadedState.units[type] else { return nil }
+        return objectSyncQueue.sync {
+            let id = objectIdGenerator.generate()
+            let height = loadedState.map.heightMap.height(atWorldPosition: position)
+            var instance = UnitInstance(unitType, position: Vertex3f(xy: position, z: height))
+            instance.scriptContext.startScript("Create")
+            if let waypoint = waypoint {
+                instance.TEMP_waypoint = waypoint
+                instance.scriptContext.startScript("StartMoving")
+            }
+            objects[id] = .unit(instance)
+            return id
+        }
+    }
+    
     public func enqueueInput(_ input: GameInput) {
         inputSyncQueue.sync {
             inputQueue.append(input)
@@ -77,6 +114,9 @@ public class GameManager: ScriptMachine {
     }
     
     private func update() {
+        let span = Trace.begin("Update", category: "game")
+        defer { span.end() }
+        
         let viewState = renderer.viewState
         
         let queue = inputSyncQueue.sync { () -> [GameInput] in
@@ -86,12 +126,18 @@ public class GameManager: ScriptMachine {
         }
         processInput(queue, viewState)
         
+        var moved: [(id: GameObjectId, unit: UnitInstance)] = []
         for (id, object) in objects {
             switch object {
-            case let .unit(instance): updateUnit(instance, id)
+            case let .unit(instance):
+                let (updated, didMove) = updateUnit(instance)
+                if didMove { moved.append((id, updated)) }
+                else { objects[id] = .unit(updated) }
             case .feature: () // No update needed
             }
         }
+        settleOnTerrain(moved)
+        Trace.counter("Objects", Double(objects.count))
         constructView()
     }
     
@@ -133,14 +179,26 @@ public class GameManager: ScriptMachine {
         return nil
     }
     
-    private func updateUnit(_ unit: UnitInstance, _ id: GameObjectId) {
+    /// Runs the unit's scripts & movement; a unit that moved still needs its height settled (see `settleOnTerrain(_:)`).
+    private func updateUnit(_ unit: UnitInstance) -> (UnitInstance, moved: Bool) {
         //guard let type = loadedState.units[unit.type] else { continue }
         
         var updated = unit
         updated.scriptContext.run(for: updated.modelInstance, on: self)
         updated.scriptContext.applyAnimations(to: &updated.modelInstance, for: updateRate)
-        updated.applyMovement(loadedState.map)
-        objects[id] = .unit(updated)
+        let moved = updated.applyMovement()
+        return (updated, moved)
+    }
+    
+    /// Puts every unit that moved this update at the terrain's height; all in one batch of height queries.
+    private func settleOnTerrain(_ moved: [(id: GameObjectId, unit: UnitInstance)]) {
+        guard !moved.isEmpty else { return }
+        let heights = loadedState.map.heightMap.heights(atWorldPositions: moved.map { $0.unit.worldPosition.xy })
+        for (i, (id, unit)) in moved.enumerated() {
+            var settled = unit
+            settled.worldPosition.z = heights[i]
+            objects[id] = .unit(settled)
+        }
     }
     
     private func constructView() {
@@ -362,16 +420,17 @@ public extension UnitInstance {
         status = .alive(Health(value: 100, total: 100))
     }
     
-    mutating func applyMovement(_ map: MapModel) {
+    /// Moves the unit towards its waypoint (if it has one) and returns whether it moved.
+    /// Only the unit's `x` & `y` change; its height is left for the caller to settle onto the terrain.
+    mutating func applyMovement() -> Bool {
         
-        guard let waypoint = TEMP_waypoint else { return }
+        guard let waypoint = TEMP_waypoint else { return false }
         
         let steering = computeSteering(to: waypoint)
         (movementVelocity, movementDirection) = computeVelocity(with: steering)
         
         orientation.z = movementDirection.angle + GameFloat.pi / 2.0
         worldPosition.xy += movementVelocity
-        worldPosition.z = map.heightMap.height(atWorldPosition: worldPosition.xy)
         
         // TEMP - Stops movement when "near" the waypoint.
         if (waypoint - worldPosition.xy).lengthSquared < sqr(2) {
@@ -379,6 +438,7 @@ public extension UnitInstance {
             movementVelocity = .zero
             scriptContext.startScript("StopMoving")
         }
+        return true
     }
     
     // The code below was adapted from the nTA code base (the code there was collected from many sources); a primary root source was:
@@ -41,27 +41,65 @@ public class GameState {
     
     public let startPosition: Point2<Int>
     
+    /**
+     How long each stage of loading took, in seconds.
+     The map, units & sides stages run concurrently, so `total` is less than the sum of the stages.
+     */
+    public struct LoadTimings {
+        public var total: TimeInterval
+        public var map: TimeInterval
+        public var units: TimeInterval
+        public var features: TimeInterval
+        public var sides: TimeInterval
+    }
+    public let loadTimings: LoadTimings
+    
+    /// The units loaded for a sandbox game: the commanders of every side in TA & TA:K.
+    public static let sandboxUnits = ["armcom", "corcom", "araking", "tarnecro", "vermage", "zonhunt", "cresage"]
+    
     public convenience init(loadFrom taDir: URL, mapName: String) throws {
-        try self.init(loadFrom: try FileSystem(mergingHpisIn: taDir), mapName: mapName)
+        try self.init(loadFrom: try FileSystem(mergingHpisIn: taDir, indexURL: FileSystem.cachedIndexURL(for: taDir)), mapName: mapName)
     }
     
-    public init(loadFrom filesystem: FileSystem, mapName: String) throws {
+    /**
+     Loads the map named `mapName` along with the units named in `allowedUnits`;
+     or every unit in the filesystem if `allowedUnits` is nil.
+     Unit models & scripts are loaded through `bakeCache`, if one is given.
+     */
+    public init(loadFrom filesystem: FileSystem, mapName: String, units allowedUnits: [String]? = GameState.sandboxUnits, bakeCache: AssetBakeCache? = nil) throws {
         self.filesystem = filesystem
         let beginGame = Date()
+        let span = Trace.begin("Load Game", category: "load", detail: mapName)
+        defer { span.end() }
+        
+        // The map, the units and the sides are independent of each other, so they all load concurrently.
+        // Only the features depend on anything else: the map (for its features & planet) and the units (for their corpses).
+        
+        let mapStage = LoadStage("Map Stage") { () throws -> (MapInfo, MapModel) in
+            guard let otaFile = filesystem.root[filePath: "maps/" + mapName + ".ota"]
+                else { throw FileSystem.Directory.ResolveError.notFound }
+            let mapInfo = try MapInfo(contentsOf: otaFile, in: filesystem)
+            let map = try MapModel(contentsOf: filesystem.openFile(at: "maps/\(mapName).tnt"))
+            return (mapInfo, map)
+        }
         
-        let beginMap = Date()
-        guard let otaFile = filesystem.root[filePath: "maps/" + mapName + ".ota"]
-            else { throw FileSystem.Directory.ResolveError.notFound }
-        mapInfo = try MapInfo(contentsOf: otaFile, in: filesystem)
+        let unitsStage = LoadStage("Units Stage") { () throws -> [UnitTypeId: UnitData] in
+            let infos = allowedUnits.map { UnitInfo.collectUnits(from: filesystem, onlyAllowing: $0) } ?? UnitInfo.collectUnits(from: filesystem)
+            return try infos
+                .concurrentMap { try? UnitData(loading: $0, from: filesystem, bakeCache: bakeCache) }
+                .reduce(into: [:]) { if let unit = $1 { $0[UnitTypeId(for: unit.info)] = unit } }
+        }
         
-        map = try MapModel(contentsOf: filesystem.openFile(at: "maps/\(mapName).tnt"))
-        let endMap = Date()
+        let sidesStage = LoadStage("Sides Stage") { () throws -> [SideInfo] in
+            let sidedata = try filesystem.openFile(at: "gamedata/sidedata.tdf")
+            return try SideInfo.load(contentsOf: sidedata)
+        }
         
-        let beginUnits = Date()
-        units = UnitInfo.collectUnits(from: filesystem, onlyAllowing: ["armcom", "corcom", "araking", "tarnecro", "vermage", "zonhunt", "cresage"])
-            .compactMap { try? UnitData(loading: $0, from: filesystem) }
-            .reduce(into: [:]) { $0[UnitTypeId(for: $1.info)] = $1 }
-        let endUnits = Date()
+        // Errors are surfaced in the same order as the stages were originally run: map, then sides.
+        let (loadedMapInfo, loadedMap) = try mapStage.wait()
+        mapInfo = loadedMapInfo
+        map = loadedMap
+        units = try unitsStage.wait()
         
         let beginFeatures = Date()
         let corpses = units.values.lazy
@@ -73,21 +111,25 @@ public class GameState {
             filesystem: filesystem)
         let endFeatures = Date()
         
-        let beginSides = Date()
-        let sidedata = try filesystem.openFile(at: "gamedata/sidedata.tdf")
-        sides = try SideInfo.load(contentsOf: sidedata)
-        let endSides = Date()
+        sides = try sidesStage.wait()
         
         startPosition = mapInfo.schema.first?.startPositions.first ?? Point2(32, 32)
         
         let endGame = Date()
         
+        loadTimings = LoadTimings(
+            total: endGame.timeIntervalSince(beginGame),
+            map: mapStage.duration,
+            units: unitsStage.duration,
+            features: endFeatures.timeIntervalSince(beginFeatures),
+            sides: sidesStage.duration)
+        
         print("""
-            Game assets load time: \(endGame.timeIntervalSince(beginGame)) seconds
-              Map(\(map.mapSize)): \(endMap.timeIntervalSince(beginMap)) seconds
-              Units(\(units.count)): \(endUnits.timeIntervalSince(beginUnits)) seconds
-              Features(\(features.count)): \(endFeatures.timeIntervalSince(beginFeatures)) seconds
-              Sides(\(sides.count)): \(endSides.timeIntervalSince(beginSides)) seconds
+            Game assets load time: \(loadTimings.total) seconds
+              Map(\(map.mapSize)): \(loadTimings.map) seconds
+              Units(\(units.count)): \(loadTimings.units) seconds
+              Features(\(features.count)): \(loadTimings.features) seconds
+              Sides(\(sides.count)): \(loadTimings.sides) seconds
             """)
     }
     
@@ -118,7 +160,41 @@ public class GameState {
         #endif
         
         print("Total Annihilation directory: \(taDir)")
-        try self.init(loadFrom: try FileSystem(mergingHpisIn: taDir), mapName: mapName)
+        try self.init(loadFrom: try FileSystem(mergingHpisIn: taDir, indexURL: FileSystem.cachedIndexURL(for: taDir)), mapName: mapName)
+    }
+    
+}
+
+// MARK:- Loading
+
+/**
+ A unit of loading work, started immediately on a background queue.
+ Its result (or error) is held until it is asked for with `wait()`.
+ */
+private final class LoadStage<T> {
+    
+    private let group = DispatchGroup()
+    private var result: Result<T, Error>?
+    private var begin = Date()
+    private var end = Date()
+    
+    init(_ name: StaticString, _ work: @escaping () throws -> T) {
+        DispatchQueue.global(qos: .userInitiated).async(group: group) {
+            self.begin = Date()
+            self.result = Result { try Trace.span(name, category: "load", work) }
+            self.end = Date()
+        }
+    }
+    
+    /// Blocks until the stage has finished, then returns its result (or throws its error).
+    func wait() throws -> T {
+        group.wait()
+        return try result!.get()
+    }
+    
+    /// How long the stage took to run, in seconds. Only valid after `wait()`.
+    var duration: TimeInterval {
+        return end.timeIntervalSince(begin)
     }
     
 }
@@ -0,0 +1,205 @@
+//
+//  IncrementalUnitTextureAtlas.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/**
+ A texture atlas that unit models are added to one at a time, as their unit types are loaded.
+
+ Where a `UnitTextureAtlas` is packed & built once for a single model, this atlas is a set of pages
+ (each a fixed size texture, reserved up front) that textures are packed into as models need them.
+ Every texture of a model goes on the same page, so that the model can still be drawn with a single texture bound;
+ a texture already on that page (say, one shared by every unit of a side) is reused rather than added again.
+ When a model's textures no longer fit on any page, another page is added.
+
+ Nothing already in the atlas ever moves and no page is ever resized;
+ so the texture coordinates of every model added earlier stay valid as more are added.
+ The pixels that change are reported by `takeUpdates()`, to be uploaded a rectangle at a time.
+
+ Every texture is expanded through the one `palette`; so unit types with different palettes (ie. sides) need separate atlases.
+ Alternatively, the pages can be kept as 8-bit palette indices (see `Format`) and drawn through a palette lookup.
+ */
+public final class IncrementalUnitTextureAtlas {
+
+    /// A part of a page whose pixels have changed since the last `takeUpdates()`.
+    public struct Update {
+        public var page: Int
+        public var rect: TextureAtlasPacker.LocationRect
+        /// A new page is reported once, as a whole; its texture needs to be created before it can be drawn with.
+        public var isNewPage: Bool
+    }
+
+    /// The pixels of each page.
+    public enum Format {
+        /// 32-bit RGBA; expanded through the atlas' `palette`.
+        case rgba
+        /// 8-bit palette indices, as the textures have them.
+        case paletteIndex
+        
+        public var bytesPerPixel: Int {
+            switch self {
+            case .rgba: return 4
+            case .paletteIndex: return 1
+            }
+        }
+    }
+
+    /// The size of each new page; a model whose textures can't fit in a page this size gets a larger one of its own.
+    public let pageSize: Size2<Int>
+    public let format: Format
+    public let palette: Palette
+    private let filesystem: FileSystem
+
+    private var pages: [Page] = []
+    private var updates: [Update] = []
+
+    public init(palette: Palette, filesystem: FileSystem, pageSize: Size2<Int> = Size2<Int>(width: 1024, height: 1024), format: Format = .rgba) {
+        self.palette = palette
+        self.filesystem = filesystem
+        self.pageSize = pageSize
+        self.format = format
+    }
+
+    deinit {
+        pages.forEach { $0.pixels.deallocate() }
+    }
+
+    public var pageCount: Int { return pages.count }
+
+    public func size(ofPage page: Int) -> Size2<Int> {
+        return pages[page].bin.size
+    }
+
+    /// The fraction of the page covered by textures.
+    public func occupancy(ofPage page: Int) -> Double {
+        let bin = pages[page].bin
+        return Double(bin.usedArea) / Double(bin.size.area)
+    }
+
+    /// The page's pixels, in the atlas' `format`; rows are `size(ofPage:).width * format.bytesPerPixel` bytes apart.
+    public func withPixels<Result>(ofPage page: Int, _ body: (UnsafeRawBufferPointer) throws -> Result) rethrows -> Result {
+        let page = pages[page]
+        return try body(UnsafeRawBufferPointer(start: page.pixels, count: page.bin.size.area * format.bytesPerPixel))
+    }
+
+    /**
+     Adds a model's textures to the atlas; any it already has on the chosen page are shared.
+     Returns the page that the model's textures are on,
+     and a `UnitTextureAtlas` giving the texture coordinates of each of them within that page.
+     */
+    public func add(_ modelTextures: [UnitModel.Texture], from texPack: ModelTexturePack) -> (page: Int, atlas: UnitTextureAtlas) {
+        let content = UnitTextureAtlas.content(for: modelTextures, from: texPack)
+
+        for page in pages.indices {
+            if let locations = place(content, onPage: page) {
+                return (page, atlas(for: content, at: locations, onPage: page))
+            }
+        }
+
+        // Nothing fit; start another page, growing it if need be.
+        var size = pageSize
+        while true {
+            let page = addPage(sized: size)
+            if let locations = place(content, onPage: page) {
+                updates.append(Update(page: page, rect: TextureAtlasPacker.LocationRect(size), isNewPage: true))
+                return (page, atlas(for: content, at: locations, onPage: page))
+            }
+            pages.removeLast().pixels.deallocate()
+            size = TextureAtlasPacker.grow(size)
+        }
+    }
+
+    /// Every change since the last call; each new page as a whole, and then every rect added to any other page.
+    public func takeUpdates() -> [Update] {
+        let newPages = updates.filter { $0.isNewPage }
+        let newPageIndices = Set(newPages.map { $0.page })
+        defer { updates = [] }
+        return newPages + updates.filter { !newPageIndices.contains($0.page) }
+    }
+
+}
+
+// MARK:- Pages
+
+private extension IncrementalUnitTextureAtlas {
+
+    /// Identifies a texture (whichever model it came from), so that each is only put on a page once.
+    enum Key: Hashable {
+        case color(Int)
+        case image(String)
+    }
+
+    struct Page {
+        var bin: MaxRectsBin
+        var placed: [Key: TextureAtlasPacker.LocationRect]
+        /// `bin.size` pixels, in the atlas' `format`.
+        let pixels: UnsafeMutablePointer<UInt8>
+    }
+
+    func addPage(sized size: Size2<Int>) -> Int {
+        let byteCount = size.area * format.bytesPerPixel
+        let pixels = UnsafeMutablePointer<UInt8>.allocate(capacity: byteCount)
+        pixels.initialize(repeating: 0, count: byteCount)
+        pages.append(Page(bin: MaxRectsBin(size: size), placed: [:], pixels: pixels))
+        return pages.count - 1
+    }
+
+    /// Places all of `content` on the page and draws any new textures; or changes nothing, if there isn't room for all of it.
+    func place(_ content: [UnitTextureAtlas.Content], onPage index: Int) -> [TextureAtlasPacker.LocationRect]? {
+        var bin = pages[index].bin
+        var placed = pages[index].placed
+        var locations = [TextureAtlasPacker.LocationRect](repeating: .zero, count: content.count)
+        var added: [Int] = []
+
+        for i in TextureAtlasPacker.sortedForPacking(content.map { $0.size }) {
+            guard let key = content[i].key else { continue }
+            if let rect = placed[key] {
+                locations[i] = rect
+            }
+            else {
+                guard let rect = bin.insert(content[i].size) else { return nil }
+                placed[key] = rect
+                locations[i] = rect
+                added.append(i)
+            }
+        }
+
+        pages[index].bin = bin
+        pages[index].placed = placed
+        for i in added {
+            let texture = UnitTextureAtlas.Texture(location: locations[i], content: content[i])
+            switch format {
+            case .rgba:
+                UnitTextureAtlas.copy(texture: texture, to: pages[index].pixels, of: bin.size, filesystem: filesystem, palette: palette)
+            case .paletteIndex:
+                UnitTextureAtlas.copyIndices(texture: texture, to: pages[index].pixels, of: bin.size, filesystem: filesystem)
+            }
+            updates.append(Update(page: index, rect: locations[i], isNewPage: false))
+        }
+        return locations
+    }
+
+    func atlas(for content: [UnitTextureAtlas.Content], at locations: [TextureAtlasPacker.LocationRect], onPage page: Int) -> UnitTextureAtlas {
+        let textures = zip(content, locations).map { UnitTextureAtlas.Texture(location: $1, content: $0) }
+        return UnitTextureAtlas(size: pages[page].bin.size, textures: textures)
+    }
+
+}
+
+private extension UnitTextureAtlas.Content {
+
+    /// Textures that were not found take up no space and have no key.
+    var key: IncrementalUnitTextureAtlas.Key? {
+        switch self {
+        case .color(let index): return .color(index)
+        case .gafItem(let gaf): return .image(gaf.item.name)
+        case .notFound: return nil
+        }
+    }
+
+}
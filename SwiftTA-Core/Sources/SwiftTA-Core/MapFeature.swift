@@ -36,29 +36,103 @@ public struct MapFeatureInfo {
 
 extension MapFeatureInfo {
     
-    private init(name: String, object: TdfParser.Object) throws {
+    /// Decodes the feature from its object in a TDF; `parser` should be just inside the object.
+    init(name: String, decoding parser: TdfParser) throws {
+        var definition = Definition()
+        try parser.decodeObject(into: &definition, using: Definition.schema)
+        
         self.name = name
         
-        footprint = Size2<Int>(width: object.numericProperty("footprintx", default: 1),
-                           height: object.numericProperty("footprintz", default: 1))
-        height = object.numericProperty("height", default: 0)
+        footprint = Size2<Int>(width: definition.footprintX, height: definition.footprintZ)
+        height = definition.height
         
-        world = object["world"]
+        world = definition.world
         
-        gafFilename = object["filename"]
-        primaryGafItemName = object["seqname"]
-        shadowGafItemName = object["seqnameshad"]
+        gafFilename = definition.filename
+        primaryGafItemName = definition.seqName
+        shadowGafItemName = definition.seqNameShadow
         
-        hitDensity = object.numericProperty("hitdensity", default: 1)
-        damage = object.numericProperty("damage", default: 1)
+        hitDensity = definition.hitDensity
+        damage = definition.damage
         
-        energy = object.numericProperty("energy", default: 0)
-        metal = object.numericProperty("damage", default: 0)
+        energy = definition.energy
+        metal = definition.metal
         
-        isBlocking = object.boolProperty("blocking", default: true)
-        destructible = Destructible(from: object)
-        reclaimable = Reclaimable(from: object)
-        flammable = Flammable(from: object)
+        isBlocking = definition.isBlocking
+        destructible = Destructible(from: definition)
+        reclaimable = Reclaimable(from: definition)
+        flammable = Flammable(from: definition)
+    }
+    
+}
+
+private extension MapFeatureInfo {
+    
+    /// The properties of a feature's TDF object, with their defaults.
+    struct Definition {
+        var footprintX = 1
+        var footprintZ = 1
+        var height = 0
+        var world: String?
+        var filename: String?
+        var seqName: String?
+        var seqNameShadow: String?
+        var hitDensity = 1
+        var damage = 1
+        var energy = 0
+        var metal = 0
+        var isBlocking = true
+        
+        var isIndestructible = false
+        var seqNameDie: String?
+        var featureDead: String?
+        
+        var isReclaimable = false
+        var seqNameReclamate: String?
+        var featureReclamate: String?
+        
+        var isFlammable = false
+        var sparkTime = 4
+        var spreadChance = 90
+        var burnMin = 5
+        var burnMax = 15
+        var burnWeapon: String?
+        var seqNameBurn: String?
+        var seqNameBurnShadow: String?
+        var featureBurnt: String?
+        
+        static let schema = TdfSchema<Definition>([
+            .field("footprintx") { $0.footprintX = $1.integer(default: 1) },
+            .field("footprintz") { $0.footprintZ = $1.integer(default: 1) },
+            .field("height") { $0.height = $1.integer(default: 0) },
+            .field("world") { $0.world = $1.string },
+            .field("filename") { $0.filename = $1.string },
+            .field("seqname") { $0.seqName = $1.string },
+            .field("seqnameshad") { $0.seqNameShadow = $1.string },
+            .field("hitdensity") { $0.hitDensity = $1.integer(default: 1) },
+            .field("damage") { $0.damage = $1.integer(default: 1) },
+            .field("energy") { $0.energy = $1.integer(default: 0) },
+            .field("metal") { $0.metal = $1.integer(default: 0) },
+            .field("blocking") { $0.isBlocking = $1.bool(default: true) },
+            
+            .field("indestructible") { $0.isIndestructible = $1.bool(default: false) },
+            .field("seqnamedie") { $0.seqNameDie = $1.string },
+            .field("featuredead") { $0.featureDead = $1.string },
+            
+            .field("reclaimable") { $0.isReclaimable = $1.bool(default: false) },
+            .field("seqnamereclamate") { $0.seqNameReclamate = $1.string },
+            .field("featurereclamate") { $0.featureReclamate = $1.string },
+            
+            .field("flamable") { $0.isFlammable = $1.bool(default: false) },
+            .field("sparktime") { $0.sparkTime = $1.integer(default: 4) },
+            .field("spreadchance") { $0.spreadChance = $1.integer(default: 90) },
+            .field("burnmin") { $0.burnMin = $1.integer(default: 5) },
+            .field("burnmax") { $0.burnMax = $1.integer(default: 15) },
+            .field("burnweapon") { $0.burnWeapon = $1.string },
+            .field("seqnameburn") { $0.seqNameBurn = $1.string },
+            .field("seqnameburnshad") { $0.seqNameBurnShadow = $1.string },
+            .field("featureburnt") { $0.featureBurnt = $1.string },
+        ])
     }
     
 }
@@ -96,16 +170,15 @@ public extension MapFeatureInfo.Destructible {
         }
     }
     
-    init(from object: TdfParser.Object) {
-        let isDestructible = !object.boolProperty("indestructible", default: false)
-        self = isDestructible ? .yes(Properties(from: object)) : .no
+    fileprivate init(from definition: MapFeatureInfo.Definition) {
+        self = definition.isIndestructible ? .no : .yes(Properties(from: definition))
     }
 }
 
 private extension MapFeatureInfo.Destructible.Properties {
-    init(from object: TdfParser.Object) {
-        primaryGafItemName = object["seqnamedie"]
-        resultingFeature = (object["featuredead"] ?? "smudge01").lowercased()
+    init(from definition: MapFeatureInfo.Definition) {
+        primaryGafItemName = definition.seqNameDie
+        resultingFeature = (definition.featureDead ?? "smudge01").lowercased()
     }
 }
 
@@ -141,17 +214,16 @@ public extension MapFeatureInfo.Reclaimable {
         }
     }
     
-    fileprivate init(from object: TdfParser.Object) {
-        let isReclaimable = object.boolProperty("reclaimable", default: false)
-        self = isReclaimable ? .yes(Properties(from: object)) : .no
+    fileprivate init(from definition: MapFeatureInfo.Definition) {
+        self = definition.isReclaimable ? .yes(Properties(from: definition)) : .no
     }
 }
 
 private extension MapFeatureInfo.Reclaimable.Properties {
-    init(from object: TdfParser.Object) {
-        primaryGafItemName = object["seqnamereclamate"]
-//        shadowGafItemName = object["seqnamereclamateshad"]
-        resultingFeature = (object["featurereclamate"] ?? "smudge01").lowercased()
+    init(from definition: MapFeatureInfo.Definition) {
+        primaryGafItemName = definition.seqNameReclamate
+//        shadowGafItemName = definition.seqNameReclamateShadow
+        resultingFeature = (definition.featureReclamate ?? "smudge01").lowercased()
     }
 }
 
@@ -192,26 +264,22 @@ public extension MapFeatureInfo.Flammable {
         }
     }
     
-    fileprivate init(from object: TdfParser.Object) {
-        let isFlammable = object.boolProperty("flamable", default: false)
-        self = isFlammable ? .yes(Properties(from: object)) : .no
+    fileprivate init(from definition: MapFeatureInfo.Definition) {
+        self = definition.isFlammable ? .yes(Properties(from: definition)) : .no
     }
 }
 
 private extension MapFeatureInfo.Flammable.Properties {
-    init(from object: TdfParser.Object) {
-        sparkTime = object.numericProperty("sparktime", default: 4)
-        spreadChance = object.numericProperty("spreadchance", default: 90)
+    init(from definition: MapFeatureInfo.Definition) {
+        sparkTime = definition.sparkTime
+        spreadChance = definition.spreadChance
+        burnTime = definition.burnMin...definition.burnMax
         
-        let burnmin = object.numericProperty("burnmin", default: 5)
-        let burnmax = object.numericProperty("burnmax", default: 15)
-        burnTime = burnmin...burnmax
+        weapon = definition.burnWeapon ?? "TreeBurn"
         
-        weapon = object["burnweapon"] ?? "TreeBurn"
-        
-        primaryGafItemName = object["seqnameburn"]
-        shadowGafItemName = object["seqnameburnshad"]
-        resultingFeature = (object["featureburnt"] ?? "Tree1Dead").lowercased()
+        primaryGafItemName = definition.seqNameBurn
+        shadowGafItemName = definition.seqNameBurnShadow
+        resultingFeature = (definition.featureBurnt ?? "Tree1Dead").lowercased()
     }
 }
 
@@ -221,83 +289,45 @@ public extension MapFeatureInfo {
     
     typealias FeatureInfoCollection = [FeatureTypeId: MapFeatureInfo]
     
+    /**
+     Loads the info of every feature in `mapFeatures` & `unitCorpses`, along with every feature that they can turn into.
+     Each feature is found with the filesystem's `featureIndex` and only its own object in its TDF is parsed.
+     A definition in the planet's own features directory is preferred, then one in "corpses", then one in "All Worlds".
+     */
     static func collectFeatures(_ mapFeatures: Set<FeatureTypeId>, planet: String?, unitCorpses: Set<FeatureTypeId> = Set(), filesystem: FileSystem) -> FeatureInfoCollection {
+        let span = Trace.begin("Collect Features", category: "load")
+        defer { span.end() }
         
-        guard let featuresDirectory = filesystem.root[directory: "features"] else { return [:] }
+        let index = filesystem.featureIndex
+        let planetDirectoryName = directoryName(forPlanet: planet)
         
         var toLoad = mapFeatures.union(unitCorpses)
         var features: FeatureInfoCollection = [:]
+        var sources: [Int: Data] = [:]
         
-        if let planetDirectoryName = directoryName(forPlanet: planet), let planetDirectory = featuresDirectory[directory: planetDirectoryName] {
-            collectFeatures(named: &toLoad, into: &features, from: planetDirectory, of: filesystem)
-        }
-        
-        if unitCorpses.isEmpty == false, let corpsesDirectory = featuresDirectory[directory: "corpses"] {
-            collectFeatures(named: &toLoad, into: &features, from: corpsesDirectory, of: filesystem)
-        }
-        
-        if toLoad.isEmpty {
-            return features
-        }
-        
-        if let allWorldsDirectory = featuresDirectory[directory: "All Worlds"] {
-            collectFeatures(named: &toLoad, into: &features, from: allWorldsDirectory, of: filesystem)
-        }
-        
-        if toLoad.isEmpty {
-            return features
-        }
-        
-        var featuresAddedDuringThisLoop = 0
-        outer: repeat {
-            featuresAddedDuringThisLoop = 0
-            for directory in featuresDirectory.items.compactMap({ $0.asDirectory() }) {
-                featuresAddedDuringThisLoop += collectFeatures(named: &toLoad, into: &features, from: directory, of: filesystem)
-                if toLoad.isEmpty { break outer }
-            }
-        }
-        while toLoad.isEmpty == false && featuresAddedDuringThisLoop > 0
-        
-        return features
-    }
-    
-    @discardableResult
-    private static func collectFeatures(named toLoad: inout Set<FeatureTypeId>, into loaded: inout FeatureInfoCollection, from directory: FileSystem.Directory, of filesystem: FileSystem) -> Int
-    {
-        let files = directory.files(withExtension: "tdf")
-        var count = 0
-        
-        for tdf in files.sorted(by: { FileSystem.sortNames($0.name, $1.name) }) {
-            guard let reader = try? filesystem.openFile(tdf) else { continue }
-            count += collectFeatures(named: &toLoad, into: &loaded, from: reader)
-        }
-        
-        return count
-    }
-    
-    @discardableResult
-    private static func collectFeatures<File>(named toLoad: inout Set<FeatureTypeId>, into loaded: inout FeatureInfoCollection, from tdf: File) -> Int
-        where File: FileReadHandle
-    {
-        let parser = TdfParser(tdf)
-        var count = 0
-        
-        while let featureName = parser.skipToNextObject()?.lowercased() {
-            let featureId = FeatureTypeId(named: featureName)
-            if toLoad.contains(featureId) && loaded[featureId] == nil, let featureInfo = try? MapFeatureInfo(name: featureName, object: parser.extractObject()) {
-                loaded[featureId] = featureInfo
-                toLoad.remove(featureId)
-                for childId in featureInfo.childFeatures where toLoad.contains(childId) == false && loaded[childId] == nil {
-                    toLoad.insert(childId)
+        // Each pass loads the features that the previous pass found to be needed.
+        while !toLoad.isEmpty {
+            var next = Set<FeatureTypeId>()
+            
+            for (id, entry) in toLoad.compactMap({ id in index.preferredEntry(for: id, planetDirectory: planetDirectoryName).map { (id, $0) } }) {
+                if sources[entry.source] == nil {
+                    sources[entry.source] = (try? filesystem.openFile(index.file(of: entry)).readDataToEndOfFile()) ?? Data()
                 }
-                count += 1
-            }
-            else {
-                parser.skipObject()
+                guard let data = sources[entry.source] else { continue }
+                
+                let parser = TdfParser(data, startingAt: entry.offset)
+                guard let featureName = parser.skipToNextObject()?.lowercased(),
+                    let featureInfo = try? MapFeatureInfo(name: featureName, decoding: parser)
+                    else { continue }
+                
+                features[id] = featureInfo
+                next.formUnion(featureInfo.childFeatures)
             }
+            
+            toLoad = next.filter { features[$0] == nil }
         }
         
-        return count
+        return features
     }
     
     var childFeatures: Set<FeatureTypeId> {
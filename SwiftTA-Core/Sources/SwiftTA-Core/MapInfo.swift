@@ -40,6 +40,8 @@ public struct MapInfo {
 public extension MapInfo {
     
     init(contentsOf ota: FileSystem.File, in filesystem: FileSystem) throws {
+        let span = Trace.begin("Load OTA", category: "load", detail: ota.name)
+        defer { span.end() }
         
         let info: TdfParser.Object = try {
             let parser = TdfParser(try filesystem.openFile(ota))
@@ -19,6 +19,9 @@ public extension MapModel {
     init<File>(contentsOf tntFile: File) throws
         where File: FileReadHandle
     {
+        let span = Trace.begin("Load TNT", category: "load")
+        defer { span.end() }
+        
         let header = try tntFile.readValue(ofType: TA_TNT_HEADER.self)
         switch header.version {
         case TA_TNT_TOTAL_ANNIHILATION:
@@ -138,8 +141,8 @@ private extension TA_TNT_HEADER {
  */
 public struct HeightMap {
     
-    /// The collection of height values that make up this height map.
-    public var samples: [Int]
+    /// The collection of height values that make up this height map; one byte each, just as the map file has them.
+    public var samples: [UInt8]
     
     /// The number of samples in each dimension (width and height) of the 2D map grid.
     /// (where width * height denote the total count of samples)
@@ -150,7 +153,7 @@ public struct HeightMap {
     public let sampleSize: Size2<Int>
     
     /// Initialize a height map with some samples.
-    public init(samples: [Int], count: Size2<Int>, sampleSize: Size2<Int> = Size2(16,16)) {
+    public init(samples: [UInt8], count: Size2<Int>, sampleSize: Size2<Int> = Size2(16,16)) {
         self.samples = samples
         self.sampleCount = count
         self.sampleSize = sampleSize
@@ -163,20 +166,20 @@ public extension HeightMap {
     /// Computes the map index of the given point in map space.
     /// NOTE: No bounds checking is performed. A point out of bounds will not result in a valid map index.
     func index(ofMapPosition point: Point2<Int>) -> Int {
-        return point.index(rowStride: sampleSize.width)
+        return point.index(rowStride: sampleCount.width)
     }
     
     /// The height sample of the given map index.
     /// NOTE: No bounds checking is performed. An index out of bounds will trap when the sample access is attempted.
     func height(atMapIndex index: Int) -> Int {
-        return samples[index]
+        return Int(samples[index])
     }
     
     /// The height sample of the given point in map space.
     /// NOTE: No bounds checking is performed. A point out of bounds will trap when the sample access is attempted.
     func height(atMapPosition point: Point2<Int>) -> Int {
-        let index = point.index(rowStride: sampleSize.width)
-        return samples[index]
+        let index = point.index(rowStride: sampleCount.width)
+        return Int(samples[index])
     }
     
     /**
@@ -227,7 +230,7 @@ public extension HeightMap {
         // If the 'y' position is outside of the map's height bounds,
         // then just return the sample at the nearest corner.
         guard ys > 0 else { return GameFloat(height(atMapPosition: Point2(x0,0))) }
-        guard ys < GameFloat(sampleCount.height) else { return GameFloat(height(atMapPosition: Point2(x0,sampleCount.height-1))) }
+        guard ys < GameFloat(sampleCount.height-1) else { return GameFloat(height(atMapPosition: Point2(x0,sampleCount.height-1))) }
         
         // The nearest top-left map point is `x0,y0`.
         // We will interpolate `x0,y0` and the point beneath it.
@@ -298,6 +301,90 @@ public extension HeightMap {
     
 }
 
+public extension HeightMap {
+    
+    /**
+     Approximates the height of every world position at once; each exactly as `height(atWorldPosition:)` would.
+     
+     This is for answering many queries a tick (eg. one for every moving unit) without a call & a handful of bounds checks for each.
+     */
+    func heights(atWorldPositions positions: [Point2f]) -> [GameFloat] {
+        var heights = [GameFloat](repeating: 0, count: positions.count)
+        positions.withUnsafeBufferPointer { positions in
+            heights.withUnsafeMutableBufferPointer { self.heights(atWorldPositions: positions, into: $0) }
+        }
+        return heights
+    }
+    
+    /**
+     Writes the height of each of `positions` to the same index of `heights` (which must be at least as long).
+     
+     Positions are taken 8 at a time, as vectors. Each is clamped to the map's bounds; which turns the interpolation at an edge
+     into the same linear one that `height(atWorldPosition:)` does, with no branches. There is no gather instruction to lean on,
+     so each lane's four samples are loaded one by one; the interpolation is then done for all 8 at once.
+     */
+    func heights(atWorldPositions positions: UnsafeBufferPointer<Point2f>, into heights: UnsafeMutableBufferPointer<GameFloat>) {
+        precondition(heights.count >= positions.count, "Not enough room for the heights")
+        
+        // A map too small to interpolate within has nothing to vectorize.
+        guard sampleCount.width > 1 && sampleCount.height > 1 else {
+            for i in positions.indices { heights[i] = height(atWorldPosition: positions[i]) }
+            return
+        }
+        
+        typealias Lanes = SIMD8<GameFloat>
+        let laneCount = Lanes.scalarCount
+        let w = sampleCount.width
+        let scaleX = GameFloat(sampleSize.width), scaleY = GameFloat(sampleSize.height)
+        let maxX = Lanes(repeating: GameFloat(sampleCount.width - 1))
+        let maxY = Lanes(repeating: GameFloat(sampleCount.height - 1))
+        
+        samples.withUnsafeBufferPointer { samples in
+            var i = 0
+            while positions.count - i >= laneCount {
+                var x = Lanes(), y = Lanes()
+                for lane in 0 ..< laneCount {
+                    x[lane] = positions[i + lane].x / scaleX
+                    y[lane] = positions[i + lane].y / scaleY
+                }
+                x = x.clamped(lowerBound: .zero, upperBound: maxX)
+                y = y.clamped(lowerBound: .zero, upperBound: maxY)
+                
+                // The top-left sample of each grid square; one square in from the far edges, so that there is always a square to interpolate.
+                let x0 = pointwiseMin(x.rounded(.down), maxX - 1)
+                let y0 = pointwiseMin(y.rounded(.down), maxY - 1)
+                let index = SIMD8<Int>(x0) &+ SIMD8<Int>(y0) &* w
+                
+                var h00 = Lanes(), h10 = Lanes(), h01 = Lanes(), h11 = Lanes()
+                for lane in 0 ..< laneCount {
+                    let s = index[lane]
+                    h00[lane] = GameFloat(samples[s])
+                    h10[lane] = GameFloat(samples[s+1])
+                    h01[lane] = GameFloat(samples[s+w])
+                    h11[lane] = GameFloat(samples[s+w+1])
+                }
+                
+                // The same arithmetic as `bilinearInterpolation`, lane for lane.
+                let fx = x - x0, fy = y - y0
+                let a = h00 * (1 - fx) * (1 - fy)
+                let b = h10 * fx * (1 - fy)
+                let c = h01 * (1 - fx) * fy
+                let d = h11 * fx * fy
+                let result = a + b + c + d
+                for lane in 0 ..< laneCount {
+                    heights[i + lane] = result[lane]
+                }
+                i += laneCount
+            }
+            while i < positions.count {
+                heights[i] = height(atWorldPosition: positions[i])
+                i += 1
+            }
+        }
+    }
+    
+}
+
 // MARK:- TA
 
 public struct TaMapModel: MapModelType {
@@ -361,7 +448,7 @@ private extension TaMapModel {
         
         tntFile.seek(toFileOffset: header.offsetToMapInfoArray)
         let entries = try tntFile.readArray(ofType: TA_TNT_MAP_ENTRY.self, count: mapSize.area)
-        heightMap = HeightMap(samples: entries.map { Int($0.elevation) }, count: mapSize)
+        heightMap = HeightMap(samples: entries.map { $0.elevation }, count: mapSize)
         
         tntFile.seek(toFileOffset: header.offsetToTileArray)
         let tiles = try tntFile.readData(verifyingLength: Int(header.numberOfTiles) * tileSize.area)
@@ -452,17 +539,14 @@ public extension TaMapModel {
         let tntTileSize = tileSet.tileSize
         let tileBuffer = UnsafeMutableBufferPointer<UInt8>.allocate(capacity: tileSet.count * tntTileSize.area * 4)
         
+        // Every tile is stacked into one tall image, so that the palette expansion can split it into bands of rows.
         tileSet.tiles.withUnsafeBytes() {
             (sourceTiles: UnsafeRawBufferPointer) in
-            let sourceCount = tntTileSize.area * tileSet.count
-            for sourceIndex in 0..<sourceCount {
-                let destinationIndex = sourceIndex * 4
-                let colorIndex = Int(sourceTiles[sourceIndex])
-                tileBuffer[destinationIndex+0] = palette[colorIndex].blue
-                tileBuffer[destinationIndex+1] = palette[colorIndex].green
-                tileBuffer[destinationIndex+2] = palette[colorIndex].red
-                tileBuffer[destinationIndex+3] = 255
-            }
+            guard let source = sourceTiles.baseAddress, let destination = tileBuffer.baseAddress else { return }
+            let size = Size2<Int>(width: tntTileSize.width, height: tntTileSize.height * tileSet.count)
+            palette.expandIndices(source, bytesPerRow: size.width, size: size,
+                                  into: destination, bytesPerRow: size.width * 4,
+                                  layout: .bgra, opaque: true)
         }
         
         return UnsafeBufferPointer(tileBuffer)
@@ -526,7 +610,7 @@ private extension TakMapModel {
         seaLevel = Int(header.seaLevel)
         
         tntFile.seek(toFileOffset: header.offsetToHeightMap)
-        let heights = try tntFile.readArray(ofType: UInt8.self, count: mapSize.area).map { Int($0) }
+        let heights = try tntFile.readArray(ofType: UInt8.self, count: mapSize.area)
         heightMap = HeightMap(samples: heights, count: mapSize)
         
         tntFile.seek(toFileOffset: header.offsetToFeatureEntryArray)
@@ -0,0 +1,100 @@
+//
+//  MappedFile.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/**
+ The entire contents of a file on disk, memory-mapped into the process.
+
+ The file is mapped read-only, so its bytes can be handed out as `Data` without copying
+ (see `data(in:)`). Any such `Data` keeps the mapping alive for as long as it exists.
+ Those views are read-only: they must never be mutated (not even through a copy that
+ still shares their storage), as that would write to the read-only pages and crash.
+ */
+public final class MappedFile {
+
+    public let url: URL
+    public let buffer: UnsafeRawBufferPointer
+
+    public init(contentsOf url: URL) throws {
+
+        let fd = open(url.path, O_RDONLY)
+        guard fd >= 0 else { throw MapError.openFailed(errno) }
+        defer { close(fd) }
+
+        var info = stat()
+        guard fstat(fd, &info) == 0 else { throw MapError.statFailed(errno) }
+        let size = Int(info.st_size)
+
+        if size > 0 {
+            guard let p = mmap(nil, size, PROT_READ, MAP_PRIVATE, fd, 0), p != MappedFile.mapFailed
+                else { throw MapError.mapFailed(errno) }
+            buffer = UnsafeRawBufferPointer(start: p, count: size)
+        }
+        else {
+            buffer = UnsafeRawBufferPointer(start: nil, count: 0)
+        }
+
+        self.url = url
+    }
+
+    deinit {
+        if let p = buffer.baseAddress {
+            munmap(UnsafeMutableRawPointer(mutating: p), buffer.count)
+        }
+    }
+
+    private static let mapFailed = UnsafeMutableRawPointer(bitPattern: -1)
+
+    public enum MapError: Error {
+        case openFailed(Int32)
+        case statFailed(Int32)
+        case mapFailed(Int32)
+        case outOfBounds(Range<Int>)
+    }
+
+}
+
+public extension MappedFile {
+
+    /// The size of the file in bytes.
+    var count: Int { return buffer.count }
+
+    func contains(_ range: Range<Int>) -> Bool {
+        return range.lowerBound >= 0 && range.upperBound <= buffer.count
+    }
+
+    /// A view of the mapped bytes in `range`; throws if any part of `range` lies outside the file.
+    func bytes(in range: Range<Int>) throws -> UnsafeRawBufferPointer {
+        guard contains(range) else { throw MapError.outOfBounds(range) }
+        return UnsafeRawBufferPointer(rebasing: buffer[range])
+    }
+
+    /// Loads a (possibly unaligned) value of type `T` from the given file offset.
+    func load<T>(fromByteOffset offset: Int, as type: T.Type) throws -> T {
+        let source = try bytes(in: Range(start: offset, count: MemoryLayout<T>.size))
+        let value = UnsafeMutablePointer<T>.allocate(capacity: 1)
+        defer { value.deallocate() }
+        UnsafeMutableRawPointer(value).copyMemory(from: source.baseAddress!, byteCount: source.count)
+        return value.pointee
+    }
+
+    /**
+     Returns the bytes in `range` as `Data` without copying them.
+     The returned `Data` references the read-only mapping directly and keeps this `MappedFile` alive.
+     It must not be mutated; copy the bytes out (eg. `Data(Array(data))`) first if they need changing.
+     */
+    func data(in range: Range<Int>) throws -> Data {
+        let source = try bytes(in: range)
+        guard let base = source.baseAddress, source.count > 0 else { return Data() }
+        return Data(bytesNoCopy: UnsafeMutableRawPointer(mutating: base),
+                    count: source.count,
+                    deallocator: .custom({ _, _ in withExtendedLifetime(self) { } }))
+    }
+
+}
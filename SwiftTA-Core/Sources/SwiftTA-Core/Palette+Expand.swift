@@ -0,0 +1,203 @@
+//
+//  Palette+Expand.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+// MARK:- Index Expansion
+
+public extension Palette {
+
+    /// The byte order of expanded pixels.
+    enum PixelLayout {
+        case rgba
+        case bgra
+        /// 3 bytes per pixel; the palette's alpha is dropped.
+        case rgb
+
+        public var bytesPerPixel: Int {
+            switch self {
+            case .rgba, .bgra: return 4
+            case .rgb: return 3
+            }
+        }
+    }
+
+    /**
+     Expands an image of 8-bit palette indices into full color pixels.
+
+     Both the source and destination may be rows of some larger image (ie. have a stride larger than their width).
+     If `flipped`, the source's first row is written to the destination's last. If `opaque`, every pixel's alpha is 255.
+     Large images are expanded a band of rows at a time, concurrently.
+     */
+    func expandIndices(_ source: UnsafeRawPointer, bytesPerRow sourceBytesPerRow: Int, size: Size2<Int>,
+                       into destination: UnsafeMutableRawPointer, bytesPerRow destinationBytesPerRow: Int,
+                       layout: PixelLayout = .rgba, flipped: Bool = false, opaque: Bool = false)
+    {
+        PaletteExpansion(self, layout: layout, opaque: opaque)
+            .expand(source, bytesPerRow: sourceBytesPerRow, size: size, into: destination, bytesPerRow: destinationBytesPerRow, flipped: flipped)
+    }
+
+    /**
+     All 256 of the palette's colors as 32-bit pixels (RGBA, or BGRA); any colors the palette lacks are transparent black.
+     This is the palette as a 256x1 lookup texture, for drawing images of palette indices as they are.
+     If `opaque`, every color's alpha is 255.
+     */
+    func lookupTable(layout: PixelLayout = .rgba, opaque: Bool = false) -> Data {
+        precondition(layout != .rgb, "A palette lookup table has 32-bit pixels")
+        return PaletteExpansion(self, layout: layout, opaque: opaque).table.withUnsafeBytes { Data($0) }
+    }
+
+    /// Expands `imageIndices` (tightly packed, `size` pixels) into a new buffer of tightly packed pixels.
+    func expandIndices(_ imageIndices: Data, size: Size2<Int>, layout: PixelLayout = .rgba, flipped: Bool = false) -> Data {
+        var pixelData = Data(count: size.area * layout.bytesPerPixel)
+        guard size.area > 0 else { return pixelData }
+        pixelData.withUnsafeMutableBytes() { (destination: UnsafeMutableRawBufferPointer) in
+            imageIndices.withUnsafeBytes { (source: UnsafeRawBufferPointer) in
+                expandIndices(source.baseAddress!, bytesPerRow: size.width, size: size,
+                              into: destination.baseAddress!, bytesPerRow: size.width * layout.bytesPerPixel,
+                              layout: layout, flipped: flipped)
+            }
+        }
+        return pixelData
+    }
+
+}
+
+extension Palette {
+
+    /// The color at `index` as a single 32-bit pixel (RGBA, or BGRA); transparent black if the palette lacks it.
+    func pixel(at index: Int, layout: PixelLayout = .rgba, opaque: Bool = false) -> UInt32 {
+        precondition(layout != .rgb, "A single pixel is 32-bit")
+        return withUnsafeBufferPointer { colors in
+            colors.indices.contains(index) ? PaletteExpansion.pixel(colors[index], layout: layout, opaque: opaque) : 0
+        }
+    }
+
+}
+
+/**
+ A palette's colors as 32-bit pixels, ready for expanding palette indices.
+
+ There is no gather instruction to lean on, so each block of 16 indices is loaded as a vector,
+ looked up in the table lane by lane and then stored all at once (as a single 64 byte vector, for 32-bit pixels).
+ */
+struct PaletteExpansion {
+
+    let layout: Palette.PixelLayout
+
+    /// All 256 colors, laid out in memory as `layout` pixels; any colors the palette lacks are transparent black.
+    let table: [UInt32]
+
+    init(_ palette: Palette, layout: Palette.PixelLayout = .rgba, opaque: Bool = false) {
+        self.layout = layout
+        table = palette.withUnsafeBufferPointer { colors in
+            (0 ..< 256).map { i -> UInt32 in
+                guard i < colors.count else { return 0 }
+                return PaletteExpansion.pixel(colors[i], layout: layout, opaque: opaque)
+            }
+        }
+    }
+
+    /// A single color as a 32-bit `layout` pixel.
+    static func pixel(_ color: Palette.Color, layout: Palette.PixelLayout = .rgba, opaque: Bool = false) -> UInt32 {
+        var color = color
+        if layout == .bgra { swap(&color.red, &color.blue) }
+        if opaque { color.alpha = 255 }
+        return withUnsafeBytes(of: color) { $0.load(as: UInt32.self) }
+    }
+
+    /// Rows at a time, per concurrent band; smaller images are expanded serially.
+    private static let rowsPerBand = 64
+    private static let concurrentPixelThreshold = 256 * 1024
+
+    func expand(_ source: UnsafeRawPointer, bytesPerRow sourceBytesPerRow: Int, size: Size2<Int>,
+                into destination: UnsafeMutableRawPointer, bytesPerRow destinationBytesPerRow: Int,
+                flipped: Bool = false)
+    {
+        guard size.width > 0 && size.height > 0 else { return }
+
+        let expandRows = { (rows: Range<Int>) in
+            for y in rows {
+                let row = flipped ? size.height - 1 - y : y
+                self.expandRow(source.assumingMemoryBound(to: UInt8.self) + y * sourceBytesPerRow, count: size.width,
+                               into: destination + row * destinationBytesPerRow)
+            }
+        }
+
+        if size.area < PaletteExpansion.concurrentPixelThreshold {
+            expandRows(0 ..< size.height)
+        }
+        else {
+            let bands = (size.height + PaletteExpansion.rowsPerBand - 1) / PaletteExpansion.rowsPerBand
+            DispatchQueue.concurrentPerform(iterations: bands) { band in
+                let start = band * PaletteExpansion.rowsPerBand
+                expandRows(start ..< min(start + PaletteExpansion.rowsPerBand, size.height))
+            }
+        }
+    }
+
+    /// Expands a single row of `count` indices.
+    func expandRow(_ source: UnsafePointer<UInt8>, count: Int, into destination: UnsafeMutableRawPointer) {
+        table.withUnsafeBufferPointer { table in
+            switch layout {
+            case .rgba, .bgra: PaletteExpansion.expandRow32(source, count: count, into: destination, table: table)
+            case .rgb: PaletteExpansion.expandRow24(source, count: count, into: destination, table: table)
+            }
+        }
+    }
+
+}
+
+private extension PaletteExpansion {
+
+    @inline(__always)
+    static func load16(_ source: UnsafePointer<UInt8>) -> SIMD16<UInt8> {
+        var block = SIMD16<UInt8>()
+        withUnsafeMutableBytes(of: &block) { $0.copyMemory(from: UnsafeRawBufferPointer(start: source, count: 16)) }
+        return block
+    }
+
+    static func expandRow32(_ source: UnsafePointer<UInt8>, count: Int, into destination: UnsafeMutableRawPointer, table: UnsafeBufferPointer<UInt32>) {
+        var i = 0
+        while count - i >= 16 {
+            let indices = load16(source + i)
+            var pixels = SIMD16<UInt32>()
+            for lane in 0 ..< 16 { pixels[lane] = table[Int(indices[lane])] }
+            withUnsafeBytes(of: pixels) { (destination + i * 4).copyMemory(from: $0.baseAddress!, byteCount: 64) }
+            i += 16
+        }
+        while i < count {
+            var pixel = table[Int(source[i])]
+            (destination + i * 4).copyMemory(from: &pixel, byteCount: 4)
+            i += 1
+        }
+    }
+
+    static func expandRow24(_ source: UnsafePointer<UInt8>, count: Int, into destination: UnsafeMutableRawPointer, table: UnsafeBufferPointer<UInt32>) {
+        var i = 0
+        while count - i >= 16 {
+            let indices = load16(source + i)
+            // The alpha byte of each looked up pixel is left behind.
+            var pixels = SIMD16<UInt32>()
+            for lane in 0 ..< 16 { pixels[lane] = table[Int(indices[lane])] }
+            withUnsafeBytes(of: pixels) { packed in
+                let out = destination + i * 3
+                for lane in 0 ..< 16 {
+                    out.advanced(by: lane * 3).copyMemory(from: packed.baseAddress! + lane * 4, byteCount: 3)
+                }
+            }
+            i += 16
+        }
+        while i < count {
+            var pixel = table[Int(source[i])]
+            (destination + i * 3).copyMemory(from: &pixel, byteCount: 3)
+            i += 1
+        }
+    }
+
+}
@@ -114,105 +114,26 @@ extension Palette {
 public extension Palette {
     
     func mapIndicesRgb(_ imageIndices: Data, size: Size2<Int>) -> Data {
-        let palette = self
-        var pixelData = Data(count: size.area * 3)
-        pixelData.withUnsafeMutableBytes() { (destination: UnsafeMutableRawBufferPointer) in
-            imageIndices.withUnsafeBytes { (source: UnsafeRawBufferPointer) in
-                var destinationIndex = destination.startIndex
-                var sourceIndex = source.startIndex
-                for _ in 0..<(size.width * size.height) {
-                    let colorIndex = source[sourceIndex]
-                    destination[destinationIndex+0] = palette[colorIndex].red
-                    destination[destinationIndex+1] = palette[colorIndex].green
-                    destination[destinationIndex+2] = palette[colorIndex].blue
-                    destinationIndex += 3
-                    sourceIndex += 1
-                }
-            }
-        }
-        return pixelData
+        return expandIndices(imageIndices, size: size, layout: .rgb)
     }
     
     func mapIndicesRgbFlipped(_ imageIndices: Data, size: Size2<Int>) -> Data {
-        let palette = self
-        var pixelData = Data(count: size.area * 3)
-        pixelData.withUnsafeMutableBytes() { (destination: UnsafeMutableRawBufferPointer) in
-            imageIndices.withUnsafeBytes { (source: UnsafeRawBufferPointer) in
-                var destinationIndex = destination.endIndex - (size.width * 3)
-                var sourceIndex = source.startIndex
-                for _ in 0..<size.height {
-                    for _ in 0..<size.width {
-                        let colorIndex = source[sourceIndex]
-                        destination[destinationIndex+0] = palette[colorIndex].red
-                        destination[destinationIndex+1] = palette[colorIndex].green
-                        destination[destinationIndex+2] = palette[colorIndex].blue
-                        destinationIndex += 3
-                        sourceIndex += 1
-                    }
-                    destinationIndex -= (size.width * 3) * 2
-                }
-            }
-        }
-        return pixelData
+        return expandIndices(imageIndices, size: size, layout: .rgb, flipped: true)
     }
     
     func mapIndicesRgba(_ imageIndices: Data, size: Size2<Int>) -> Data {
-        let palette = self
-        var pixelData = Data(count: size.area * 4)
-        pixelData.withUnsafeMutableBytes() { (destination: UnsafeMutableRawBufferPointer) in
-            imageIndices.withUnsafeBytes { (source: UnsafeRawBufferPointer) in
-                var destinationIndex = destination.startIndex
-                var sourceIndex = source.startIndex
-                for _ in 0..<(size.width * size.height) {
-                    let colorIndex = source[sourceIndex]
-                    destination[destinationIndex+0] = palette[colorIndex].red
-                    destination[destinationIndex+1] = palette[colorIndex].green
-                    destination[destinationIndex+2] = palette[colorIndex].blue
-                    destination[destinationIndex+3] = palette[colorIndex].alpha
-                    destinationIndex += 4
-                    sourceIndex += 1
-                }
-            }
-        }
-        return pixelData
+        return expandIndices(imageIndices, size: size, layout: .rgba)
     }
     
     func mapIndicesRgbaFlipped(_ imageIndices: Data, size: Size2<Int>) -> Data {
-        let palette = self
-        var pixelData = Data(count: size.area * 4)
-        pixelData.withUnsafeMutableBytes() { (destination: UnsafeMutableRawBufferPointer) in
-            imageIndices.withUnsafeBytes { (source: UnsafeRawBufferPointer) in
-                var destinationIndex = destination.endIndex - (size.width * 4)
-                var sourceIndex = source.startIndex
-                for _ in 0..<size.height {
-                    for _ in 0..<size.width {
-                        let colorIndex = source[sourceIndex]
-                        destination[destinationIndex+0] = palette[colorIndex].red
-                        destination[destinationIndex+1] = palette[colorIndex].green
-                        destination[destinationIndex+2] = palette[colorIndex].blue
-                        destination[destinationIndex+3] = palette[colorIndex].alpha
-                        destinationIndex += 4
-                        sourceIndex += 1
-                    }
-                    destinationIndex -= (size.width * 4) * 2
-                }
-            }
-        }
-        return pixelData
+        return expandIndices(imageIndices, size: size, layout: .rgba, flipped: true)
     }
     
     func makeRgba(withColorAtIndex colorIndex: UInt8, size: Size2<Int>) -> Data {
-        let palette = self
+        let color = pixel(at: Int(colorIndex))
         var pixelData = Data(count: size.area * 4)
         pixelData.withUnsafeMutableBytes() { (destination: UnsafeMutableRawBufferPointer) in
-            var destinationIndex = destination.startIndex
-            for _ in 0..<(size.width * size.height) {
-                destination[destinationIndex+0] = palette[colorIndex].red
-                destination[destinationIndex+1] = palette[colorIndex].green
-                destination[destinationIndex+2] = palette[colorIndex].blue
-                destination[destinationIndex+3] = palette[colorIndex].alpha
-                destinationIndex += 4
-            }
+            destination.bindMemory(to: UInt32.self).initialize(repeating: color)
         }
         return pixelData
     }
@@ -26,6 +26,9 @@ public extension SideInfo {
     static func load<File>(contentsOf tdf: File) throws -> [SideInfo]
         where File: FileReadHandle
     {
+        let span = Trace.begin("Load Sides", category: "load")
+        defer { span.end() }
+        
         var sides = [SideInfo]()
         
         let parser = TdfParser(tdf)
@@ -8,10 +8,10 @@
 
 import Foundation
 
-// TODO: Support Unicode for TDF parsing.
-// I tried using Character as the base type but the resulting code ran an order of magnitude slower than the withUnsafeBytes+UInt8 solution.
-
-
+/**
+ Parses TDF files (.tdf, .fbi, .ota, etc) into `String` tokens or `Object` dictionaries.
+ The actual scanning is done by a `TdfTokenizer`; `String`s are only created for the parts of the file that are asked for.
+ */
 public class TdfParser {
     
     public init<File>(_ file: File) where File: FileReadHandle {
@@ -20,6 +20,11 @@ public class TdfParser {
     public init(_ data: Data) {
         self.data = data
     }
+    /// Parses `data` from `offset` on; which should be outside of any section (eg. at a top-level `[`).
+    public init(_ data: Data, startingAt offset: Int) {
+        self.data = data
+        self.tokenizer = TdfTokenizer(UnsafeRawBufferPointer(start: nil, count: 0), startingAt: offset)
+    }
     
     public enum Token: Equatable {
         case objectBegin(String)
@@ -28,91 +33,82 @@ public class TdfParser {
     }
     
     fileprivate var data: Data
-    fileprivate var scanPosition: Int = 0
-    fileprivate var state: State = .seekingSection
-    fileprivate var context = Context()
+    fileprivate var tokenizer = TdfTokenizer(UnsafeRawBufferPointer(start: nil, count: 0))
 }
 
 public extension TdfParser {
     
-    var isAtEnd: Bool { return scanPosition >= data.count }
+    var isAtEnd: Bool { return tokenizer.position >= data.count }
     
-    var depth: Int { return context.parents.count }
+    var depth: Int { return tokenizer.depth }
     
-    var currentObject: String? { return context.parents.last }
-    var currentObjects: [String] { return context.parents }
+    var currentObject: String? { return withTokenizer { $0.currentObject } }
+    var currentObjects: [String] { return withTokenizer { t in t.parents.map { t.string($0) } } }
     
     func nextToken() -> Token? {
-        
-        let count = data.count
-        var token: Token?
-        
-        data.withUnsafeBytes() {
-            while scanPosition < count && token == nil {
-                (state, token) = TdfParser.transition(state, consuming: $0[scanPosition], context: &context)
-                scanPosition += 1
-            }
-        }
-        
-        return token
+        return withTokenizer { t in t.next().map { t.token(for: $0) } }
     }
     
     @discardableResult
     func skipToObject(named: String) -> Bool {
-        
-        let startDepth = depth
-        
-        while let token = nextToken() {
-            switch token {
-            case .objectBegin(let section):
-                if depth-1 == startDepth && section == named {
-                    return true
-                }
-            case .objectEnd:
-                if depth < startDepth {
-                    return false
+        return withTokenizer { t in
+            let startDepth = t.depth
+            
+            while let token = t.next() {
+                switch token {
+                case .objectBegin(let section):
+                    if t.depth-1 == startDepth && t.matches(section, named) {
+                        return true
+                    }
+                case .objectEnd:
+                    if t.depth < startDepth {
+                        return false
+                    }
+                case .property: ()
                 }
-            case .property: ()
             }
+            
+            return false
         }
-        
-        return false
     }
     
     @discardableResult
     func skipToNextObject() -> String? {
-        
-        let startDepth = depth
-        
-        while let token = nextToken() {
-            switch token {
-            case .objectBegin(let section):
-                if depth-1 == startDepth {
-                    return section
-                }
-            case .objectEnd:
-                if depth < startDepth {
-                    return nil
+        return withTokenizer { t in
+            let startDepth = t.depth
+            
+            while let token = t.next() {
+                switch token {
+                case .objectBegin(let section):
+                    if t.depth-1 == startDepth {
+                        return t.string(section)
+                    }
+                case .objectEnd:
+                    if t.depth < startDepth {
+                        return nil
+                    }
+                case .property: ()
                 }
-            case .property: ()
             }
+            
+            return nil
         }
-        
-        return nil
     }
     
     func skipObject() {
         guard depth > 0 else { return }
         
-        let startDepth = depth
-        while let token = nextToken() {
-            switch token {
-            case .objectBegin: ()
-            case .objectEnd:
-                if depth == startDepth-1 {
-                    return
+        withTokenizer { t in
+            let startDepth = t.depth
+            while let token = t.next() {
+                switch token {
+                case .objectBegin: ()
+                case .objectEnd:
+                    if t.depth == startDepth-1 {
+                        return
+                    }
+                case .property: ()
                 }
-            case .property: ()
             }
         }
     }
@@ -122,26 +118,19 @@ public extension TdfParser {
 public extension TdfParser {
     
     func forEachProperty(perform: (_ key: String, _ value: String) -> ()) {
-        
-        let startDepth = depth
-        let count = data.count
-        var token: Token?
-        
-        data.withUnsafeBytes() {
-            while scanPosition < count {
-                (state, token) = TdfParser.transition(state, consuming: $0[scanPosition], context: &context)
-                scanPosition += 1
+        withTokenizer { t in
+            let startDepth = t.depth
+            while let token = t.next() {
                 switch token {
-                case let .property(key, value)? where depth == startDepth:
-                    perform(key, value)
-                case .objectEnd? where depth == startDepth-1:
+                case let .property(key, value) where t.depth == startDepth:
+                    perform(t.string(key), t.string(value))
+                case .objectEnd where t.depth == startDepth-1:
                     return
                 default:
                     () // ignore
                 }
             }
         }
-        
     }
     
     static func parse<File>(_ file: File, tokenHandler: (Token) -> () ) where File: FileReadHandle {
@@ -150,14 +139,10 @@ public extension TdfParser {
     }
     
     static func parse(_ data: Data, tokenHandler: (Token) -> () ) {
-        let count = data.count
-        data.withUnsafeBytes() {
-            var state = State.seekingSection
-            var context = Context()
-            var token: Token?
-            for i in 0..<count {
-                (state, token) = transition(state, consuming: $0[i], context: &context)
-                if let token = token { tokenHandler(token) }
+        data.withUnsafeBytes() { (bytes: UnsafeRawBufferPointer) in
+            var tokenizer = TdfTokenizer(bytes)
+            while let token = tokenizer.next() {
+                tokenHandler(tokenizer.token(for: token))
             }
         }
     }
@@ -175,26 +160,20 @@ public extension TdfParser {
     
     func extractAll() -> Dictionary<String, Object> {
         
-        let count = data.count
-        var token: Token?
-        
         var level = 0
         var levels: [Object] = [Object()]
         
-        data.withUnsafeBytes() {
-            while scanPosition < count {
-                (state, token) = TdfParser.transition(state, consuming: $0[scanPosition], context: &context)
-                scanPosition += 1
-                guard let token = token else { continue }
+        withTokenizer { t in
+            while let token = t.next() {
                 switch token {
                 case .objectBegin:
                     level += 1
                     levels.append(Object())
                 case let .objectEnd(name):
                     level -= 1
-                    levels[level].subobjects[name] = levels.popLast() ?? Object()
+                    levels[level].subobjects[t.string(name)] = levels.popLast() ?? Object()
                 case let .property(key, value):
-                    levels[level].properties[key] = value
+                    levels[level].properties[t.string(key)] = t.string(value)
                 }
             }
         }
@@ -217,17 +196,11 @@ public extension TdfParser {
     
     func extractObject(normalizeKeys: Bool = false) -> Object {
         
-        let count = data.count
-        var token: Token?
-        
         var level = 0
         var levels: [Object] = [Object()]
         
-        data.withUnsafeBytes() {
-            while scanPosition < count {
-                (state, token) = TdfParser.transition(state, consuming: $0[scanPosition], context: &context)
-                scanPosition += 1
-                guard let token = token else { continue }
+        withTokenizer { t in
+            while let token = t.next() {
                 switch token {
                 case .objectBegin:
                     level += 1
@@ -235,10 +208,10 @@ public extension TdfParser {
                 case let .objectEnd(name):
                     guard level > 0 else { return }
                     level -= 1
-                    levels[level].subobjects[name] = levels.popLast() ?? Object()
+                    levels[level].subobjects[t.string(name)] = levels.popLast() ?? Object()
                 case let .property(key, value):
-                    let key = normalizeKeys ? key.lowercased() : key
-                    levels[level].properties[key] = value
+                    let key = normalizeKeys ? t.string(key).lowercased() : t.string(key)
+                    levels[level].properties[key] = t.string(value)
                 }
             }
         }
@@ -248,6 +221,41 @@ public extension TdfParser {
     
 }
 
+// MARK:- Schema Decode
+
+public extension TdfParser {
+    
+    /**
+     Decodes the properties of the current object straight into `target`, using `schema`.
+     Like `extractObject()`, this consumes the rest of the current object; its subobjects are skipped.
+     Throws `Object.LoadError.requiredPropertyNotFound` if any of the schema's required properties are missing.
+     */
+    func decodeObject<Target>(into target: inout Target, using schema: TdfSchema<Target>) throws {
+        var found: UInt64 = 0
+        
+        withTokenizer { t in
+            let startDepth = t.depth
+            while let token = t.next() {
+                switch token {
+                case let .property(key, value) where t.depth == startDepth:
+                    guard let field = schema.index(ofKey: UnsafeRawBufferPointer(rebasing: t.bytes[key])) else { continue }
+                    schema.fields[field].decode(&target, TdfValue(bytes: UnsafeRawBufferPointer(rebasing: t.bytes[value])))
+                    found |= schema.requiredBit(ofField: field)
+                case .objectEnd where t.depth < startDepth:
+                    return
+                default:
+                    () // ignore
+                }
+            }
+        }
+        
+        if found != schema.requiredMask, let missing = schema.firstMissingKey(found: found) {
+            throw Object.LoadError.requiredPropertyNotFound(missing)
+        }
+    }
+    
+}
+
 public extension TdfParser.Object {
     
     init() {
@@ -306,140 +314,28 @@ public extension TdfParser.Object {
     
 }
 
-// MARK:- Core State Machine
+// MARK:- Tokenizing
 
-fileprivate extension TdfParser {
-    
-    enum State {
-        case seekingSection
-        case readingSectionName
-        case seekingSectionStart
-        case seekingKeyValue
-        case readingKey
-        case readingValue
-    }
-    
-    struct Context {
-        var parents: [String]
-        var section: [UInt8]
-        var key: [UInt8]
-        var value: [UInt8]
-        var whitespace: [UInt8]
-        
-        init() {
-            parents = []
-            parents.reserveCapacity(1)
-            section = []
-            section.reserveCapacity(16)
-            key = []
-            key.reserveCapacity(16)
-            value = []
-            value.reserveCapacity(32)
-            whitespace = []
+private extension TdfParser {
+    
+    /// Runs `body` with the parser's tokenizer looking at `data`; the tokenizer never holds on to `data`'s bytes beyond that.
+    func withTokenizer<R>(_ body: (inout TdfTokenizer) -> R) -> R {
+        return data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) -> R in
+            tokenizer.bytes = bytes
+            defer { tokenizer.bytes = UnsafeRawBufferPointer(start: nil, count: 0) }
+            return body(&tokenizer)
         }
     }
     
-    static let sectionNameStart: UInt8 = 91 // "["
-    static let sectionNameStop: UInt8 = 93 // "]"
-    static let sectionBodyStart: UInt8 = 123 // "{"
-    static let sectionBodyStop: UInt8 = 125 // "}"
-    static let whitespaceToIgnore: Set<UInt8> = [32, 10, 13, 9] //[" ", "\r\n", "\r", "\n", "\t"]
-    static let keyValueSeparator: UInt8 = 61 // "="
-    static let keyValueStop: UInt8 = 59 // ";"
+}
+
+private extension TdfTokenizer {
     
-    static func transition(_ state: State, consuming character: UInt8, context: inout Context) -> (State, Token?) {
-        switch state {
-            
-        case .seekingSection:
-            if character == sectionNameStart {
-                context.section.removeAll()
-                return (.readingSectionName, nil)
-            }
-            else {
-                return (state, nil)
-            }
-            
-        case .readingSectionName:
-            if character == sectionNameStop {
-                return (.seekingSectionStart, nil)
-            }
-            else {
-                context.section.append(character)
-                return (.readingSectionName, nil)
-            }
-            
-        case .seekingSectionStart:
-            if character == sectionBodyStart {
-                let name = String(bytes: context.section, encoding: .ascii) ?? ""
-                context.parents.append(name)
-                return (.seekingKeyValue, .objectBegin(name))
-            }
-            else if character == sectionBodyStop {
-                let name = context.parents.popLast() ?? ""
-                return (context.parents.isEmpty ? .seekingSection : .seekingKeyValue, .objectEnd(name))
-            }
-            else {
-                return (state, nil)
-            }
-            
-        case .seekingKeyValue:
-            if whitespaceToIgnore.contains(character) {
-                return (state, nil)
-            }
-            else if character == sectionNameStart {
-                context.section.removeAll()
-                return (.readingSectionName, nil)
-            }
-            else if character == sectionBodyStop {
-                let name = context.parents.popLast() ?? ""
-                return (context.parents.isEmpty ? .seekingSection : .seekingKeyValue, .objectEnd(name))
-            }
-            else {
-                context.key.removeAll()
-                context.key.append(character)
-                context.whitespace.removeAll()
-                return (.readingKey, nil)
-            }
-            
-        case .readingKey:
-            if character == keyValueSeparator {
-                context.value.removeAll()
-                context.whitespace.removeAll()
-                return (.readingValue, nil)
-            }
-            else if whitespaceToIgnore.contains(character) {
-                context.whitespace.append(character)
-                return (.readingKey, nil)
-            }
-            else {
-                if !context.whitespace.isEmpty {
-                    context.key.append(contentsOf: context.whitespace)
-                    context.whitespace.removeAll()
-                }
-                context.key.append(character)
-                return (.readingKey, nil)
-            }
-            
-        case .readingValue:
-            if character == keyValueStop {
-                let key = String(bytes: context.key, encoding: .ascii) ?? ""
-                let value = String(bytes: context.value, encoding: .ascii) ?? ""
-                return (.seekingKeyValue, .property(key, value))
-            }
-            else if whitespaceToIgnore.contains(character) {
-                if !context.value.isEmpty {
-                    context.whitespace.append(character)
-                }
-                return (.readingValue, nil)
-            }
-            else {
-                if !context.whitespace.isEmpty {
-                    context.value.append(contentsOf: context.whitespace)
-                    context.whitespace.removeAll()
-                }
-                context.value.append(character)
-                return (.readingValue, nil)
-            }
+    func token(for token: Token) -> TdfParser.Token {
+        switch token {
+        case .objectBegin(let name): return .objectBegin(string(name))
+        case .objectEnd(let name): return .objectEnd(string(name))
+        case let .property(key, value): return .property(string(key), string(value))
         }
     }
     
@@ -0,0 +1,238 @@
+//
+//  TdfSchema.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/**
+ The properties of a TDF object that fill in a `Target`, each declared once along with how to decode its value.
+
+ Use a schema with `TdfParser.decodeObject(into:using:)` to fill in a typed struct straight from the tokenizer;
+ no `TdfParser.Object` dictionaries are built along the way. Keys are matched case-insensitively
+ (as TA itself does) through a perfect hash table, and numeric values are parsed straight from the source bytes,
+ so only `String` fields ever create a `String`.
+
+     static let schema = TdfSchema<Thing>([
+         .field("name", required: true) { $0.name = $1.string },
+         .field("size") { $0.size = $1.integer(default: 1) },
+     ])
+ */
+public struct TdfSchema<Target> {
+
+    public struct Field {
+        let key: [UInt8]
+        let isRequired: Bool
+        let decode: (inout Target, TdfValue) -> ()
+
+        /// A property of the object named `key`; any case. If a `required` property is missing, decoding throws.
+        public static func field(_ key: String, required: Bool = false, _ decode: @escaping (inout Target, TdfValue) -> ()) -> Field {
+            return Field(key: key.utf8.map(TdfSchema.lowercased), isRequired: required, decode: decode)
+        }
+    }
+
+    let fields: [Field]
+
+    /// The field index (or -1) for each slot of the hash table.
+    private let slots: [Int16]
+    private let seed: UInt32
+    private let mask: UInt32
+
+    /// A bit for each required field, set in the order they are declared.
+    private let requiredBits: [UInt64]
+    let requiredMask: UInt64
+
+    public init(_ fields: [Field]) {
+        precondition(fields.count < Int(Int16.max), "Too many TDF schema fields")
+        let required = fields.filter { $0.isRequired }.count
+        precondition(required <= 64, "A TDF schema can have at most 64 required fields")
+
+        self.fields = fields
+
+        var bit: UInt64 = 1
+        requiredBits = fields.map { field in
+            guard field.isRequired else { return 0 }
+            defer { bit <<= 1 }
+            return bit
+        }
+        requiredMask = requiredBits.reduce(0, |)
+
+        let table = TdfSchema.perfectHash(of: fields.map { $0.key })
+        slots = table.slots
+        seed = table.seed
+        mask = table.mask
+    }
+
+    /// The index in `fields` of the field named `key`, if any.
+    @inline(__always)
+    func index(ofKey key: UnsafeRawBufferPointer) -> Int? {
+        let index = Int(slots[Int(TdfSchema.hash(key, seed: seed) & mask)])
+        guard index >= 0 else { return nil }
+
+        let expected = fields[index].key
+        guard expected.count == key.count else { return nil }
+        for i in 0 ..< key.count where TdfSchema.lowercased(key[i]) != expected[i] {
+            return nil
+        }
+        return index
+    }
+
+    func requiredBit(ofField index: Int) -> UInt64 {
+        return requiredBits[index]
+    }
+
+    /// The key of the first required field missing from `found`.
+    func firstMissingKey(found: UInt64) -> String? {
+        guard let field = fields.indices.first(where: { requiredBits[$0] != 0 && found & requiredBits[$0] == 0 }) else { return nil }
+        return String(decoding: fields[field].key, as: UTF8.self)
+    }
+
+}
+
+private extension TdfSchema {
+
+    /// Finds the seed (and smallest table) that hashes every key to its own slot.
+    static func perfectHash(of keys: [[UInt8]]) -> (slots: [Int16], seed: UInt32, mask: UInt32) {
+        var size = 1
+        while size < keys.count * 2 { size <<= 1 }
+        while true {
+            let mask = UInt32(size - 1)
+            seeds: for seed in UInt32(0) ..< 256 {
+                var slots = [Int16](repeating: -1, count: size)
+                for (index, key) in keys.enumerated() {
+                    let slot = Int(key.withUnsafeBytes { hash($0, seed: seed) } & mask)
+                    guard slots[slot] < 0 else { continue seeds }
+                    slots[slot] = Int16(index)
+                }
+                return (slots, seed, mask)
+            }
+            size <<= 1
+        }
+    }
+
+    @inline(__always)
+    static func lowercased(_ byte: UInt8) -> UInt8 {
+        return byte &- 65 < 26 ? byte | 0x20 : byte
+    }
+
+    /// FNV-1a over the ASCII-lowercased bytes, perturbed by `seed`.
+    @inline(__always)
+    static func hash(_ bytes: UnsafeRawBufferPointer, seed: UInt32) -> UInt32 {
+        var hash: UInt32 = 2166136261 ^ (seed &* 0x9E3779B9)
+        for byte in bytes {
+            hash = (hash ^ UInt32(lowercased(byte))) &* 16777619
+        }
+        return hash
+    }
+
+}
+
+// MARK:- Values
+
+/**
+ The value of a property, as it is being decoded by a `TdfSchema`.
+ The value only borrows the source bytes; it is not valid outside of the schema's `decode` closure.
+ */
+public struct TdfValue {
+
+    public let bytes: UnsafeRawBufferPointer
+
+    public var string: String {
+        return TdfTokenizer.string(from: bytes)
+    }
+
+    /// The value as an integer, just as `Int(_: String)` would parse it; or `default` if it isn't one.
+    public func integer<T: FixedWidthInteger>(default: T) -> T {
+        return integer() ?? `default`
+    }
+
+    /// The value as a TDF boolean (a nonzero integer); or `default` if it isn't an integer.
+    public func bool(default: Bool) -> Bool {
+        return (integer() as Int?).map { $0 != 0 } ?? `default`
+    }
+
+    /// The value as a `Float`, just as `Float(_: String)` would parse it; or `default` if it isn't one.
+    public func float(default: Float) -> Float {
+        return float() ?? `default`
+    }
+
+}
+
+private extension TdfValue {
+
+    static let minus: UInt8 = 45 // "-"
+    static let plus: UInt8 = 43 // "+"
+    static let dot: UInt8 = 46 // "."
+    static let zero: UInt8 = 48 // "0"
+
+    func integer<T: FixedWidthInteger>() -> T? {
+        var i = 0
+        var isNegative = false
+        if i < bytes.count && (bytes[i] == TdfValue.minus || bytes[i] == TdfValue.plus) {
+            isNegative = bytes[i] == TdfValue.minus
+            i += 1
+        }
+        guard i < bytes.count else { return nil }
+
+        // Negative values are accumulated downward, so that `T.min` can be parsed.
+        var value: T = 0
+        while i < bytes.count {
+            let digit = bytes[i] &- TdfValue.zero
+            guard digit < 10 else { return nil }
+            let (shifted, o1) = value.multipliedReportingOverflow(by: 10)
+            let (next, o2) = isNegative ? shifted.subtractingReportingOverflow(T(digit)) : shifted.addingReportingOverflow(T(digit))
+            guard !o1 && !o2 else { return nil }
+            value = next
+            i += 1
+        }
+        return value
+    }
+
+    /**
+     Plain decimals (eg. "-12.5") whose digits fit in 24 bits, with up to 10 of them fractional, are converted exactly here;
+     each is a single correctly rounded multiply or divide of two exact `Float`s. Anything else goes through `Float(_: String)`.
+     */
+    func float() -> Float? {
+        var i = 0
+        var isNegative = false
+        if i < bytes.count && (bytes[i] == TdfValue.minus || bytes[i] == TdfValue.plus) {
+            isNegative = bytes[i] == TdfValue.minus
+            i += 1
+        }
+
+        var mantissa: UInt32 = 0
+        var digits = 0
+        var fractionDigits = 0
+        var seenDot = false
+        while i < bytes.count {
+            let byte = bytes[i]
+            if byte == TdfValue.dot && !seenDot {
+                seenDot = true
+            }
+            else if byte &- TdfValue.zero < 10 {
+                mantissa = mantissa &* 10 &+ UInt32(byte &- TdfValue.zero)
+                digits += 1
+                if seenDot { fractionDigits += 1 }
+                if mantissa >= 1 << 24 || fractionDigits > 10 { return slowFloat() }
+            }
+            else {
+                return slowFloat()
+            }
+            i += 1
+        }
+        guard digits > 0 else { return slowFloat() }
+
+        let value = fractionDigits > 0 ? Float(mantissa) / TdfValue.powersOfTen[fractionDigits] : Float(mantissa)
+        return isNegative ? -value : value
+    }
+
+    static let powersOfTen: [Float] = [1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10]
+
+    func slowFloat() -> Float? {
+        return Float(TdfTokenizer.string(from: bytes))
+    }
+
+}
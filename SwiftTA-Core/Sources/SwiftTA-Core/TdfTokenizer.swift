@@ -0,0 +1,291 @@
+//
+//  TdfTokenizer.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+
+/**
+ A zero-copy tokenizer for TDF files (.tdf, .fbi, .ota, etc).
+
+ Tokens are byte ranges into the source buffer; nothing is copied and no `String` is created
+ unless asked for (see `string(_:)` and `matches(_:_:)`). Rather than stepping through the source a byte at a time,
+ the tokenizer scans 16 bytes at a time with SIMD for the next byte of structural interest
+ (`[`, `]`, `{`, `}`, `=`, `;`, `//` comments & whitespace) and skips everything in between.
+
+ The tokenizer only borrows its source, so it is only valid for as long as `bytes` is.
+ `TdfParser` is built on top of this and is the easier way to go for most uses.
+
+ The syntax is loose, just as TA's own parser is:
+
+     [SectionName]
+         {
+         key = value;
+         // A comment runs to the end of its line.
+         [SubSection] { ... }
+         }
+
+ Whitespace around keys & values is trimmed but any within them is kept; a key runs all the way to its `=` and
+ a value all the way to its `;`. Anything between a section's name and its `{` is ignored, as is anything
+ outside of a top-level section.
+ */
+public struct TdfTokenizer {
+
+    public enum Token: Equatable {
+        case objectBegin(name: Range<Int>)
+        case objectEnd(name: Range<Int>)
+        case property(key: Range<Int>, value: Range<Int>)
+    }
+
+    /// The source being tokenized.
+    public internal(set) var bytes: UnsafeRawBufferPointer
+
+    /// The offset in `bytes` of the next byte to be scanned.
+    public private(set) var position = 0
+
+    /// The names of the objects currently open; innermost last.
+    public private(set) var parents: [Range<Int>] = []
+
+    private var state = State.seekingSection
+    private var section = 0..<0
+    private var key = 0..<0
+
+    /// Tokenizes `bytes`; starting at `position`, which should be outside of any section (eg. at a top-level `[`).
+    public init(_ bytes: UnsafeRawBufferPointer, startingAt position: Int = 0) {
+        self.bytes = bytes
+        self.position = position
+        parents.reserveCapacity(4)
+    }
+
+    public var isAtEnd: Bool { return position >= bytes.count }
+
+    public var depth: Int { return parents.count }
+
+    /// Scans ahead to the next token; or returns nil if there are none left.
+    public mutating func next() -> Token? {
+        let count = bytes.count
+
+        while position < count {
+            switch state {
+
+            case .seekingSection:
+                guard let i = firstIndex(of: .sectionOrComment, from: position) else { return finish() }
+                if bytes[i] == Byte.sectionNameStart {
+                    beginSectionName(at: i)
+                }
+                else {
+                    position = isComment(at: i) ? endOfLine(from: i) : i + 1
+                }
+
+            case .readingSectionName:
+                guard let i = firstIndex(of: .sectionNameStop, from: position) else { return finish() }
+                section = section.lowerBound ..< i
+                position = i + 1
+                state = .seekingSectionStart
+
+            case .seekingSectionStart:
+                guard let i = firstIndex(of: .sectionBody, from: position) else { return finish() }
+                position = i + 1
+                if bytes[i] == Byte.sectionBodyStart {
+                    parents.append(section)
+                    state = .seekingKeyValue
+                    return .objectBegin(name: section)
+                }
+                else {
+                    return endObject(at: i)
+                }
+
+            case .seekingKeyValue:
+                guard let i = firstIndex(notOf: .whitespace, from: position) else { return finish() }
+                switch bytes[i] {
+                case Byte.sectionNameStart:
+                    beginSectionName(at: i)
+                case Byte.sectionBodyStop:
+                    position = i + 1
+                    return endObject(at: i)
+                case _ where isComment(at: i):
+                    position = endOfLine(from: i)
+                default:
+                    // The first byte is part of the key, whatever it is.
+                    key = i ..< i + 1
+                    position = i + 1
+                    state = .readingKey
+                }
+
+            case .readingKey:
+                guard let i = firstIndex(of: .keyValueSeparator, from: position) else { return finish() }
+                key = key.lowerBound ..< trimmingTrailingWhitespace(key.lowerBound ..< i).upperBound
+                position = i + 1
+                state = .readingValue
+
+            case .readingValue:
+                guard let i = firstIndex(of: .keyValueStop, from: position) else { return finish() }
+                let value = trimmingTrailingWhitespace(trimmingLeadingWhitespace(position ..< i))
+                position = i + 1
+                state = .seekingKeyValue
+                return .property(key: key, value: value)
+            }
+        }
+
+        return nil
+    }
+
+}
+
+// MARK:- Strings
+
+public extension TdfTokenizer {
+
+    /// The bytes of a token as a `String`. ASCII is by far the norm; any other byte is taken as ISO Latin 1.
+    func string(_ range: Range<Int>) -> String {
+        return TdfTokenizer.string(from: UnsafeRawBufferPointer(rebasing: bytes[range]))
+    }
+
+    /// Whether the bytes of a token exactly match `string`, without creating a `String` from them.
+    func matches(_ range: Range<Int>, _ string: String) -> Bool {
+        var string = string
+        return string.withUTF8 { $0.elementsEqual(UnsafeRawBufferPointer(rebasing: bytes[range])) }
+    }
+
+    /// The name of the innermost open object, if any.
+    var currentObject: String? {
+        return parents.last.map { string($0) }
+    }
+
+    static func string(from bytes: UnsafeRawBufferPointer) -> String {
+        if bytes.allSatisfy({ $0 < 0x80 }) {
+            return String(decoding: bytes, as: UTF8.self)
+        }
+        return String(bytes: bytes, encoding: .isoLatin1) ?? ""
+    }
+
+}
+
+// MARK:- Scanning
+
+private extension TdfTokenizer {
+
+    enum State {
+        case seekingSection
+        case readingSectionName
+        case seekingSectionStart
+        case seekingKeyValue
+        case readingKey
+        case readingValue
+    }
+
+    enum Byte {
+        static let sectionNameStart: UInt8 = 91 // "["
+        static let sectionBodyStart: UInt8 = 123 // "{"
+        static let sectionBodyStop: UInt8 = 125 // "}"
+        static let slash: UInt8 = 47 // "/"
+    }
+
+    /// There is nothing more to find; any unterminated token is dropped.
+    mutating func finish() -> Token? {
+        position = bytes.count
+        return nil
+    }
+
+    mutating func beginSectionName(at i: Int) {
+        section = i + 1 ..< i + 1
+        position = i + 1
+        state = .readingSectionName
+    }
+
+    mutating func endObject(at i: Int) -> Token {
+        let name = parents.popLast() ?? i ..< i
+        state = parents.isEmpty ? .seekingSection : .seekingKeyValue
+        return .objectEnd(name: name)
+    }
+
+    func isComment(at i: Int) -> Bool {
+        return bytes[i] == Byte.slash && i + 1 < bytes.count && bytes[i + 1] == Byte.slash
+    }
+
+    /// The offset just past the end of the line containing `i`.
+    func endOfLine(from i: Int) -> Int {
+        return firstIndex(of: .newline, from: i).map { $0 + 1 } ?? bytes.count
+    }
+
+    func trimmingLeadingWhitespace(_ range: Range<Int>) -> Range<Int> {
+        var start = range.lowerBound
+        while start < range.upperBound && ByteClass.whitespace.contains(bytes[start]) { start += 1 }
+        return start ..< range.upperBound
+    }
+
+    func trimmingTrailingWhitespace(_ range: Range<Int>) -> Range<Int> {
+        var end = range.upperBound
+        while end > range.lowerBound && ByteClass.whitespace.contains(bytes[end - 1]) { end -= 1 }
+        return range.lowerBound ..< end
+    }
+
+    func firstIndex(of byteClass: ByteClass, from start: Int) -> Int? {
+        return firstIndex(from: start, where: byteClass, matching: true)
+    }
+
+    func firstIndex(notOf byteClass: ByteClass, from start: Int) -> Int? {
+        return firstIndex(from: start, where: byteClass, matching: false)
+    }
+
+    /// The first offset, at or after `start`, of a byte that is (or isn't) in `byteClass`; checking 16 bytes at a time.
+    @inline(__always)
+    func firstIndex(from start: Int, where byteClass: ByteClass, matching: Bool) -> Int? {
+        let count = bytes.count
+        var i = start
+
+        if let base = bytes.baseAddress {
+            while count - i >= 16 {
+                var block = SIMD16<UInt8>()
+                withUnsafeMutableBytes(of: &block) { $0.copyMemory(from: UnsafeRawBufferPointer(start: base + i, count: 16)) }
+                let found = matching ? byteClass.matches(block) : .!byteClass.matches(block)
+                if any(found) {
+                    for lane in 0 ..< 16 where found[lane] { return i + lane }
+                }
+                i += 16
+            }
+        }
+
+        while i < count {
+            if byteClass.contains(bytes[i]) == matching { return i }
+            i += 1
+        }
+        return nil
+    }
+
+}
+
+/// A set of up to four bytes, for scanning.
+private struct ByteClass {
+
+    let a, b, c, d: UInt8
+
+    init(_ a: UInt8, _ b: UInt8? = nil, _ c: UInt8? = nil, _ d: UInt8? = nil) {
+        self.a = a
+        self.b = b ?? a
+        self.c = c ?? a
+        self.d = d ?? a
+    }
+
+    @inline(__always)
+    func contains(_ byte: UInt8) -> Bool {
+        return byte == a || byte == b || byte == c || byte == d
+    }
+
+    @inline(__always)
+    func matches(_ block: SIMD16<UInt8>) -> SIMDMask<SIMD16<UInt8>.MaskStorage> {
+        return (block .== a) .| (block .== b) .| (block .== c) .| (block .== d)
+    }
+
+    static let sectionOrComment = ByteClass(91, 47) // "[" "/"
+    static let sectionNameStop = ByteClass(93) // "]"
+    static let sectionBody = ByteClass(123, 125) // "{" "}"
+    static let keyValueSeparator = ByteClass(61) // "="
+    static let keyValueStop = ByteClass(59) // ";"
+    static let newline = ByteClass(10) // "\n"
+    static let whitespace = ByteClass(32, 10, 13, 9) // " " "\n" "\r" "\t"
+
+}
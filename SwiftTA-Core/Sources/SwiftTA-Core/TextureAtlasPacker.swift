@@ -14,7 +14,7 @@ public protocol PackableTexture {
     var size: Size2<Int> { get }
 }
 
-/// A namespace enum for the texture packing function, `pack()`.
+/// A namespace enum for the texture packing functions, `pack()` & `pack(_:maxPageSize:)`.
 /// The texture atlas is a container for several individual textures.
 /// `TextureAtlasPacker.pack()` computes the location for each given texture within the atlas.
 public enum TextureAtlasPacker {
@@ -29,64 +29,136 @@ public enum TextureAtlasPacker {
     /// Computes the location for each given texture within a containing texture atlas.
     /// Returns the computed locations within the atlas (in the same orders as the given `textures`),
     /// and the total size of the final atlas.
+    ///
+    /// The atlas is the smallest power-of-two size found that fits every texture; no texture is ever left out.
     public static func pack<Textures>(_ textures: Textures) -> (atlasSize: Size2<Int>, locations: [LocationRect])
         where Textures: Collection, Textures.Element: PackableTexture {
         
-        // Compute the total area of every texture to use as an approximate for how big an atlas we'll need.
-        let totalArea = textures.reduce(0) { $0 + $1.size.area }
+        let sizes = textures.map { $0.size }
+        let sorted = sortedForPacking(sizes)
         
-        // Step down the atlas size until we find an area that snuggly "fits" the totalArea.
-        var findSize = Size2<Int>(width: 1024,height: 1024)
-        while findSize.area > totalArea { findSize /= 2 }
-        let textureSize = findSize * 2
-        
-        let filler = RectFiller(size: textureSize)
-            
-        // Sort the input textures from largest to smallest.
-        // It's easier to fit the larger ones in first and then fill the smaller ones in around the edges.
-        let sorted = textures.enumerated().sorted(by: largestTexture)
-            
-        let locations = Array<LocationRect>(unsafeUninitializedCapacity: sorted.count) { buffer, count in
-            sorted.forEach { (e: IndexedTexture) in
-                if let rect = filler.findSuitableRect(ofSize: e.texture.size) {
-                    buffer[e.index] = rect
+        // Start from the smallest atlas that could possibly hold everything, and grow it until everything does fit.
+        var atlasSize = smallestAtlas(for: sizes)
+        attempt: while true {
+            var bin = MaxRectsBin(size: atlasSize)
+            var locations = [LocationRect](repeating: .zero, count: sizes.count)
+            for index in sorted where sizes[index].area > 0 {
+                guard let rect = bin.insert(sizes[index]) else {
+                    atlasSize = grow(atlasSize)
+                    continue attempt
                 }
-                else {
-                    buffer[e.index] = .zero
+                locations[index] = rect
+            }
+            return (atlasSize, locations)
+        }
+    }
+    
+    /// Where a texture landed in a multi-page packing.
+    public struct PageLocation {
+        /// The index of the page in `Packing.pages`.
+        public var page: Int
+        public var rect: LocationRect
+    }
+    
+    /// A single atlas texture of a multi-page packing.
+    public struct Page {
+        public var size: Size2<Int>
+        /// The number of pixels covered by textures.
+        public var usedArea: Int
+        /// The fraction of the page covered by textures.
+        public var occupancy: Double { return size.area > 0 ? Double(usedArea) / Double(size.area) : 0 }
+    }
+    
+    /// The result of `pack(_:maxPageSize:)`.
+    public struct Packing {
+        public var pages: [Page]
+        /// The location of each texture (in the same order as the given textures).
+        public var locations: [PageLocation]
+        /// The fraction of every page's pixels covered by textures.
+        public var occupancy: Double {
+            let total = pages.reduce(0) { $0 + $1.size.area }
+            return total > 0 ? Double(pages.reduce(0) { $0 + $1.usedArea }) / Double(total) : 0
+        }
+    }
+    
+    /**
+     Computes the location for each given texture across as many atlas pages, at most `maxPageSize` each, as it takes.
+     Textures spill onto an additional page when they no longer fit on any before it;
+     a texture bigger than `maxPageSize` gets a page of its own.
+     Every page is trimmed down to the smallest power-of-two size that still holds all of its textures.
+     */
+    public static func pack<Textures>(_ textures: Textures, maxPageSize: Size2<Int>) -> Packing
+        where Textures: Collection, Textures.Element: PackableTexture {
+        
+        let sizes = textures.map { $0.size }
+        var bins: [MaxRectsBin] = []
+        var locations = [PageLocation](repeating: PageLocation(page: 0, rect: .zero), count: sizes.count)
+        
+        placing: for index in sortedForPacking(sizes) where sizes[index].area > 0 {
+            let size = sizes[index]
+            for page in bins.indices {
+                if let rect = bins[page].insert(size) {
+                    locations[index] = PageLocation(page: page, rect: rect)
+                    continue placing
                 }
             }
-            count = sorted.count
+            
+            let pageSize = size.width <= maxPageSize.width && size.height <= maxPageSize.height ? maxPageSize : smallestAtlas(for: [size])
+            var bin = MaxRectsBin(size: pageSize)
+            locations[index] = PageLocation(page: bins.count, rect: bin.insert(size)!)
+            bins.append(bin)
         }
         
-        return (textureSize, locations)
+        let pages = bins.map { Page(size: $0.trimmedSize, usedArea: $0.usedArea) }
+        return Packing(pages: pages, locations: locations)
     }
     
     public static func copyPaletted(source: UnsafeRawBufferPointer, to destination: UnsafeMutableRawBufferPointer, sized size: Size2<Int>, at location: LocationRect, palette: Palette) {
+        guard let source = source.baseAddress, let destination = destination.baseAddress else { return }
         let bytesPerPixel = 4
         let pitch = size.width * bytesPerPixel
-        var sourceIndex = source.startIndex
-        for row in location.top ..< location.bottom {
-            for col in location.left ..< location.right {
-                let paletteIndex = source[sourceIndex]
-                let color = palette[paletteIndex]
-                let i = (row * pitch) + (col * bytesPerPixel)
-                destination[i+0] = color.red
-                destination[i+1] = color.green
-                destination[i+2] = color.blue
-                destination[i+3] = color.alpha
-                sourceIndex += 1
-            }
-        }
+        palette.expandIndices(source, bytesPerRow: location.width, size: Size2<Int>(width: location.width, height: location.height),
+                              into: destination + (location.top * pitch) + (location.left * bytesPerPixel), bytesPerRow: pitch)
     }
     
 }
 
 // MARK:- Utility
 
-private typealias IndexedTexture<Tex: PackableTexture> = (index: Int, texture: Tex)
-
-private func largestTexture<Tex: PackableTexture>(_ a: IndexedTexture<Tex>, _ b: IndexedTexture<Tex>) -> Bool {
-    return a.texture.size.area > b.texture.size.area
+extension TextureAtlasPacker {
+    
+    /// The indices of `sizes`, in the order they should be packed:
+    /// longest side first, then largest area; the big ones go in first and the smaller ones fill in around them.
+    static func sortedForPacking(_ sizes: [Size2<Int>]) -> [Int] {
+        return sizes.indices.sorted { a, b in
+            let (sa, sb) = (sizes[a], sizes[b])
+            let (longA, longB) = (max(sa.width, sa.height), max(sb.width, sb.height))
+            if longA != longB { return longA > longB }
+            if sa.area != sb.area { return sa.area > sb.area }
+            return a < b
+        }
+    }
+    
+    /// The smallest power-of-two atlas that has the area for all of `sizes` and is as wide & tall as the largest of them.
+    static func smallestAtlas(for sizes: [Size2<Int>]) -> Size2<Int> {
+        let totalArea = sizes.reduce(0) { $0 + $1.area }
+        var atlasSize = Size2<Int>(width: nextPowerOfTwo(sizes.reduce(1) { max($0, $1.width) }),
+                                   height: nextPowerOfTwo(sizes.reduce(1) { max($0, $1.height) }))
+        while atlasSize.area < totalArea { atlasSize = grow(atlasSize) }
+        return atlasSize
+    }
+    
+    /// Doubles the shorter side of `size`; keeping the atlas as square as possible.
+    static func grow(_ size: Size2<Int>) -> Size2<Int> {
+        var size = size
+        if size.height < size.width { size.height *= 2 } else { size.width *= 2 }
+        return size
+    }
+    
+    static func nextPowerOfTwo(_ value: Int) -> Int {
+        return Int(UInt64(max(value, 1)).nextPowerOfTwo)
+    }
+    
 }
 
 public extension TextureAtlasPacker.LocationRect {
@@ -94,6 +166,7 @@ public extension TextureAtlasPacker.LocationRect {
     var width: Int { return right - left }
     var height: Int { return bottom - top }
 }
+extension TextureAtlasPacker.LocationRect: Equatable { }
 extension TextureAtlasPacker.LocationRect: CustomStringConvertible {
     public var description: String { return "[left:\(left),top:\(top), right:\(right),bottom:\(bottom)]" }
 }
@@ -106,76 +179,99 @@ public extension TextureAtlasPacker.LocationRect {
     }
 }
 
-// MARK:- RectFiller
+// MARK:- MaxRects
 
-// This is an old packing algorithm I worte over a decade ago for nTA.
-// It is not optimal at all; but it produces decent results in decent time.
-// An optimal packer is NP-hard. But there are better algorithms out there.
-// Feel free to substitute a better one here.
-
-private class RectFiller {
+/**
+ A single atlas page, packed with the MaxRects algorithm (Jukka Jylänki's "A Thousand Ways to Pack the Bin").
+ 
+ The bin tracks every maximal free rectangle; these overlap one another, so a texture can be placed anywhere it fits.
+ Each texture goes in the free rectangle that leaves the shortest side leftover (the "best short side fit"),
+ which tends to pack the atlas much more densely than a guillotine split.
+ Textures are never rotated, since their texture coordinates assume they are upright.
+ */
+struct MaxRectsBin {
     
     typealias _Rect = TextureAtlasPacker.LocationRect
     
+    let size: Size2<Int>
+    private(set) var usedArea = 0
+    /// The bottom-right corner of everything placed so far.
+    private var extent = Size2<Int>.zero
+    private var freeRects: [_Rect]
+    
     init(size: Size2<Int>) {
-        rects = [_Rect(size)]
-        rects.reserveCapacity(32)
+        self.size = size
+        freeRects = [_Rect(size)]
+        freeRects.reserveCapacity(64)
     }
     
-    private var rects: [_Rect]
+    /// The smallest power-of-two size (no bigger than the bin itself) that holds everything placed so far.
+    var trimmedSize: Size2<Int> {
+        return Size2<Int>(width: min(TextureAtlasPacker.nextPowerOfTwo(extent.width), size.width),
+                          height: min(TextureAtlasPacker.nextPowerOfTwo(extent.height), size.height))
+    }
     
-    func findSuitableRect(ofSize size: Size2<Int>) -> _Rect? {
+    /// Places a texture of `textureSize` within the bin; if there is room for it.
+    mutating func insert(_ textureSize: Size2<Int>) -> _Rect? {
         
-        // Find the first rect where `size` would fit inside
-        guard let index = rects.firstIndex(where: { size.width <= $0.width && size.height <= $0.height })
-            else { return nil }
-        
-        // This rect can fit a rect of `size`
-        let found = rects[index]
-        
-        // We are done finding space for the new rect...
-        let result = _Rect(left: found.left,
-                           top: found.top,
-                           right: found.left + size.width,
-                           bottom: found.top + size.height)
+        var best: _Rect? = nil
+        var bestShortSide = Int.max
+        var bestLongSide = Int.max
+        for free in freeRects where textureSize.width <= free.width && textureSize.height <= free.height {
+            let leftoverWidth = free.width - textureSize.width
+            let leftoverHeight = free.height - textureSize.height
+            let shortSide = min(leftoverWidth, leftoverHeight)
+            let longSide = max(leftoverWidth, leftoverHeight)
+            if shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide) {
+                best = _Rect(left: free.left, top: free.top, right: free.left + textureSize.width, bottom: free.top + textureSize.height)
+                bestShortSide = shortSide
+                bestLongSide = longSide
+            }
+        }
         
-        // but now we need to adjust the `rects` to remove the newly taken space.
+        guard let placed = best else { return nil }
+        place(placed)
+        return placed
+    }
+    
+    /// Removes `placed` from the free space.
+    private mutating func place(_ placed: _Rect) {
+        usedArea += placed.width * placed.height
+        extent = Size2<Int>(width: max(extent.width, placed.right), height: max(extent.height, placed.bottom))
         
-        // If `result` exactly matches `found` then we can simply just remove `found` from `rects`.
-        if size.width == found.width && size.height == found.height {
-            rects.remove(at: index)
-        }
-        // If only the width dimension matches then we can adjust `found` in `rects` to subtract the taken space.
-        else if size.width == found.width {
-            var r = found
-            r.top += size.height
-            rects[index] = r
-        }
-        // If only the height dimension matches then we can adjust `found` in `rects` to subtract the taken space.
-        else if size.height == found.height {
-            var r = found
-            r.left += size.width
-            rects[index] = r
-        }
-        else {
-            // `result` is a smaller subrect within `found`.
-            // We'll need to split `founs into to rects:
-            // one the the left of `result`,
-            // and one under `result`.
-            
-            let split = _Rect(left: found.left + size.width,
-                              top: found.top,
-                              right: found.right,
-                              bottom: found.top + size.height)
-            
-            var r = found
-            r.top += size.height
-            rects[index] = r
-            
-            rects.insert(split, at: index)
+        // Every free rect overlapping `placed` is replaced by the (up to four) maximal rects around it.
+        var split: [_Rect] = []
+        freeRects.removeAll { free in
+            guard free.intersects(placed) else { return false }
+            if placed.left > free.left { split.append(_Rect(left: free.left, top: free.top, right: placed.left, bottom: free.bottom)) }
+            if placed.right < free.right { split.append(_Rect(left: placed.right, top: free.top, right: free.right, bottom: free.bottom)) }
+            if placed.top > free.top { split.append(_Rect(left: free.left, top: free.top, right: free.right, bottom: placed.top)) }
+            if placed.bottom < free.bottom { split.append(_Rect(left: free.left, top: placed.bottom, right: free.right, bottom: free.bottom)) }
+            return true
         }
         
-        return result
+        // Only the new rects can be redundant (ie. contained by another free rect);
+        // the untouched rects were maximal already and a split rect can never contain one of them.
+        var kept: [_Rect] = []
+        kept.reserveCapacity(split.count)
+        for (i, rect) in split.enumerated() {
+            let redundant = freeRects.contains { $0.contains(rect) }
+                || split.indices.contains { j in j != i && split[j].contains(rect) && (split[j] != rect || j < i) }
+            if !redundant { kept.append(rect) }
+        }
+        freeRects.append(contentsOf: kept)
+    }
+    
+}
+
+private extension TextureAtlasPacker.LocationRect {
+    
+    func intersects(_ other: TextureAtlasPacker.LocationRect) -> Bool {
+        return left < other.right && other.left < right && top < other.bottom && other.top < bottom
+    }
+    
+    func contains(_ other: TextureAtlasPacker.LocationRect) -> Bool {
+        return left <= other.left && top <= other.top && other.right <= right && other.bottom <= bottom
     }
     
 }
@@ -0,0 +1,305 @@
+//
+//  Trace.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+import SwiftTA_Ctypes
+
+/**
+ A lightweight, thread-safe tracer for finding out where load & frame time goes.
+
+ Record a span around some work with either
+
+     let span = Trace.begin("Load Map", category: "load")
+     defer { span.end() }
+
+ or
+
+     try Trace.span("Load Map", category: "load") { ... }
+
+ and numeric values over time with `Trace.counter(_:_:)`.
+
+ Nothing is recorded until tracing is enabled with `Trace.start()`; until then every call costs no more
+ than a check of `Trace.isEnabled`. Each thread records into its own buffer, so recording never contends with other threads.
+ The recorded events can be exported in the Chrome `trace_event` format (for chrome://tracing or Perfetto)
+ with `Trace.chromeTraceJSON()` or `Trace.write(to:)`.
+ */
+public enum Trace {
+
+    /// Whether events are currently being recorded.
+    public static var isEnabled: Bool {
+        @inline(__always) get { return swiftta_atomic_load_flag(enabled) }
+    }
+
+    /// Starts recording events. Any previously recorded events are discarded.
+    public static func start() {
+        registry.reset(origin: now())
+        swiftta_atomic_store_flag(enabled, true)
+    }
+
+    /// Stops recording events. Events recorded so far are kept for export.
+    public static func stop() {
+        swiftta_atomic_store_flag(enabled, false)
+    }
+
+    /**
+     Begins a span; the span is recorded when `end()` is called on the result.
+     The `detail` (eg. a file name) is included in the span's arguments.
+     */
+    @inline(__always)
+    public static func begin(_ name: StaticString, category: StaticString = "", detail: @autoclosure () -> String? = nil) -> Span {
+        guard isEnabled else { return Span() }
+        return Span(name: name, category: category, detail: detail(), start: now())
+    }
+
+    /// Records a span around `work`.
+    @inline(__always)
+    public static func span<T>(_ name: StaticString, category: StaticString = "", detail: @autoclosure () -> String? = nil, _ work: () throws -> T) rethrows -> T {
+        let span = begin(name, category: category, detail: detail())
+        defer { span.end() }
+        return try work()
+    }
+
+    /// Records the value of a counter at this point in time.
+    @inline(__always)
+    public static func counter(_ name: StaticString, _ value: Double) {
+        guard isEnabled else { return }
+        ThreadBuffer.current.append(Event(phase: .counter, name: name, category: "", detail: nil, timestamp: now(), duration: 0, value: value))
+    }
+
+    /// Records a single point in time.
+    @inline(__always)
+    public static func instant(_ name: StaticString, category: StaticString = "") {
+        guard isEnabled else { return }
+        ThreadBuffer.current.append(Event(phase: .instant, name: name, category: category, detail: nil, timestamp: now(), duration: 0, value: 0))
+    }
+
+    /**
+     A span of time being traced.
+     A `Span` begun while tracing is disabled records nothing when it ends.
+     */
+    public struct Span {
+        fileprivate let name: StaticString
+        fileprivate let category: StaticString
+        fileprivate let detail: String?
+        fileprivate let start: UInt64
+
+        fileprivate init() {
+            name = ""
+            category = ""
+            detail = nil
+            start = 0
+        }
+
+        fileprivate init(name: StaticString, category: StaticString, detail: String?, start: UInt64) {
+            self.name = name
+            self.category = category
+            self.detail = detail
+            self.start = start
+        }
+
+        @inline(__always)
+        public func end() {
+            guard start != 0, Trace.isEnabled else { return }
+            let end = Trace.now()
+            ThreadBuffer.current.append(Event(phase: .complete, name: name, category: category, detail: detail, timestamp: start, duration: end - start, value: 0))
+        }
+    }
+
+}
+
+// MARK:- Export
+
+public extension Trace {
+
+    /// Every event recorded so far, as a Chrome `trace_event` JSON document.
+    static func chromeTraceJSON() -> Data {
+        let pid = ProcessInfo.processInfo.processIdentifier
+        let origin = registry.origin
+        var json = "{\"traceEvents\":["
+        var first = true
+
+        func append(_ event: String) {
+            if !first { json += ",\n" }
+            json += event
+            first = false
+        }
+
+        for buffer in registry.buffers {
+            let (thread, events) = buffer.snapshot()
+            append("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":\(pid),\"tid\":\(buffer.id),\"args\":{\"name\":\(quoted(thread))}}")
+
+            for event in events {
+                let ts = microseconds(event.timestamp, from: origin)
+                var line = "{\"ph\":\"\(event.phase.rawValue)\",\"name\":\(quoted(event.name.description)),\"pid\":\(pid),\"tid\":\(buffer.id),\"ts\":\(ts)"
+                if !event.category.description.isEmpty {
+                    line += ",\"cat\":\(quoted(event.category.description))"
+                }
+                switch event.phase {
+                case .complete:
+                    line += ",\"dur\":\(microseconds(event.duration, from: 0))"
+                    if let detail = event.detail { line += ",\"args\":{\"detail\":\(quoted(detail))}" }
+                case .counter:
+                    line += ",\"args\":{\"value\":\(event.value)}"
+                case .instant:
+                    line += ",\"s\":\"t\""
+                }
+                append(line + "}")
+            }
+        }
+
+        json += "],\"displayTimeUnit\":\"ms\"}"
+        return Data(json.utf8)
+    }
+
+    /// Writes every event recorded so far to `url` as a Chrome `trace_event` JSON document.
+    static func write(to url: URL) throws {
+        try chromeTraceJSON().write(to: url, options: .atomic)
+    }
+
+    private static func microseconds(_ time: UInt64, from base: UInt64) -> String {
+        let ns = time >= base ? time - base : 0
+        return String(format: "%.3f", Double(ns) / 1000)
+    }
+
+    private static func quoted(_ string: String) -> String {
+        var escaped = "\""
+        for scalar in string.unicodeScalars {
+            switch scalar {
+            case "\"": escaped += "\\\""
+            case "\\": escaped += "\\\\"
+            case "\n": escaped += "\\n"
+            case "\t": escaped += "\\t"
+            case _ where scalar.value < 0x20: escaped += String(format: "\\u%04x", scalar.value)
+            default: escaped.unicodeScalars.append(scalar)
+            }
+        }
+        return escaped + "\""
+    }
+
+}
+
+// MARK:- Recording
+
+private extension Trace {
+
+    /// Read from every thread that records an event; so it is only ever accessed atomically.
+    static let enabled: UnsafeMutablePointer<Bool> = {
+        let flag = UnsafeMutablePointer<Bool>.allocate(capacity: 1)
+        flag.initialize(to: false)
+        return flag
+    }()
+
+    static let registry = Registry()
+
+    @inline(__always)
+    static func now() -> UInt64 {
+        return DispatchTime.now().uptimeNanoseconds
+    }
+
+    struct Event {
+        enum Phase: Character {
+            case complete = "X"
+            case counter = "C"
+            case instant = "i"
+        }
+        var phase: Phase
+        var name: StaticString
+        var category: StaticString
+        var detail: String?
+        var timestamp: UInt64
+        var duration: UInt64
+        var value: Double
+    }
+
+    /// The events recorded by a single thread.
+    final class ThreadBuffer {
+
+        let id: Int
+        private let name: String
+        private var events: [Event] = []
+        // Only ever contended while exporting.
+        private let lock = NSLock()
+
+        private static let key = "SwiftTA.TraceBuffer"
+
+        init(id: Int, name: String) {
+            self.id = id
+            self.name = name
+            events.reserveCapacity(1024)
+        }
+
+        static var current: ThreadBuffer {
+            let thread = Thread.current
+            if let buffer = thread.threadDictionary[key] as? ThreadBuffer {
+                return buffer
+            }
+            let buffer = Trace.registry.makeBuffer(for: thread)
+            thread.threadDictionary[key] = buffer
+            return buffer
+        }
+
+        func append(_ event: Event) {
+            lock.lock()
+            events.append(event)
+            lock.unlock()
+        }
+
+        func snapshot() -> (name: String, events: [Event]) {
+            lock.lock()
+            defer { lock.unlock() }
+            return (name, events)
+        }
+
+        func removeAll() {
+            lock.lock()
+            events.removeAll(keepingCapacity: true)
+            lock.unlock()
+        }
+
+    }
+
+    /// Every thread's buffer, and the time recording started; for export.
+    final class Registry {
+
+        private let lock = NSLock()
+        private var all: [ThreadBuffer] = []
+        private var start: UInt64 = 0
+
+        var buffers: [ThreadBuffer] {
+            lock.lock()
+            defer { lock.unlock() }
+            return all
+        }
+
+        /// The time at which recording (last) started; every exported timestamp is relative to it.
+        var origin: UInt64 {
+            lock.lock()
+            defer { lock.unlock() }
+            return start
+        }
+
+        func makeBuffer(for thread: Thread) -> ThreadBuffer {
+            lock.lock()
+            defer { lock.unlock() }
+            let id = all.count + 1
+            let name = thread.isMainThread ? "Main Thread" : (thread.name.flatMap { $0.isEmpty ? nil : $0 } ?? "Thread \(id)")
+            let buffer = ThreadBuffer(id: id, name: name)
+            all.append(buffer)
+            return buffer
+        }
+
+        func reset(origin: UInt64) {
+            buffers.forEach { $0.removeAll() }
+            lock.lock()
+            start = origin
+            lock.unlock()
+        }
+
+    }
+
+}
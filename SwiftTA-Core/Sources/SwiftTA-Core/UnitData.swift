@@ -15,11 +15,15 @@ public struct UnitData {
 }
 
 public extension UnitData {
-    init(loading unitInfo: UnitInfo, from filesystem: FileSystem) throws {
+    /// Loads the unit's model & script; through `bakeCache` if one is given.
+    init(loading unitInfo: UnitInfo, from filesystem: FileSystem, bakeCache: AssetBakeCache? = nil) throws {
+        let span = Trace.begin("Load Unit", category: "load", detail: unitInfo.name)
+        defer { span.end() }
+        
         info = unitInfo
         let modelFile = try filesystem.openFile(at: "objects3d/" + unitInfo.object + ".3DO")
-        model = try UnitModel(contentsOf: modelFile)
+        model = try bakeCache?.model(contentsOf: modelFile) ?? UnitModel(contentsOf: modelFile)
         let scriptFile = try filesystem.openFile(at: "scripts/" + unitInfo.object + ".COB")
-        script = try UnitScript(contentsOf: scriptFile)
+        script = try bakeCache?.script(contentsOf: scriptFile) ?? UnitScript(contentsOf: scriptFile)
     }
 }
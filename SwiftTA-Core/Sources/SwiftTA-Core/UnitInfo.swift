@@ -61,50 +61,67 @@ public struct UnitInfo {
 public extension UnitInfo {
     
     init(contentsOf file: FileSystem.FileHandle) throws {
+        let span = Trace.begin("Load FBI", category: "load", detail: file.file.name)
+        defer { span.end() }
         
-        let info: TdfParser.Object = {
-            let parser = TdfParser(file)
-            parser.skipToObject(named: "UNITINFO")
-            return parser.extractObject(normalizeKeys: true)
-        }()
-        
-        name = try info.requiredStringProperty("unitname")
-        object = try info.requiredStringProperty("objectname")
-        side = try info.requiredStringProperty("side")
-        title = try info.requiredStringProperty("name")
-        description = try info.requiredStringProperty("description")
-        categories = Set(try info.requiredStringProperty("category").components(separatedBy: " "))
-        tedClass = try info.requiredStringProperty("tedclass")
-        corpse = info["corpse"]
-        
-        let footprintX = try info.requiredStringProperty("footprintx")
-        let footprintZ = try info.requiredStringProperty("footprintz")
-        footprint = Size2<Int>(width: Int(footprintX) ?? 1, height: Int(footprintZ) ?? 1)
-        
-        capabilities = .defaults
-        
-        if info.boolProperty("canmove") { capabilities.update(with: .move) }
-        if info.boolProperty("canstop") { capabilities.update(with: .stop) }
-        if info.boolProperty("canattack") { capabilities.update(with: .attack) }
-        if info.boolProperty("canguard") { capabilities.update(with: .guard) }
-        if info.boolProperty("canpatrol") { capabilities.update(with: .move) }
-        if info.boolProperty("canreclamate") { capabilities.update(with: .stop) }
-        if info.boolProperty("canload") { capabilities.update(with: .load) }
-        if info.boolProperty("onoffable") { capabilities.update(with: .onoffable) }
-        
-        if info.boolProperty("activatewhenbuilt") { capabilities.update(with: .activateWhenBuilt) }
-        
-        if info.boolProperty("builder") { capabilities.update(with: .builder) }
-        if info.boolProperty("canfly") { capabilities.update(with: .flying) }
-        if info.boolProperty("floater") { capabilities.update(with: .floater) }
-        if info.boolProperty("canhover") { capabilities.update(with: .hover) }
-        if info.boolProperty("tidalgenerator") { capabilities.update(with: .tidalGenerator) }
-        if info.boolProperty("istargetingupgrade") { capabilities.update(with: .targeting) }
-        
-        acceleration = info.numericProperty("acceleration")
-        maxVelocity = info.numericProperty("maxvelocity")
-        brakeRate = info.numericProperty("brakerate")
-        turnRate = (info.numericProperty("turnrate") / ANGULAR_CONSTANT) * (GameFloat.pi / 180.0)
+        let parser = TdfParser(file)
+        parser.skipToObject(named: "UNITINFO")
+        
+        self.init(acceleration: 0, maxVelocity: 0, brakeRate: 0, turnRate: 0)
+        try parser.decodeObject(into: &self, using: UnitInfo.schema)
+    }
+    
+}
+
+private extension UnitInfo {
+    
+    /// The properties of an FBI's [UNITINFO] that are loaded; see `init(contentsOf:)`.
+    static let schema = TdfSchema<UnitInfo>([
+        .field("unitname", required: true) { $0.name = $1.string },
+        .field("objectname", required: true) { $0.object = $1.string },
+        .field("side", required: true) { $0.side = $1.string },
+        .field("name", required: true) { $0.title = $1.string },
+        .field("description", required: true) { $0.description = $1.string },
+        .field("category", required: true) { $0.categories = Set($1.string.components(separatedBy: " ")) },
+        .field("tedclass", required: true) { $0.tedClass = $1.string },
+        .field("corpse") { $0.corpse = $1.string },
+        
+        .field("footprintx", required: true) { $0.footprint.width = $1.integer(default: 1) },
+        .field("footprintz", required: true) { $0.footprint.height = $1.integer(default: 1) },
+        
+        .capability("canmove", .move),
+        .capability("canstop", .stop),
+        .capability("canattack", .attack),
+        .capability("canguard", .guard),
+        .capability("canpatrol", .patrol),
+        .capability("canreclamate", .reclamate),
+        .capability("canload", .load),
+        .capability("onoffable", .onoffable),
+        
+        .capability("activatewhenbuilt", .activateWhenBuilt),
+        
+        .capability("builder", .builder),
+        .capability("canfly", .flying),
+        .capability("floater", .floater),
+        .capability("canhover", .hover),
+        .capability("tidalgenerator", .tidalGenerator),
+        .capability("istargetingupgrade", .targeting),
+        
+        .field("acceleration") { $0.acceleration = $1.float(default: 0) },
+        .field("maxvelocity") { $0.maxVelocity = $1.float(default: 0) },
+        .field("brakerate") { $0.brakeRate = $1.float(default: 0) },
+        .field("turnrate") { $0.turnRate = ($1.float(default: 0) / ANGULAR_CONSTANT) * (GameFloat.pi / 180.0) },
+    ])
+    
+}
+
+private extension TdfSchema.Field where Target == UnitInfo {
+    
+    static func capability(_ key: String, _ capability: UnitInfo.Capabilities) -> TdfSchema.Field {
+        return .field(key) { info, value in
+            if value.bool(default: false) { info.capabilities.insert(capability) }
+            else { info.capabilities.remove(capability) }
+        }
     }
     
 }
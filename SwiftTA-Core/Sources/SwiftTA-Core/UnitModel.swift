@@ -29,18 +29,29 @@ public struct UnitModel {
     public init<File>(contentsOf file: File) throws
         where File: FileReadHandle
     {
+        let span = Trace.begin("Load 3DO", category: "load")
+        defer { span.end() }
+        
         let fileData = file.readDataToEndOfFile()
         let model = fileData.withUnsafeBytes { UnitModel.loadModel(from: $0) }
         
         //UnitModel.dump(model)
         
-        pieces = model.pieces
-        primitives = model.primitives
-        vertices = model.vertices
-        textures = model.textures
-        
-        root = model.roots.first!
-        groundPlate = model.groundPlate
+        self.init(pieces: model.pieces,
+                  primitives: model.primitives,
+                  vertices: model.vertices,
+                  textures: model.textures,
+                  root: model.roots.first!,
+                  groundPlate: model.groundPlate)
+    }
+    
+    init(pieces: Pieces, primitives: Primitives, vertices: Vertices, textures: Textures, root: Pieces.Index, groundPlate: Primitives.Index) {
+        self.pieces = pieces
+        self.primitives = primitives
+        self.vertices = vertices
+        self.textures = textures
+        self.root = root
+        self.groundPlate = groundPlate
         
         var names: [String: Pieces.Index] = [:]
         for (index, piece) in pieces.enumerated() {
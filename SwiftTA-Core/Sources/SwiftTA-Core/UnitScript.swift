@@ -22,20 +22,31 @@ public struct UnitScript {
     public init<File>(contentsOf file: File) throws
         where File: FileReadHandle
     {
+        let span = Trace.begin("Load COB", category: "load")
+        defer { span.end() }
+        
         let fileData = file.readDataToEndOfFile()
         let script = fileData.withUnsafeBytes { UnitScript.loadScript(from: $0) }
         
-        code = script.code
-        modules = zip(script.moduleNames, script.moduleOffsets).map(Module.init)
-        numberOfStaticVariables = script.staticCount
-        pieces = script.pieceNames
-        
+        var modules = zip(script.moduleNames, script.moduleOffsets).map(Module.init)
         for moduleIndex in modules.indices {
             var codeIndex = Int(modules[moduleIndex].offset)
             var count = 0
-            while (code[codeIndex] == Opcode.stackAllocate.rawValue) { count += 1; codeIndex += 1 }
+            while (script.code[codeIndex] == Opcode.stackAllocate.rawValue) { count += 1; codeIndex += 1 }
             modules[moduleIndex].localCount = count
         }
+        
+        self.init(modules: modules,
+                  code: script.code,
+                  numberOfStaticVariables: script.staticCount,
+                  pieces: script.pieceNames)
+    }
+    
+    init(modules: [Module], code: Code, numberOfStaticVariables: Int, pieces: [String]) {
+        self.modules = modules
+        self.code = code
+        self.numberOfStaticVariables = numberOfStaticVariables
+        self.pieces = pieces
     }
     
     public struct Module {
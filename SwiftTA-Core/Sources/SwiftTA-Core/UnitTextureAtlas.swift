@@ -35,6 +35,12 @@ public class UnitTextureAtlas {
         (size, textures) = UnitTextureAtlas.pack(content)
     }
     
+    /// An atlas of textures already placed within a texture of `size`; see `IncrementalUnitTextureAtlas`.
+    init(size: Size2<Int>, textures: [Texture]) {
+        self.size = size
+        self.textures = textures
+    }
+    
     public func build(from filesystem: FileSystem, using palette: Palette) -> Data {
         
         let bytesPerPixel = 4
@@ -48,6 +54,25 @@ public class UnitTextureAtlas {
         return Data(bytesNoCopy: bytes, count: byteCount, deallocator: .custom({ (p, i) in p.deallocate() }))
     }
     
+    /// Builds the atlas as 8-bit palette indices (one byte per pixel), to be drawn through a palette lookup;
+    /// see `Palette.lookupTable(layout:)`.
+    public func buildIndices(from filesystem: FileSystem) -> Data {
+        
+        var indices = Data(count: size.area)
+        indices.withUnsafeMutableBytes { (bytes: UnsafeMutableRawBufferPointer) in
+            textures.forEach {
+                UnitTextureAtlas.copyIndices(texture: $0, to: bytes.baseAddress!.assumingMemoryBound(to: UInt8.self), of: size, filesystem: filesystem)
+            }
+        }
+        return indices
+    }
+    
+    /// The fraction of the atlas covered by its textures.
+    public var occupancy: Double {
+        guard size.area > 0 else { return 0 }
+        return Double(textures.reduce(0) { $0 + $1.location.width * $1.location.height }) / Double(size.area)
+    }
+    
     public func textureCoordinates(for index: Int) -> (Vertex2f, Vertex2f, Vertex2f, Vertex2f) {
         
         let texture = textures[index]
@@ -66,7 +91,7 @@ public class UnitTextureAtlas {
     
 }
 
-private extension UnitTextureAtlas {
+extension UnitTextureAtlas {
     
     class func copy(texture: Texture,
                     to bytes: UnsafeMutablePointer<UInt8>,
@@ -79,36 +104,45 @@ private extension UnitTextureAtlas {
         
         switch texture.content {
         case .color(let paletteIndex):
-            let color = palette[paletteIndex]
+            let color = palette.pixel(at: paletteIndex)
+            for row in texture.location.top ..< texture.location.bottom {
+                UnsafeMutableRawPointer(bytes + (row * pitch) + (texture.location.left * bytesPerPixel))
+                    .initializeMemory(as: UInt32.self, repeating: color, count: texture.location.width)
+            }
+        case .gafItem(let gaf):
+            // The frame is decoded (and expanded through the palette) straight into its spot in the atlas.
+            guard let file = try? filesystem.openFile(gaf.file) else { return }
+            let origin = texture.location.top * pitch + texture.location.left * bytesPerPixel
+            let destination = GafItem.FrameDestination(pixels: UnsafeMutableRawPointer(bytes + origin), bytesPerRow: pitch, format: .rgba(palette))
+            _ = try? gaf.item.decodeFrame(index: 0, from: file, into: destination)
+        case .notFound:
+            ()
+        }
+    }
+    
+    /// Copies the texture's palette indices into an atlas of one byte per pixel.
+    class func copyIndices(texture: Texture,
+                           to bytes: UnsafeMutablePointer<UInt8>,
+                           of size: Size2<Int>,
+                           filesystem: FileSystem) {
+        
+        let pitch = size.width
+        
+        switch texture.content {
+        case .color(let paletteIndex):
             for row in texture.location.top ..< texture.location.bottom {
-                for col in texture.location.left ..< texture.location.right {
-                    let i = (row * pitch) + (col * bytesPerPixel)
-                    bytes[i+0] = color.red
-                    bytes[i+1] = color.green
-                    bytes[i+2] = color.blue
-                    bytes[i+3] = color.alpha
-                }
+                (bytes + (row * pitch) + texture.location.left).initialize(repeating: UInt8(truncatingIfNeeded: paletteIndex), count: texture.location.width)
             }
         case .gafItem(let gaf):
-            let file = try! filesystem.openFile(gaf.file)
-            let offsetToFrameData = gaf.item.frameOffsets[0]
-            if let frame = try? GafItem.extractFrame(from: file, at: offsetToFrameData) {
-                frame.data.withUnsafeBytes { (source: UnsafeRawBufferPointer) in
-                    var sourceIndex = source.startIndex
-                    for row in texture.location.top ..< texture.location.bottom {
-                        for col in texture.location.left ..< texture.location.right {
-                            let paletteIndex = source[sourceIndex]
-                            let color = palette[paletteIndex]
-                            let i = (row * pitch) + (col * bytesPerPixel)
-                            bytes[i+0] = color.red
-                            bytes[i+1] = color.green
-                            bytes[i+2] = color.blue
-                            bytes[i+3] = color.alpha
-                            sourceIndex += 1
-                        }
-                    }
-                }
+            guard let file = try? filesystem.openFile(gaf.file) else { return }
+            // Only paletted frames can be kept as indices; 16-bit frames would overrun their spot.
+            guard let frame = try? gaf.item.readFrameMetadata(atIndex: 0, from: file), frame.format == .paletteIndex else {
+                print("!!! Texture \(gaf.item.name) is not paletted; it can't be drawn as palette indices.")
+                return
             }
+            let origin = texture.location.top * pitch + texture.location.left
+            let destination = GafItem.FrameDestination(pixels: UnsafeMutableRawPointer(bytes + origin), bytesPerRow: pitch, format: .native)
+            _ = try? gaf.item.decodeFrame(index: 0, from: file, into: destination)
         case .notFound:
             ()
         }
@@ -122,7 +156,7 @@ private extension UnitTextureAtlas.Texture {
     }
 }
 
-private extension UnitTextureAtlas {
+extension UnitTextureAtlas {
     
     class func content(for modelTextures: [UnitModel.Texture], from texPack: ModelTexturePack) -> [Content] {
         
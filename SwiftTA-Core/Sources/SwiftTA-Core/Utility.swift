@@ -88,6 +88,21 @@ extension UnsafeRawBufferPointer.SubSequence {
     }
 }
 
+extension SIMD {
+    
+    /// Loads a vector from `pointer`, which need not be aligned. (Meant for the power-of-two sized vectors.)
+    @inline(__always) init(unalignedFrom pointer: UnsafeRawPointer) {
+        self.init()
+        withUnsafeMutableBytes(of: &self) { $0.copyMemory(from: UnsafeRawBufferPointer(start: pointer, count: $0.count)) }
+    }
+    
+    /// Stores this vector to `pointer`, which need not be aligned. (Meant for the power-of-two sized vectors.)
+    @inline(__always) func storeUnaligned(to pointer: UnsafeMutableRawPointer) {
+        withUnsafeBytes(of: self) { pointer.copyMemory(from: $0.baseAddress!, byteCount: $0.count) }
+    }
+    
+}
+
 public func +<Pointee>(lhs: UnsafePointer<Pointee>, rhs: UInt32) -> UnsafePointer<Pointee> {
     return lhs + Int(rhs)
 }
@@ -263,6 +278,63 @@ public extension Int {
     
 }
 
+// MARK:- Concurrency
+
+extension DispatchQueue {
+    
+    /**
+     A throwing variant of `concurrentPerform(iterations:execute:)`.
+     Every iteration is run, even if some throw; afterwards the error from the lowest failed iteration (if any) is rethrown.
+     */
+    static func concurrentPerform(iterations: Int, executeThrowing work: (Int) throws -> Void) throws {
+        guard iterations > 1 else {
+            if iterations == 1 { try work(0) }
+            return
+        }
+        
+        let errors = UnsafeMutableBufferPointer<Error?>.allocate(capacity: iterations)
+        errors.initialize(repeating: nil)
+        defer {
+            errors.baseAddress!.deinitialize(count: iterations)
+            errors.deallocate()
+        }
+        
+        concurrentPerform(iterations: iterations) { index in
+            do { try work(index) }
+            catch { errors[index] = error }
+        }
+        
+        if let error = errors.lazy.compactMap({ $0 }).first {
+            throw error
+        }
+    }
+    
+}
+
+extension RandomAccessCollection where Index == Int {
+    
+    /**
+     Returns the results of applying `transform` to every element, computed concurrently.
+     The work is spread over `DispatchQueue.concurrentPerform`, so at most one element per active core is in flight at a time.
+     The results are in the same order as the collection, regardless of the order in which they complete.
+     */
+    func concurrentMap<T>(_ transform: (Element) throws -> T) throws -> [T] {
+        let results = UnsafeMutableBufferPointer<T?>.allocate(capacity: count)
+        results.initialize(repeating: nil)
+        defer {
+            results.baseAddress?.deinitialize(count: results.count)
+            results.deallocate()
+        }
+        
+        try DispatchQueue.concurrentPerform(iterations: count) { (i: Int) in
+            results[i] = try transform(self[startIndex + i])
+        }
+        
+        return results.map { $0! }
+    }
+    
+}
+
 // MARK:- Thin Value Wrappers
 
 /**
@@ -0,0 +1,304 @@
+//
+//  gaf+Decode.swift
+//  SwiftTA-Core
+//
+//  Created by Logan Jones on 10/15/26.
+//  Copyright © 2026 Logan Jones. All rights reserved.
+//
+
+import Foundation
+import SwiftTA_Ctypes
+
+// MARK:- Direct Decoding
+
+public extension GafItem {
+
+    /**
+     A rectangle of some larger image (a texture atlas, a texture upload buffer, etc) for a frame to be decoded into.
+
+     `pixels` points at the rectangle's top-left pixel and `bytesPerRow` is the stride of the whole image.
+     The rectangle must be (at least) as big as the frame; see `readFrameMetadata(atIndex:from:)`.
+     */
+    struct FrameDestination {
+        public var pixels: UnsafeMutableRawPointer
+        public var bytesPerRow: Int
+        public var format: Format
+
+        public enum Format {
+            /// Pixels are written just as the GAF has them: 8-bit palette indices, or 16-bit colors (see `FrameMetadata.format`).
+            case native
+            /// Pixels are expanded to 32-bit RGBA; palette indices through the given palette.
+            case rgba(Palette)
+        }
+
+        public init(pixels: UnsafeMutableRawPointer, bytesPerRow: Int, format: Format) {
+            self.pixels = pixels
+            self.bytesPerRow = bytesPerRow
+            self.format = format
+        }
+    }
+
+    /**
+     Decodes a frame straight into `destination`; composited from its subframes if it has any.
+     This is the same image as `extractFrame(index:from:)`, without any intermediate `Data`.
+     */
+    @discardableResult
+    func decodeFrame<File>(index: Int, from gaf: File, into destination: FrameDestination) throws -> FrameMetadata
+        where File: FileReadHandle
+    {
+        guard frameOffsets.indices.contains(index) else { throw GafLoadError.outOfBoundsFrameIndex }
+        return try Self.decodeFrame(from: gaf, at: frameOffsets[index], into: destination)
+    }
+
+    @discardableResult
+    static func decodeFrame<File>(from gaf: File, at offset: Int, into destination: FrameDestination) throws -> FrameMetadata
+        where File: FileReadHandle
+    {
+        gaf.seek(toFileOffset: offset)
+        let frame = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
+        guard let encoding = GafFrameEncoding(rawValue: frame.encoding)
+            else { throw GafLoadError.unknownFrameEncoding(frame.encoding) }
+
+        let writer = FrameWriter(destination, size: frame.size, format: encoding.pixelFormat)
+        if frame.numberOfSubFrames > 0 || encoding == .taRunLengthEncoding {
+            writer.clear()
+        }
+
+        if frame.numberOfSubFrames == 0 {
+            try decode(frame, from: gaf, with: writer, at: .zero, overlaying: false)
+        }
+        else {
+            gaf.seek(toFileOffset: frame.offsetToFrameData)
+            let subframeOffsets = try gaf.readArray(ofType: UInt32.self, count: Int(frame.numberOfSubFrames))
+
+            for subframeOffset in subframeOffsets {
+                gaf.seek(toFileOffset: subframeOffset)
+                let subframe = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
+                guard let subframeEncoding = GafFrameEncoding(rawValue: subframe.encoding)
+                    else { throw GafLoadError.unknownFrameEncoding(subframe.encoding) }
+                guard subframeEncoding.pixelFormat == encoding.pixelFormat else {
+                    print("!!! Subframes with differing pixel formats not supported.")
+                    continue
+                }
+                try decode(subframe, from: gaf, with: writer, at: frame.offset &- subframe.offset, overlaying: true)
+            }
+        }
+
+        return FrameMetadata(frame)
+    }
+
+}
+
+extension GafItem {
+
+    /**
+     Decodes a (sub)frame's pixels into `writer`, placing its top-left pixel at `origin`.
+     An `overlaying` subframe only writes its opaque pixels (any nonzero palette index) and is clipped to the writer's bounds.
+     */
+    static func decode<File>(_ frame: TA_GAF_FRAME_DATA, from gaf: File, with writer: FrameWriter, at origin: Point2<Int>, overlaying: Bool) throws
+        where File: FileReadHandle
+    {
+        guard frame.numberOfSubFrames == 0 else { throw GafLoadError.unexpectedSubframes }
+        guard let encoding = GafFrameEncoding(rawValue: frame.encoding)
+            else { throw GafLoadError.unknownFrameEncoding(frame.encoding) }
+
+        gaf.seek(toFileOffset: frame.offsetToFrameData)
+        let size = frame.size
+
+        switch encoding {
+        case .taUncompressed, .takUncompressed4444, .takUncompressed1555:
+            let bytesPerRow = size.width * encoding.pixelLength
+            let data = try gaf.readData(verifyingLength: size.height * bytesPerRow)
+            data.withUnsafeBytes { (input: UnsafeRawBufferPointer) in
+                guard let base = input.baseAddress else { return }
+                for y in 0 ..< size.height {
+                    writer.copy(base + y * bytesPerRow, count: size.width, x: origin.x, y: origin.y + y, skippingZeros: overlaying)
+                }
+            }
+        case .taRunLengthEncoding:
+            let data = gaf.readData(ofLength: size.area * 2)
+            data.withUnsafeBytes { (input: UnsafeRawBufferPointer) in
+                decodeRunLengthEncoded(input, size: size, with: writer, at: origin, overlaying: overlaying)
+            }
+        }
+    }
+
+    /**
+     TA's run-length encoding is line by line: each line is a 16-bit byte count followed by a series of runs,
+     each led by a control byte. Any pixels of a line past its last run are transparent.
+     */
+    static func decodeRunLengthEncoded(_ input: UnsafeRawBufferPointer, size: Size2<Int>, with writer: FrameWriter, at origin: Point2<Int>, overlaying: Bool) {
+        guard let base = input.baseAddress else { return }
+        let end = input.count
+        var line = 0
+
+        for lineNo in 0 ..< size.height {
+
+            guard line + 2 <= end else { break }
+            let lineLength = Int(base.load(fromByteOffset: line, as: UInt8.self)) | Int(base.load(fromByteOffset: line + 1, as: UInt8.self)) << 8
+            guard lineLength <= size.width * 2 else {
+                print("!!! Warning, bad line length detected while decompressing GAF frame. [line: \(lineNo+1), length: \(lineLength)]")
+                break
+            }
+
+            let y = origin.y + lineNo
+            var i = line + 2
+            let lineEnd = min(i + lineLength, end)
+            var x = 0
+
+            while i < lineEnd && x < size.width {
+                let control = base.load(fromByteOffset: i, as: UInt8.self)
+                i += 1
+
+                if control & 1 == 1 {
+                    // A run of transparent pixels; the rest of the byte is the length of the run.
+                    // The destination was cleared beforehand (or is being overlaid), so there is nothing to write.
+                    x += Int(control >> 1)
+                }
+                else if control & 2 == 2 {
+                    // A run of a single color; the rest of the byte is the length of the run (less one) and the next byte is the color.
+                    guard i < lineEnd else { break }
+                    let color = base.load(fromByteOffset: i, as: UInt8.self)
+                    i += 1
+                    let count = min(Int(control >> 2) + 1, size.width - x)
+                    if color != 0 || !overlaying {
+                        writer.fill(color, count: count, x: origin.x + x, y: y)
+                    }
+                    x += count
+                }
+                else {
+                    // A direct copy of some pixels; the rest of the byte is the number of pixels (less one).
+                    let count = min(Int(control >> 2) + 1, size.width - x, lineEnd - i)
+                    writer.copy(base + i, count: count, x: origin.x + x, y: y, skippingZeros: overlaying)
+                    i += count
+                    x += count
+                }
+            }
+
+            line += 2 + lineLength
+        }
+    }
+
+}
+
+// MARK:- Writing
+
+/// Writes spans of decoded GAF pixels into a `FrameDestination`, clipped to the frame's size & converted as needed.
+struct FrameWriter {
+
+    let pixels: UnsafeMutableRawPointer
+    let bytesPerRow: Int
+    let size: Size2<Int>
+    let format: GafItem.Frame.PixelFormat
+
+    /// Each palette index's RGBA color, when expanding paletted pixels.
+    let colors: PaletteExpansion?
+    /// Whether 16-bit pixels are expanded to RGBA.
+    let expands: Bool
+
+    init(_ destination: GafItem.FrameDestination, size: Size2<Int>, format: GafItem.Frame.PixelFormat) {
+        pixels = destination.pixels
+        bytesPerRow = destination.bytesPerRow
+        self.size = size
+        self.format = format
+        switch destination.format {
+        case .native:
+            colors = nil
+            expands = false
+        case .rgba(let palette):
+            colors = format == .paletteIndex ? PaletteExpansion(palette) : nil
+            expands = true
+        }
+    }
+
+    var destinationPixelLength: Int { return expands ? 4 : format.pixelLength }
+
+    /// Fills the whole frame with its transparent pixel (ie. palette index 0, or a 16-bit 0).
+    func clear() {
+        guard let colors = colors else {
+            for y in 0 ..< size.height {
+                (pixels + y * bytesPerRow).initializeMemory(as: UInt8.self, repeating: 0, count: size.width * destinationPixelLength)
+            }
+            return
+        }
+        for y in 0 ..< size.height {
+            (pixels + y * bytesPerRow).initializeMemory(as: UInt32.self, repeating: colors.table[0], count: size.width)
+        }
+    }
+
+    /// The part of the span of `count` pixels from `x`, on line `y`, that is within bounds.
+    @inline(__always)
+    private func clip(x: Int, y: Int, count: Int) -> Range<Int>? {
+        guard y >= 0 && y < size.height else { return nil }
+        let start = max(x, 0)
+        let end = min(x + count, size.width)
+        return start < end ? start ..< end : nil
+    }
+
+    /// Writes `count` pixels of paletted `color` from (`x`, `y`).
+    func fill(_ color: UInt8, count: Int, x: Int, y: Int) {
+        guard let span = clip(x: x, y: y, count: count) else { return }
+        let row = pixels + y * bytesPerRow
+        if let colors = colors {
+            (row + span.lowerBound * 4).initializeMemory(as: UInt32.self, repeating: colors.table[Int(color)], count: span.count)
+        }
+        else {
+            (row + span.lowerBound).initializeMemory(as: UInt8.self, repeating: color, count: span.count)
+        }
+    }
+
+    /// Writes `count` source pixels from (`x`, `y`); skipping any that are zero, if asked (paletted pixels only).
+    func copy(_ source: UnsafeRawPointer, count: Int, x: Int, y: Int, skippingZeros: Bool) {
+        guard let span = clip(x: x, y: y, count: count) else { return }
+        let row = pixels + y * bytesPerRow
+        let first = span.lowerBound - x
+
+        switch format {
+        case .paletteIndex:
+            let input = source.assumingMemoryBound(to: UInt8.self) + first
+            if let colors = colors, skippingZeros {
+                colors.table.withUnsafeBufferPointer { colors in
+                    let output = (row + span.lowerBound * 4).assumingMemoryBound(to: UInt32.self)
+                    for i in 0 ..< span.count where input[i] != 0 {
+                        output[i] = colors[Int(input[i])]
+                    }
+                }
+            }
+            else if let colors = colors {
+                colors.expandRow(input, count: span.count, into: row + span.lowerBound * 4)
+            }
+            else if skippingZeros {
+                let output = (row + span.lowerBound).assumingMemoryBound(to: UInt8.self)
+                for i in 0 ..< span.count where input[i] != 0 {
+                    output[i] = input[i]
+                }
+            }
+            else {
+                (row + span.lowerBound).copyMemory(from: input, byteCount: span.count)
+            }
+
+        case .raw4444, .raw1555:
+            let input = source + first * 2
+            guard expands else {
+                (row + span.lowerBound * 2).copyMemory(from: input, byteCount: span.count * 2)
+                return
+            }
+            let output = (row + span.lowerBound * 4).assumingMemoryBound(to: Palette.Color.self)
+            for i in 0 ..< span.count {
+                let pixel = input.loadUnaligned(fromByteOffset: i * 2)
+                output[i] = format == .raw4444 ? Palette.Color(argb4444: pixel) : Palette.Color(decompose(argb1555: pixel))
+            }
+        }
+    }
+
+}
+
+private extension UnsafeRawPointer {
+
+    /// Loads a little-endian 16-bit value from a possibly unaligned address.
+    @inline(__always)
+    func loadUnaligned(fromByteOffset offset: Int) -> UInt16 {
+        return UInt16(load(fromByteOffset: offset, as: UInt8.self)) | UInt16(load(fromByteOffset: offset + 1, as: UInt8.self)) << 8
+    }
+
+}
@@ -98,6 +98,8 @@ public extension GafItem {
         public var size: Size2<Int>
         /// The center position (in local pixels, from the top-left) of this frame.
         public var offset: Point2<Int>
+        /// The format of this frame's pixels, as they are decoded.
+        public var format: Frame.PixelFormat
     }
     
     func readFrameMetadata<File>(from gaf: File) throws -> [FrameMetadata] where File: FileReadHandle {
@@ -153,82 +155,30 @@ public extension GafItem {
         where File: FileReadHandle
     {
         gaf.seek(toFileOffset: offset)
-        let frame = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
-        
-        if frame.numberOfSubFrames == 0 {
-            let frameData = try decodeFrameData(frame, from: gaf)
-            return frameData
-        }
-        else {
-            guard let encoding = GafFrameEncoding(rawValue: frame.encoding)
-                else { throw GafLoadError.unknownFrameEncoding(frame.encoding) }
-            
-            var out = Frame(Data(count: frame.size.area), frame.size, frame.offset, encoding.pixelFormat)
-            
-            gaf.seek(toFileOffset: frame.offsetToFrameData)
-            let subframeOffsets = try gaf.readArray(ofType: UInt32.self, count: Int(frame.numberOfSubFrames))
-
-            for offset in subframeOffsets {
-                gaf.seek(toFileOffset: offset)
-                let subframeHeader = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
-                let subframe = try decodeFrameData(subframeHeader, from: gaf)
-                overlay(subframe, into: &out)
-            }
-            
-            return out
-        }
+        let header = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
+        return try extractFrame(header, at: offset, from: gaf)
     }
     
     static func extractFrames<File>(from gaf: File, at offsets: [Int], useCache: Bool = true) throws -> [Frame]
         where File: FileReadHandle
     {
         var resultFrames: [Frame] = []
-        var frameDataCache: [UInt32: Frame] = [:]
+        var frameDataCache: [UInt32: Data] = [:]
         
         for offset in offsets {
             
             gaf.seek(toFileOffset: offset)
-            let frame = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
-        
-            if frame.numberOfSubFrames == 0 {
-                
-                if useCache, let cached = frameDataCache[frame.offsetToFrameData] {
-                    resultFrames.append(cached)
-                }
-                else {
-                    let frameData = try decodeFrameData(frame, from: gaf)
-                    frameDataCache[frame.offsetToFrameData] = frameData
-                    resultFrames.append(frameData)
-                }
-                
+            let header = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
+            
+            // Frames without subframes may share their pixel data with another frame.
+            let cacheable = useCache && header.numberOfSubFrames == 0
+            if cacheable, let cached = frameDataCache[header.offsetToFrameData] {
+                resultFrames.append(Frame(cached, header.size, header.offset, FrameMetadata(header).format))
             }
             else {
-                guard let encoding = GafFrameEncoding(rawValue: frame.encoding)
-                    else { throw GafLoadError.unknownFrameEncoding(frame.encoding) }
-                
-                var out = Frame(Data(count: frame.size.area), frame.size, frame.offset, encoding.pixelFormat)
-                
-                gaf.seek(toFileOffset: frame.offsetToFrameData)
-                let subframeOffsets = try gaf.readArray(ofType: UInt32.self, count: Int(frame.numberOfSubFrames))
-                
-                for offset in subframeOffsets {
-                    
-                    gaf.seek(toFileOffset: offset)
-                    let subframeHeader = try gaf.readValue(ofType: TA_GAF_FRAME_DATA.self)
-                    
-                    let subframe: Frame
-                    if useCache, let cached = frameDataCache[subframeHeader.offsetToFrameData] {
-                        subframe = cached
-                    }
-                    else {
-                        subframe = try decodeFrameData(subframeHeader, from: gaf)
-                        frameDataCache[subframeHeader.offsetToFrameData] = subframe
-                    }
-                    
-                    overlay(subframe, into: &out)
-                }
-                
-                resultFrames.append(out)
+                let frame = try extractFrame(header, at: offset, from: gaf)
+                if cacheable { frameDataCache[header.offsetToFrameData] = frame.data }
+                resultFrames.append(frame)
             }
             
         }
@@ -236,154 +186,21 @@ public extension GafItem {
         return resultFrames
     }
     
-    private static func decodeFrameData<File>(_ frame: TA_GAF_FRAME_DATA, from gaf: File) throws -> Frame
+    /// Allocates the frame's pixels and decodes the frame (at `offset`, described by `header`) straight into them.
+    private static func extractFrame<File>(_ header: TA_GAF_FRAME_DATA, at offset: Int, from gaf: File) throws -> Frame
         where File: FileReadHandle
     {
-        guard frame.numberOfSubFrames == 0 else { throw GafLoadError.unexpectedSubframes }
+        guard let encoding = GafFrameEncoding(rawValue: header.encoding)
+            else { throw GafLoadError.unknownFrameEncoding(header.encoding) }
         
-        guard let encoding = GafFrameEncoding(rawValue: frame.encoding)
-            else { throw GafLoadError.unknownFrameEncoding(frame.encoding) }
-        
-        gaf.seek(toFileOffset: frame.offsetToFrameData)
-        let frameData: Data
-        
-        switch encoding {
-        case .taUncompressed:
-            frameData = try gaf.readData(verifyingLength: frame.size.area)
-        case .takUncompressed4444, .takUncompressed1555:
-            frameData = try gaf.readData(verifyingLength: frame.size.area * 2)
-        case .taRunLengthEncoding:
-            let compressed = gaf.readData(ofLength: frame.size.area * 2)
-            frameData = decompressTaImageBits(compressed, decompressedSize: frame.size)
+        let format = encoding.pixelFormat
+        let bytesPerRow = header.size.width * format.pixelLength
+        var data = Data(count: header.size.height * bytesPerRow)
+        try data.withUnsafeMutableBytes { (pixels: UnsafeMutableRawBufferPointer) in
+            guard let base = pixels.baseAddress else { return }
+            try decodeFrame(from: gaf, at: offset, into: FrameDestination(pixels: base, bytesPerRow: bytesPerRow, format: .native))
         }
-        
-        return Frame(frameData, frame.size, frame.offset, encoding.pixelFormat)
-    }
-    
-    private static func decompressTaImageBits(_ data: Data, decompressedSize size: Size2<Int>) -> Data {
-        
-        var imageData = Data(count: size.area)
-        imageData.withUnsafeMutableBytes { (output: UnsafeMutableRawBufferPointer) -> Void in
-            data.withUnsafeBytes { (input: UnsafeRawBufferPointer) in
-                
-                var inputLine = input.startIndex
-                var outputIndex = output.startIndex
-                
-                // Decompress one line at a time
-                for lineNo in 0..<size.height {
-                    
-                    // Get the length of the compressed line
-                    guard inputLine+2 < input.endIndex else { break }
-                    let byte1 = input[inputLine + 0]
-                    let byte2 = input[inputLine + 1]
-                    let lineLength = Int((UInt16(byte2) << 8) | UInt16(byte1))
-                    
-                    guard lineLength <= size.width*2 else {
-                        print("!!! Warning, bad line length detected while decompressing GAF frame. [line: \(lineNo+1), length: \(lineLength)]")
-                        break
-                    }
-                    
-                    let lineBits = inputLine + MemoryLayout<UInt16>.size
-                    
-                    var inputLineIndex = 0
-                    while inputLineIndex < lineLength && (lineBits + inputLineIndex) < input.endIndex && outputIndex < output.endIndex {
-                        
-                        // The first byte tells us how to
-                        // handle the next few pixels.
-                        let controlByte = input[lineBits + inputLineIndex]
-                        inputLineIndex += 1
-                        
-                        if (controlByte & 1) == 1 {
-                            // A controlByte of 1 denotes a run of transparent pixels.
-                            // The rest of the byte is the length of the run (ie. how many successive pixels are transparent).
-                            let count = Int(controlByte >> 1)
-                            outputIndex += count
-                        }
-                        else if (controlByte & 2) == 2 {
-                            // A controlByte of 2 denotes a run of a specific color.
-                            // The rest of the control byte is the length of the run (ie. how many successive pixels are the color),
-                            // and the next input byte is the color to use for the run.
-                            guard (lineBits + inputLineIndex) < input.endIndex else { print("!!! GAF decoding ended prematurely at line \(lineNo+1) of \(size.height)"); break }
-                            let colorIndex = input[lineBits + inputLineIndex]
-                            inputLineIndex += 1
-                            let count = min(Int(controlByte >> 2) + 1, output.endIndex - outputIndex)
-                            for i in 0..<count { output[outputIndex + i] = colorIndex }
-                            outputIndex += count
-                        }
-                        else {
-                            // A controlByte of aything else is a direct copy of some number of pixels.
-                            // The rest of the control byte is the length of the copy (ie. how many successive pixels are copied).
-                            let count = min(Int(controlByte >> 2) + 1, output.endIndex - outputIndex, input.endIndex - (lineBits + inputLineIndex))
-                            for i in 0..<count { output[outputIndex + i] = input[lineBits + inputLineIndex + i] }
-                            inputLineIndex += count
-                            outputIndex += count
-                        }
-
-                    }
-                    
-                    // Move to the next input line
-                    inputLine += (MemoryLayout<UInt16>.size + lineLength)
-                }
-                
-           }
-        }
-        
-        return imageData
-    }
-    
-    private static func overlay(_ source: Frame, into destination: inout Frame) {
-        
-        guard source.format == destination.format else {
-            print("!!! Subframes with differing pixel formats not supported.")
-            return
-        }
-        
-        let offset = destination.offset &- source.offset
-        let pixelLength = source.format.pixelLength
-        
-        destination.data.withUnsafeMutableBytes() { (dstBuffer: UnsafeMutableRawBufferPointer) in
-            source.data.withUnsafeBytes() { (srcBuffer: UnsafeRawBufferPointer) in
-                
-                let dstStart_y = max(0, offset.y)
-                let srcStart_y = offset.y < 0 ? -offset.y : 0
-                
-                let dstEnd_y = min(destination.size.height, offset.y+source.size.height)
-                
-                let dstStart_x = max(0, offset.x)
-                let srcStart_x = offset.x < 0 ? -offset.x : 0
-                
-                let dstEnd_x = min(destination.size.width, offset.x+source.size.width)
-                
-                var dstLine = destination.size.width * dstStart_y
-                var srcLine = source.size.width * srcStart_y
-                
-                for _ in dstStart_y..<dstEnd_y {
-                    
-                    var dstPixel = dstLine + dstStart_x
-                    var srcPixel = srcLine + srcStart_x
-                    
-                    for _ in dstStart_x..<dstEnd_x {
-                        if pixelLength == 1 {
-                            let value = srcBuffer[srcPixel]
-                            if value > 0 { dstBuffer[dstPixel] = value }
-                        }
-                        else {
-                            for i in 0..<pixelLength {
-                                dstBuffer[dstPixel+i] = srcBuffer[srcPixel+i]
-                            }
-                        }
-                        dstPixel += pixelLength
-                        srcPixel += pixelLength
-                    }
-                    
-                    dstLine += destination.size.width * pixelLength
-                    srcLine += source.size.width * pixelLength
-                }
-                
-            }
-        }
-        
-        
+        return Frame(data, header.size, header.offset, format)
     }
     
     enum GafLoadError: Error {
@@ -397,6 +214,7 @@ extension GafItem.FrameMetadata {
     init(_ rawHeader: TA_GAF_FRAME_DATA) {
         offset = rawHeader.offset
         size = rawHeader.size
+        format = GafFrameEncoding(rawValue: rawHeader.encoding)?.pixelFormat ?? .paletteIndex
     }
 }
 
@@ -83,9 +83,9 @@ public enum HpiItem {
     public struct File {
         public var name: String
         public var size: Int
-        fileprivate var offset: Int
-        fileprivate var compression: HpiFormat.FileEntryCompression
-        fileprivate var compressedSize: Int
+        var offset: Int
+        var compression: HpiFormat.FileEntryCompression
+        var compressedSize: Int
     }
     
     /**
@@ -127,21 +127,7 @@ public extension HpiItem {
      - returns: The root directory loaded from the HPI archive.
      */
     static func loadFromArchive(contentsOf hpiURL: URL) throws -> HpiItem.Directory {
-        
-        let hpiFile = try FileHandle(forReadingFrom: hpiURL)
-        let header = hpiFile.readValue(ofType: TA_HPI_HEADER.self)
-        
-        guard header.marker == TA_HPI_MARKER
-            else { throw LoadError.badHpiMarker(Int(header.marker)) }
-        guard let hpiType = HpiFormat.HpiVersion(rawValue: header.version)
-            else { throw LoadError.badHpiType(Int(header.version)) }
-        
-        switch hpiType {
-        case .ta: return try loadFromTaArchive(file: hpiFile)
-        case .tak: return try loadFromTakArchive(file: hpiFile)
-        case .savegame: throw LoadError.unsupportedHpiType(Int(header.version))
-        }
-        
+        return try HpiArchive(contentsOf: hpiURL).loadDirectory()
     }
     
     /**
@@ -150,34 +136,188 @@ public extension HpiItem {
                            This should have been obtained via the result of a `loadFromArchive()` call.
      - parameter hpiURL: Location of the HPI archive's file to read and extract from.
      - returns: The data contents of the extracted file.
+                If the file is stored uncompressed and unencrypted, this is a read-only view directly
+                into the memory-mapped archive; no bytes are copied, and the result must not be mutated.
+     
+     This opens (and validates) the archive for every call.
+     When extracting many files, open an `HpiArchive` once and use its `extract(file:)` instead.
      */
     static func extract(file fileInfo: File, fromHPI hpiURL: URL) throws -> Data {
+        return try HpiArchive(contentsOf: hpiURL).extract(file: fileInfo)
+    }
+    
+    enum LoadError: Error {
+        case badHpiMarker(Int)
+        case badHpiType(Int)
+        case unsupportedHpiType(Int)
+    }
+    enum ExtractError: Error {
+        case badChunkMarker(Int)
+        case badCompressionType(Int)
+        case truncatedChunk
+        case badChunkSize(Int)
+        case corruptChunk
+        case zlibError(Int)
+    }
+}
+
+/**
+ An open HPI archive.
+ 
+ The archive is mapped into memory, and its headers are read & validated, just once on creation.
+ Any number of files can then be extracted from it without reopening the archive.
+ An `HpiArchive` is immutable and may be used from any thread.
+ */
+public final class HpiArchive {
+    
+    public let url: URL
+    
+    fileprivate let file: MappedFile
+    fileprivate let header: Header
+    
+    fileprivate enum Header {
+        /// A Total Annihilation archive and its (already decoded) decryption key; zero if unencrypted.
+        case ta(TA_HPI_EXT_HEADER, key: Int32)
+        /// A Total Annihilation: Kingdoms archive.
+        case tak(TAK_HPI_EXT_HEADER)
+    }
+    
+    /**
+     Open & validate the HPI archive at `url`.
+     */
+    public init(contentsOf url: URL) throws {
         
-        let hpiFile = try FileHandle(forReadingFrom: hpiURL)
-        let header = hpiFile.readValue(ofType: TA_HPI_HEADER.self)
+        let file = try MappedFile(contentsOf: url)
+        let header = try file.load(fromByteOffset: 0, as: TA_HPI_HEADER.self)
         
         guard header.marker == TA_HPI_MARKER
-            else { throw LoadError.badHpiMarker(Int(header.marker)) }
+            else { throw HpiItem.LoadError.badHpiMarker(Int(header.marker)) }
         guard let hpiType = HpiFormat.HpiVersion(rawValue: header.version)
-            else { throw LoadError.badHpiType(Int(header.version)) }
+            else { throw HpiItem.LoadError.badHpiType(Int(header.version)) }
         
+        let extOffset = MemoryLayout<TA_HPI_HEADER>.size
         switch hpiType {
-        case .ta: return try extract(taFile: fileInfo, fromHpi: hpiFile)
-        case .tak: return try extract(takFile: fileInfo, fromHpi: hpiFile)
-        default: throw LoadError.unsupportedHpiType(Int(header.version))
+        case .ta:
+            let ext = try file.load(fromByteOffset: extOffset, as: TA_HPI_EXT_HEADER.self)
+            self.header = .ta(ext, key: HpiItem.taArchiveKey(for: ext))
+        case .tak:
+            self.header = .tak(try file.load(fromByteOffset: extOffset, as: TAK_HPI_EXT_HEADER.self))
+        case .savegame:
+            throw HpiItem.LoadError.unsupportedHpiType(Int(header.version))
         }
         
+        self.url = url
+        self.file = file
     }
     
-    enum LoadError: Error {
-        case badHpiMarker(Int)
-        case badHpiType(Int)
-        case unsupportedHpiType(Int)
+    public var version: HpiFormat.HpiVersion {
+        switch header {
+        case .ta: return .ta
+        case .tak: return .tak
+        }
     }
-    enum ExtractError: Error {
-        case badChunkMarker(Int)
-        case badCompressionType(Int)
+    
+    /**
+     Parse & load the archive's filesystem into a heirarchical set of HPIItems.
+     - returns: The root directory loaded from the HPI archive.
+     */
+    public func loadDirectory() throws -> HpiItem.Directory {
+        let span = Trace.begin("HPI Directory", category: "hpi", detail: self.url.lastPathComponent)
+        defer { span.end() }
+        switch header {
+        case let .ta(ext, key): return try HpiItem.loadFromTaArchive(file: file, header: ext, key: key)
+        case let .tak(ext): return try HpiItem.loadFromTakArchive(file: file, header: ext)
+        }
+    }
+    
+    /**
+     Extracts a single file from the archive and returns its contents.
+     - parameter fileInfo: Metadata of the specific file to extract.
+                           This should have been obtained via the result of a `loadDirectory()` call.
+     - returns: The data contents of the extracted file.
+                If the file is stored uncompressed and unencrypted, this is a read-only view directly
+                into the memory-mapped archive; no bytes are copied, and the result must not be mutated.
+     */
+    public func extract(file fileInfo: HpiItem.File) throws -> Data {
+        let span = Trace.begin("HPI Extract", category: "hpi", detail: fileInfo.name)
+        defer { span.end() }
+        switch header {
+        case let .ta(_, key): return try HpiItem.extract(taFile: fileInfo, fromHpi: file, key: key)
+        case .tak: return try HpiItem.extract(takFile: fileInfo, fromHpi: file)
+        }
     }
+    
+}
+
+public extension HpiArchive {
+    
+    /**
+     The layout of a file that is stored as a series of independently compressed chunks.
+     Every chunk (but the last) decompresses to exactly `chunkSize` bytes of the file.
+     */
+    struct ChunkTable {
+        public let fileSize: Int
+        public let chunkSize: Int
+        /// The location of each chunk in the archive.
+        fileprivate let archiveRanges: [Range<Int>]
+        
+        public var count: Int { return archiveRanges.count }
+        
+        /// The range of the (decompressed) file covered by chunk `index`.
+        public func range(ofChunk index: Int) -> Range<Int> {
+            let start = index * chunkSize
+            return start ..< min(start + chunkSize, fileSize)
+        }
+        
+        /// The indices of the chunks that cover the given range of the (decompressed) file.
+        public func chunks(covering range: Range<Int>) -> Range<Int> {
+            guard !range.isEmpty else { return 0..<0 }
+            return (range.lowerBound / chunkSize) ..< min((range.upperBound + chunkSize - 1) / chunkSize, count)
+        }
+    }
+    
+    /**
+     Whether `extract(file:)` returns a view directly into the mapped archive for this file;
+     ie. the file is stored uncompressed and unencrypted, and extracting it costs nothing.
+     */
+    func extractsWithoutCopying(_ fileInfo: HpiItem.File) -> Bool {
+        guard fileInfo.compression == .none else { return false }
+        switch header {
+        case let .ta(_, key): return key == 0
+        case .tak: return true
+        }
+    }
+    
+    /**
+     Reads the chunk layout of a file, so that its chunks can be extracted individually with `extract(chunk:of:into:)`.
+     - returns: The file's chunks; or `nil` if the file is not chunked (it is uncompressed, or it is a single blob),
+                in which case it can only be extracted as a whole with `extract(file:)`.
+     */
+    func chunkTable(for fileInfo: HpiItem.File) throws -> ChunkTable? {
+        switch header {
+        case let .ta(_, key):
+            guard fileInfo.compression != .none else { return nil }
+            return try HpiItem.loadTaChunkTable(for: fileInfo, fromHpi: file, key: key)
+        case .tak:
+            return nil
+        }
+    }
+    
+    /**
+     Decompresses a single chunk of a file directly into `destination`,
+     which must be exactly the size of the chunk's `range(ofChunk:)`.
+     */
+    func extract(chunk index: Int, of chunks: ChunkTable, into destination: UnsafeMutableRawBufferPointer) throws {
+        let span = Trace.begin("HPI Extract Chunk", category: "hpi")
+        defer { span.end() }
+        switch header {
+        case let .ta(_, key):
+            try HpiItem.extract(taChunk: index, of: chunks, fromHpi: file, key: key, into: destination)
+        case .tak:
+            throw HpiItem.ExtractError.badChunkSize(destination.count)
+        }
+    }
+    
 }
 
 public extension HpiItem.File {
@@ -199,20 +339,16 @@ public extension HpiItem {
     /**
      Parse & load a Total Annihilation HPI filesystem into a heirarchical set of HPIItems.
      */
-    fileprivate static func loadFromTaArchive(file: FileHandle) throws -> HpiItem.Directory {
-        
-        let ext = file.readValue(ofType: TA_HPI_EXT_HEADER.self)
+    fileprivate static func loadFromTaArchive(file: MappedFile, header ext: TA_HPI_EXT_HEADER, key archiveKey: Int32) throws -> HpiItem.Directory {
         
-        // The headerKey is non-zero then this entire HPI file (other than the header, of course)
-        // is enctrypted with a simple key. This keyiteslf must be decoded with some simple bit shifting.
-        let archiveKey = ext.headerKey != 0 ? ~( (ext.headerKey * 4) | (ext.headerKey >> 6) ) : 0
-        
-        // Read the entire filesystem directory into memory.
+        // The entire filesystem directory is a single blob in the archive.
         // Every bit of metadata about the filesystem should be within this data blob;
         // everyting remaining in the HPI file is chunked (and optionally compressed) file conetent.
-        let fsData = file.readAndDecryptData(ofLength: Int(ext.directorySize),
-                                             offset: ext.offsetToDirectory,
-                                             key: archiveKey)
+        // For an unencrypted archive, this is parsed in-place from the mapped file.
+        // (The directory size is clamped to the end of the file; it is sometimes larger than what remains.)
+        let fsOffset = Int(ext.offsetToDirectory)
+        let fsSize = min(Int(ext.directorySize), max(file.count - fsOffset, 0))
+        let fsData = try file.decryptedData(in: Range(start: fsOffset, count: fsSize), key: archiveKey)
         
         // Parse the contents of the filesystem directory by recursively iterating
         // over its contents with `loadDirectory()`. We start with the root directory
@@ -286,70 +422,91 @@ public extension HpiItem {
         })
     }
     
-    fileprivate static func extract(taFile fileInfo: File, fromHpi hpiFile: FileHandle) throws -> Data {
-        
-        let ext = hpiFile.readValue(ofType: TA_HPI_EXT_HEADER.self)
-        let key = ext.headerKey != 0 ? ~( (ext.headerKey * 4) | (ext.headerKey >> 6) ) : 0
+    fileprivate static func extract(taFile fileInfo: File, fromHpi hpiFile: MappedFile, key: Int32) throws -> Data {
         
         switch fileInfo.compression {
             
         case .none:
-            let data = hpiFile.readAndDecryptData(ofLength: fileInfo.size,
-                                                  offset: UInt32(fileInfo.offset),
-                                                  key: key)
-            return data
+            return try hpiFile.decryptedData(in: Range(start: fileInfo.offset, count: fileInfo.size), key: key)
             
         case .lz77: fallthrough
         case .zlib:
-            var data = Data()
-            
-            let chunkCount = (fileInfo.size / Int(TA_HPI_CHUNK_DEFAULT_SIZE)) +
-                ( (fileInfo.size % Int(TA_HPI_CHUNK_DEFAULT_SIZE)) != 0 ? 1:0 )
-            
-            let chunkSizeData = hpiFile.readAndDecryptData(ofLength: MemoryLayout<UInt32>.size * chunkCount,
-                                                           offset: UInt32(fileInfo.offset),
-                                                           key: key)
-            
-            var chunkOffset = UInt32(fileInfo.offset + chunkSizeData.count)
-            
-            try chunkSizeData.withUnsafeBytes { (buffer) in
-                let chunkSizes = buffer.bindMemory(to: UInt32.self)
-                for chunkSize in chunkSizes {
-                    let chunkData = hpiFile.readAndDecryptData(ofLength: Int(chunkSize),
-                                                               offset: chunkOffset,
-                                                               key: key)
-                    let decompressed = try deSqsh(chunk: chunkData)
-                    data.append(decompressed)
-                    chunkOffset += chunkSize
+            // Every chunk is independent and can be decompressed concurrently,
+            // directly into its own slice of the file's data.
+            let chunks = try loadTaChunkTable(for: fileInfo, fromHpi: hpiFile, key: key)
+            var data = Data(count: fileInfo.size)
+            try data.withUnsafeMutableBytes { (out: UnsafeMutableRawBufferPointer) in
+                try DispatchQueue.concurrentPerform(iterations: chunks.count) { (index: Int) in
+                    let slice = UnsafeMutableRawBufferPointer(rebasing: out[chunks.range(ofChunk: index)])
+                    try extract(taChunk: index, of: chunks, fromHpi: hpiFile, key: key, into: slice)
                 }
             }
-            
             return data
         }
     }
     
+    fileprivate static func loadTaChunkTable(for fileInfo: File, fromHpi hpiFile: MappedFile, key: Int32) throws -> HpiArchive.ChunkTable {
+        
+        let chunkSize = Int(TA_HPI_CHUNK_DEFAULT_SIZE)
+        let chunkCount = fileInfo.size.partitionCount(by: chunkSize)
+        let chunkSizeData = try hpiFile.decryptedData(in: Range(start: fileInfo.offset, count: MemoryLayout<UInt32>.size * chunkCount),
+                                                      key: key)
+        
+        // The size table is not necessarily aligned in the archive; so copy it out.
+        var chunkSizes = [UInt32](repeating: 0, count: chunkCount)
+        chunkSizes.withUnsafeMutableBytes { $0.copyBytes(from: chunkSizeData) }
+        
+        var archiveRanges = [Range<Int>]()
+        archiveRanges.reserveCapacity(chunkCount)
+        var chunkOffset = fileInfo.offset + chunkSizeData.count
+        for size in chunkSizes {
+            archiveRanges.append(Range(start: chunkOffset, count: Int(size)))
+            chunkOffset += Int(size)
+        }
+        
+        return HpiArchive.ChunkTable(fileSize: fileInfo.size, chunkSize: chunkSize, archiveRanges: archiveRanges)
+    }
+    
+    fileprivate static func extract(taChunk index: Int, of chunks: HpiArchive.ChunkTable, fromHpi hpiFile: MappedFile, key: Int32, into destination: UnsafeMutableRawBufferPointer) throws {
+        try hpiFile.withDecryptedBytes(in: chunks.archiveRanges[index], key: key) {
+            try deSqsh(chunk: $0, into: destination)
+        }
+    }
+    
+    /// If the headerKey is non-zero then this entire HPI file (other than the header, of course)
+    /// is enctrypted with a simple key. This key itself must be decoded with some simple bit shifting.
+    fileprivate static func taArchiveKey(for ext: TA_HPI_EXT_HEADER) -> Int32 {
+        return ext.headerKey != 0 ? ~( (ext.headerKey &* 4) | (ext.headerKey >> 6) ) : 0
+    }
+    
 }
 
-private extension FileHandle {
-    
-    func readAndDecryptData(ofLength size: Int, offset: UInt32, key: Int32) -> Data {
-        seek(toFileOffset: offset)
-        var data = readData(ofLength: size)
-        if data.count < size { print("read less data than requested! (wanted \(size) bytes, read \(data.count) bytes)") }
-        let koffset = Int32(offset)
-        if key != 0 {
-            for index in 0..<data.count {
-                let tkey = (koffset &+ Int32(index)) ^ key
-                let inv = Int32(~data[index])
-                data[index] = UInt8(truncatingIfNeeded: tkey ^ inv)
-            }
-        }
-        return data
+private extension MappedFile {
+    
+    /**
+     Returns the archive bytes in `range`, decrypted with `key`.
+     For an unencrypted archive (`key == 0`) the result is a view directly into the mapping.
+     */
+    func decryptedData(in range: Range<Int>, key: Int32) throws -> Data {
+        guard key != 0 else { return try data(in: range) }
+        let source = try bytes(in: range)
+        var decrypted = Data(count: range.count)
+        decrypted.withUnsafeMutableBytes { HpiItem.decrypt(source, into: $0, fileOffset: range.lowerBound, key: key) }
+        return decrypted
     }
     
-    func readAndDecryptValue<T>(ofType type: T.Type, offset: UInt32, key: Int32) -> T {
-        let data = readAndDecryptData(ofLength: MemoryLayout<T>.size, offset: offset, key: key)
-        return data.withUnsafeBytes { (buffer) -> T in buffer.load(as: type) }
+    /**
+     Calls `body` with the archive bytes in `range`, decrypted with `key`.
+     For an unencrypted archive (`key == 0`) these are the mapped bytes themselves;
+     otherwise they are decrypted into a temporary buffer that only lives for the duration of `body`.
+     */
+    func withDecryptedBytes<R>(in range: Range<Int>, key: Int32, _ body: (UnsafeRawBufferPointer) throws -> R) throws -> R {
+        let source = try bytes(in: range)
+        guard key != 0 else { return try body(source) }
+        let decrypted = UnsafeMutableRawBufferPointer.allocate(byteCount: range.count, alignment: 1)
+        defer { decrypted.deallocate() }
+        HpiItem.decrypt(source, into: decrypted, fileOffset: range.lowerBound, key: key)
+        return try body(UnsafeRawBufferPointer(decrypted))
     }
     
 }
@@ -361,16 +518,12 @@ extension HpiItem {
     /**
      Parse & load a Total Annihilation: Kingdoms HPI filesystem into a heirarchical set of HPIItems.
      */
-    fileprivate static func loadFromTakArchive(file: FileHandle) throws -> HpiItem.Directory {
-    
-        let ext = file.readValue(ofType: TAK_HPI_EXT_HEADER.self)
+    fileprivate static func loadFromTakArchive(file: MappedFile, header ext: TAK_HPI_EXT_HEADER) throws -> HpiItem.Directory {
         
-        file.seek(toFileOffset: ext.offsetToDirectory)
-        let rawFsData = file.readData(ofLength: ext.directorySize)
+        let rawFsData = try file.data(in: Range(start: Int(ext.offsetToDirectory), count: Int(ext.directorySize)))
         let fsData = HpiItem.isSqsh(chunk: rawFsData) ? try HpiItem.deSqsh(chunk: rawFsData) : rawFsData
         
-        file.seek(toFileOffset: ext.offsetToFileNames)
-        let rawNamesData = file.readData(ofLength: ext.fileNameSize)
+        let rawNamesData = try file.data(in: Range(start: Int(ext.offsetToFileNames), count: Int(ext.fileNameSize)))
         let namesData = HpiItem.isSqsh(chunk: rawNamesData) ? try HpiItem.deSqsh(chunk: rawNamesData) : rawNamesData
         
         let rootItems = try fsData.withUnsafeBytes { (fs) throws -> [HpiItem] in
@@ -419,18 +572,18 @@ extension HpiItem {
         return subdirectories + files
     }
     
-    fileprivate static func extract(takFile fileInfo: File, fromHpi hpiFile: FileHandle) throws -> Data {
+    fileprivate static func extract(takFile fileInfo: File, fromHpi hpiFile: MappedFile) throws -> Data {
         switch fileInfo.compression {
             
         case .none:
-            hpiFile.seek(toFileOffset: fileInfo.offset)
-            return hpiFile.readData(ofLength: fileInfo.size)
+            return try hpiFile.data(in: Range(start: fileInfo.offset, count: fileInfo.size))
             
         case .lz77: fallthrough
         case .zlib:
-            hpiFile.seek(toFileOffset: fileInfo.offset)
-            let chunkData = hpiFile.readData(ofLength: fileInfo.compressedSize)
-            return try deSqsh(chunk: chunkData)
+            let chunkData = try hpiFile.bytes(in: Range(start: fileInfo.offset, count: fileInfo.compressedSize))
+            var data = Data(count: fileInfo.size)
+            try data.withUnsafeMutableBytes { try deSqsh(chunk: chunkData, into: $0) }
+            return data
         }
     }
     
@@ -441,148 +594,316 @@ extension HpiItem {
 extension HpiItem {
     
     fileprivate static func isSqsh(chunk rawData: Data) -> Bool {
+        guard rawData.count >= MemoryLayout<TA_HPI_CHUNK>.size else { return false }
         return rawData.withUnsafeBytes { (buffer) -> Bool in
             return buffer.load(as: TA_HPI_CHUNK.self).marker == TA_HPI_CHUNK_MARKER
         }
     }
     
     fileprivate static func deSqsh(chunk rawData: Data) throws -> Data {
-        return try rawData.withUnsafeBytes { (buffer) throws -> Data in
-            let chunkHeader = buffer.load(as: TA_HPI_CHUNK.self)
-            guard chunkHeader.marker == TA_HPI_CHUNK_MARKER
-                else { throw ExtractError.badChunkMarker(Int(chunkHeader.marker)) }
-            guard let compression = HpiFormat.ChunckCompression(rawValue: chunkHeader.compressionType)
-                else { throw ExtractError.badCompressionType(Int(chunkHeader.compressionType)) }
-            
-            if chunkHeader.encryptionFlag == 0 && compression == .none {
-                let start = MemoryLayout<TA_HPI_CHUNK>.size
-                let end = start + Int(chunkHeader.decompressedSize)
-                return rawData.subdata(in: start..<end)
-            }
-            
-            var chunkData = UnsafeRawBufferPointer(rebasing: buffer[MemoryLayout<TA_HPI_CHUNK>.size...])
-            let compressedSize = Int(chunkHeader.compressedSize)
-            
-            var toRealease: UnsafeMutableRawBufferPointer? = nil
-            defer { if let r = toRealease { r.deallocate() } }
-            
-            if chunkHeader.encryptionFlag != 0 {
-                let enecrypted = chunkData
-                let decrypted = UnsafeMutableRawBufferPointer.allocate(byteCount: compressedSize, alignment: 1)
-                for index in 0..<compressedSize {
-                    let x = UInt8(truncatingIfNeeded: index)
-                    decrypted[index] = (enecrypted[index] &- x) ^ x
-                }
-                chunkData = UnsafeRawBufferPointer(decrypted)
-                toRealease = decrypted
-            }
-            
-            switch compression {
-            case .none: return Data(chunkData[..<Int(chunkHeader.decompressedSize)])
-            case .lz77: return decompressLZ77(bytes: chunkData, decompressedSize: Int(chunkHeader.decompressedSize))
-            case .zlib: return decompressZLib(bytes: chunkData, compressedSize: compressedSize, decompressedSize: Int(chunkHeader.decompressedSize))
-            }
+        return try rawData.withUnsafeBytes { (buffer: UnsafeRawBufferPointer) in try deSqsh(chunk: buffer) }
+    }
+    
+    fileprivate static func deSqsh(chunk buffer: UnsafeRawBufferPointer) throws -> Data {
+        let chunkHeader = try loadChunkHeader(buffer)
+        var data = Data(count: Int(chunkHeader.decompressedSize))
+        try data.withUnsafeMutableBytes { try deSqsh(chunk: buffer, into: $0) }
+        return data
+    }
+    
+    /**
+     Decompresses a single chunk directly into `destination`.
+     The chunk must decompress to exactly `destination.count` bytes.
+     */
+    fileprivate static func deSqsh(chunk buffer: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer) throws {
+        let chunkHeader = try loadChunkHeader(buffer)
+        guard let compression = HpiFormat.ChunckCompression(rawValue: chunkHeader.compressionType)
+            else { throw ExtractError.badCompressionType(Int(chunkHeader.compressionType)) }
+        guard Int(chunkHeader.decompressedSize) == destination.count
+            else { throw ExtractError.badChunkSize(Int(chunkHeader.decompressedSize)) }
+        
+        let compressedSize = Int(chunkHeader.compressedSize)
+        var chunkData = UnsafeRawBufferPointer(rebasing: buffer[MemoryLayout<TA_HPI_CHUNK>.size...])
+        guard chunkData.count >= compressedSize
+            else { throw ExtractError.truncatedChunk }
+        
+        var toRealease: UnsafeMutableRawBufferPointer? = nil
+        defer { if let r = toRealease { r.deallocate() } }
+        
+        if chunkHeader.encryptionFlag != 0 {
+            let enecrypted = UnsafeRawBufferPointer(rebasing: chunkData[..<compressedSize])
+            let decrypted = UnsafeMutableRawBufferPointer.allocate(byteCount: compressedSize, alignment: 1)
+            decryptChunk(enecrypted, into: decrypted)
+            chunkData = UnsafeRawBufferPointer(decrypted)
+            toRealease = decrypted
+        }
+        
+        switch compression {
+        case .none:
+            guard chunkData.count >= destination.count
+                else { throw ExtractError.truncatedChunk }
+            destination.copyMemory(from: UnsafeRawBufferPointer(rebasing: chunkData[..<destination.count]))
+        case .lz77:
+            let written = try decompressLZ77(bytes: UnsafeRawBufferPointer(rebasing: chunkData[..<compressedSize]), into: destination)
+            guard written == destination.count
+                else { throw ExtractError.badChunkSize(written) }
+        case .zlib:
+            let written = try decompressZLib(bytes: UnsafeRawBufferPointer(rebasing: chunkData[..<compressedSize]), into: destination)
+            guard written == destination.count
+                else { throw ExtractError.badChunkSize(written) }
         }
     }
     
+    private static func loadChunkHeader(_ buffer: UnsafeRawBufferPointer) throws -> TA_HPI_CHUNK {
+        guard buffer.count >= MemoryLayout<TA_HPI_CHUNK>.size
+            else { throw ExtractError.truncatedChunk }
+        let chunkHeader = buffer.load(as: TA_HPI_CHUNK.self)
+        guard chunkHeader.marker == TA_HPI_CHUNK_MARKER
+            else { throw ExtractError.badChunkMarker(Int(chunkHeader.marker)) }
+        return chunkHeader
+    }
+    
+}
+
+// MARK: - Decryption
+
+extension HpiItem {
+    
+    /**
+     Decrypts `source`, which was read from a TA archive at `fileOffset`, into `destination`.
+     
+     Every byte `b` at archive offset `o` decrypts to `~b ^ (o ^ key)`.
+     Only the low byte of `o ^ key` survives the truncation back to a byte,
+     so the work is independent per byte and is done 32 bytes at a time.
+     */
+    static func decrypt(_ source: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer, fileOffset: Int, key: Int32) {
+        guard var src = source.baseAddress, var dst = destination.baseAddress else { return }
+        var remaining = min(source.count, destination.count)
+        
+        let key8 = UInt8(truncatingIfNeeded: key)
+        var offset8 = UInt8(truncatingIfNeeded: fileOffset)
+        
+        let lanes = SIMD32<UInt8>.laneIndices
+        while remaining >= 32 {
+            let tkey = (lanes &+ SIMD32(repeating: offset8)) ^ SIMD32(repeating: key8)
+            let v = SIMD32<UInt8>(unalignedFrom: src)
+            (~v ^ tkey).storeUnaligned(to: dst)
+            src += 32
+            dst += 32
+            remaining -= 32
+            offset8 &+= 32
+        }
+        
+        let s = src.assumingMemoryBound(to: UInt8.self)
+        let d = dst.assumingMemoryBound(to: UInt8.self)
+        for i in 0..<remaining {
+            d[i] = ~s[i] ^ (offset8 &+ UInt8(truncatingIfNeeded: i)) ^ key8
+        }
+    }
+    
+    /**
+     Decrypts the (compressed) data of an encrypted chunk.
+     
+     Every byte `b` at index `i` of the chunk's data decrypts to `(b - i) ^ i`, with `i` truncated to a byte.
+     This is done 32 bytes at a time.
+     */
+    static func decryptChunk(_ source: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer) {
+        guard var src = source.baseAddress, var dst = destination.baseAddress else { return }
+        var remaining = min(source.count, destination.count)
+        
+        var x = SIMD32<UInt8>.laneIndices
+        var index8: UInt8 = 0
+        while remaining >= 32 {
+            let v = SIMD32<UInt8>(unalignedFrom: src)
+            ((v &- x) ^ x).storeUnaligned(to: dst)
+            src += 32
+            dst += 32
+            remaining -= 32
+            x &+= SIMD32(repeating: 32)
+            index8 &+= 32
+        }
+        
+        let s = src.assumingMemoryBound(to: UInt8.self)
+        let d = dst.assumingMemoryBound(to: UInt8.self)
+        for i in 0..<remaining {
+            let x = index8 &+ UInt8(truncatingIfNeeded: i)
+            d[i] = (s[i] &- x) ^ x
+        }
+    }
+    
+    /// The original byte-at-a-time form of `decrypt(_:into:fileOffset:key:)`; kept as a reference for testing & benchmarking.
+    static func decryptScalar(_ source: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer, fileOffset: Int, key: Int32) {
+        let koffset = Int32(truncatingIfNeeded: fileOffset)
+        for index in 0..<source.count {
+            let tkey = (koffset &+ Int32(truncatingIfNeeded: index)) ^ key
+            let inv = Int32(~source[index])
+            destination[index] = UInt8(truncatingIfNeeded: tkey ^ inv)
+        }
+    }
+    
+    /// The original byte-at-a-time form of `decryptChunk(_:into:)`; kept as a reference for testing & benchmarking.
+    static func decryptChunkScalar(_ source: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer) {
+        for index in 0..<source.count {
+            let x = UInt8(truncatingIfNeeded: index)
+            destination[index] = (source[index] &- x) ^ x
+        }
+    }
+    
+}
+
+private extension SIMD32 where Scalar == UInt8 {
+    /// The vector (0, 1, 2, ... 31).
+    static var laneIndices: SIMD32<UInt8> {
+        return SIMD32( 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+                      16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31)
+    }
 }
 
 /**
- Decompresses the input bytes using the LZ77 algorithm.
+ Decompresses the input bytes using the LZ77 algorithm, directly into `destination`.
+ 
+ The compressed stream is a flag byte followed by eight tokens (one per bit, LSB first), repeated.
+ A clear bit is a single literal byte. A set bit is a little-endian 16-bit match:
+ the upper 12 bits are a position in a 4 KB sliding window (zero marks the end of the stream),
+ and the lower 4 bits are the match length minus 2.
+ 
+ Every byte that would be written to the window is also written to the output; so instead of keeping
+ a separate window, the output itself is used as the history. Window position `p` holds the most recent
+ output byte `n` where `(n + 1) & 0xFFF == p`. Window positions that have not been written yet read as zero.
  
- This bit of code could use some inspection. It's been copied around and translated so many times;
- I don't even know the original source.
+ - returns: The number of bytes written to `destination`.
+ - throws: `ExtractError.corruptChunk` if the input ends before the end-of-stream marker,
+           or if the output would overflow `destination`.
  */
-private func decompressLZ77(bytes _in: UnsafeRawBufferPointer, decompressedSize: Int) -> Data {
+private func decompressLZ77(bytes input: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer) throws -> Int {
     
-    var outptr = 0
-    let out = UnsafeMutableRawBufferPointer.allocate(byteCount: decompressedSize, alignment: 1)
-    defer { out.deallocate() }
+    guard let src = input.baseAddress?.assumingMemoryBound(to: UInt8.self)
+        else { throw HpiItem.ExtractError.corruptChunk }
+    guard let out = destination.baseAddress?.assumingMemoryBound(to: UInt8.self)
+        else { return 0 }
     
-    let DBuff = UnsafeMutableRawBufferPointer.allocate(byteCount: 4096, alignment: 1)
-    defer { DBuff.deallocate() }
-        
-    var work1 = 1
-    var work2 = 1
-    var work3 = Int(_in[0])
-    var inptr = 1
+    let inEnd = input.count
+    let outEnd = destination.count
+    var inptr = 0
+    var outptr = 0
     
-    loop: while true {
-        if (work2 & work3) == 0 {
-            out[outptr] = _in[inptr]
-            DBuff[work1] = _in[inptr]
-            work1 = (work1 + 1) & 0xFFF
-            inptr += 1
-            outptr += 1
-        }
-        else {
-            let byte1 = _in[inptr + 0]
-            let byte2 = _in[inptr + 1]
-            var count = (UInt16(byte2) << 8) | UInt16(byte1)
-            inptr += 2
-            var DPtr = Int(count >> 4)
-            if DPtr == 0 {
-                break loop
+    while inptr < inEnd {
+        let flags = src[inptr]
+        inptr += 1
+        
+        for bit in 0 ..< 8 {
+            if (flags & (1 << bit)) == 0 {
+                guard inptr < inEnd, outptr < outEnd
+                    else { throw HpiItem.ExtractError.corruptChunk }
+                out[outptr] = src[inptr]
+                inptr += 1
+                outptr += 1
             }
             else {
-                count = (count & 0x0F) + 2
-                if count >= 0 {
-                    for _ in 0..<count {
-                        out[outptr] = DBuff[DPtr]
-                        DBuff[work1] = DBuff[DPtr]
-                        DPtr = (DPtr + 1) & 0xFFF
-                        work1 = (work1 + 1) & 0xFFF
-                        outptr += 1
+                guard inEnd - inptr >= 2
+                    else { throw HpiItem.ExtractError.corruptChunk }
+                let token = Int(src[inptr]) | (Int(src[inptr + 1]) << 8)
+                inptr += 2
+                
+                let position = token >> 4
+                if position == 0 { return outptr }
+                
+                let count = (token & 0x0F) + 2
+                guard outEnd - outptr >= count
+                    else { throw HpiItem.ExtractError.corruptChunk }
+                
+                // A distance of zero means the window position about to be overwritten; ie. 4 KB back.
+                let distance = ((outptr + 1 - position) & 0xFFF)
+                let from = outptr - (distance == 0 ? 0x1000 : distance)
+                
+                if from >= 0 && outptr - from >= count {
+                    UnsafeMutableRawPointer(out + outptr).copyMemory(from: out + from, byteCount: count)
+                }
+                else {
+                    // Either the match overlaps its own output (a repeating run), which must be copied
+                    // forward byte-by-byte; or it reaches back before the start of the output.
+                    for i in 0 ..< count {
+                        out[outptr + i] = from + i >= 0 ? out[from + i] : 0
                     }
                 }
+                outptr += count
             }
         }
-        work2 *= 2
-        if (work2 & 0x0100) != 0 {
-            work2 = 1
-            work3 = Int(_in[inptr])
-            inptr += 1
-        }
     }
     
-    return Data(out[..<outptr])
+    throw HpiItem.ExtractError.corruptChunk
 }
 
 /**
- Decompresses the input bytes using ZLib deflate.
+ Decompresses the input bytes using ZLib deflate, directly into `destination`.
+ - returns: The number of bytes written to `destination`.
+ - throws: `ExtractError.zlibError` if the input is not a complete deflate stream that fits in `destination`.
  */
-private func decompressZLib(bytes _in: UnsafeRawBufferPointer, compressedSize: Int, decompressedSize: Int) -> Data {
-    
-    let out = UnsafeMutablePointer<UInt8>.allocate(capacity: decompressedSize)
-    defer { out.deallocate() }
-    
-    var zs = z_stream(
-        next_in: UnsafeMutablePointer(mutating: _in.bindMemory(to: UInt8.self).baseAddress!),
-        avail_in: uInt(compressedSize),
-        total_in: 0,
-        next_out: out,
-        avail_out: uInt(decompressedSize),
-        total_out: 0,
-        msg: nil,
-        state: nil,
-        zalloc: nil,
-        zfree: nil,
-        opaque: nil,
-        data_type: Z_BINARY,
-        adler: 0,
-        reserved: 0)
+private func decompressZLib(bytes input: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer) throws -> Int {
+    return try InflateContext.current().decompress(input, into: destination)
+}
+
+/**
+ A reusable zlib inflate stream.
+ 
+ `inflateInit` allocates a sizable block of state (including a 32 KB window) for every stream.
+ Rather than pay for that with every chunk, each thread keeps one context around
+ and simply resets it between chunks with `inflateReset`.
+ */
+private final class InflateContext {
+    
+    /// The stream is heap allocated; zlib's state holds a pointer back to it, so it must never move.
+    private let stream: UnsafeMutablePointer<z_stream>
+    
+    private init() throws {
+        stream = UnsafeMutablePointer<z_stream>.allocate(capacity: 1)
+        stream.initialize(to: z_stream())
+        let result = inflateInit_(stream, ZLIB_VERSION, Int32(MemoryLayout<z_stream>.size))
+        guard result == Z_OK else {
+            stream.deinitialize(count: 1)
+            stream.deallocate()
+            throw HpiItem.ExtractError.zlibError(Int(result))
+        }
+    }
     
-    if inflateInit_(&zs, ZLIB_VERSION, Int32(MemoryLayout<z_stream>.size)) != Z_OK {
-        return Data()
+    deinit {
+        inflateEnd(stream)
+        stream.deinitialize(count: 1)
+        stream.deallocate()
     }
     
-    if inflate(&zs, Z_FINISH) != Z_STREAM_END {
-        zs.total_out = 0
+    private static let threadDictionaryKey = "SwiftTA.HpiInflateContext"
+    
+    /// The calling thread's context; created on first use and released along with the thread.
+    static func current() throws -> InflateContext {
+        let threadDictionary = Thread.current.threadDictionary
+        if let context = threadDictionary[threadDictionaryKey] as? InflateContext {
+            return context
+        }
+        let context = try InflateContext()
+        threadDictionary[threadDictionaryKey] = context
+        return context
     }
     
-    if inflateEnd(&zs) != Z_OK {
-        return Data()
+    func decompress(_ input: UnsafeRawBufferPointer, into destination: UnsafeMutableRawBufferPointer) throws -> Int {
+        
+        let reset = inflateReset(stream)
+        guard reset == Z_OK else { throw HpiItem.ExtractError.zlibError(Int(reset)) }
+        
+        stream.pointee.next_in = UnsafeMutablePointer(mutating: input.baseAddress?.assumingMemoryBound(to: Bytef.self))
+        stream.pointee.avail_in = uInt(input.count)
+        stream.pointee.next_out = destination.baseAddress?.assumingMemoryBound(to: Bytef.self)
+        stream.pointee.avail_out = uInt(destination.count)
+        stream.pointee.data_type = Z_BINARY
+        
+        let result = inflate(stream, Z_FINISH)
+        
+        // Don't leave pointers to the caller's buffers lying around in a long-lived stream.
+        stream.pointee.next_in = nil
+        stream.pointee.next_out = nil
+        
+        guard result == Z_STREAM_END else { throw HpiItem.ExtractError.zlibError(Int(result)) }
+        return destination.count - Int(stream.pointee.avail_out)
     }
     
-    return Data(bytes: out, count: Int(zs.total_out))
 }
@@ -82,38 +82,49 @@ public extension Pcx {
     
     /**
      Decodes the RLE compressed data in `bytes` using the provided `palette` and `header` information.
+     
+     The scan lines are decoded into a buffer of palette indices first (each `bytesPerLine` long, padding and all);
+     those are then expanded through the palette in one go, `size.width` pixels per row.
      */
     private static func decode(_ header: PCX_HEADER, bytes: UnsafeRawBufferPointer, palette: UnsafeRawBufferPointer.SubSequence,
                         into pixelBuffer: UnsafeMutablePointer<UInt8>) {
         
         let size = header.imageSize
+        let lineLength = max(Int(header.bytesPerLine), size.width)
+        let end = bytes.endIndex - 769
+        
+        let indices = UnsafeMutablePointer<UInt8>.allocate(capacity: lineLength * size.height)
+        defer { indices.deallocate() }
+        indices.initialize(repeating: 0, count: lineLength * size.height)
         
         var pcxIndex = bytes.startIndex
-        var line = pixelBuffer
-        for _ in 0..<size.height {
+        var line = indices
+        decoding: for _ in 0..<size.height {
             var x = 0
-            var pixelX = 0
-            while x < size.width {
+            while x < Int(header.bytesPerLine) {
+                guard pcxIndex < end else { break decoding }
                 let byte = bytes[pcxIndex]
                 pcxIndex += 1
                 if 0xC0 == (0xC0 & byte) {
-                    let count = 0x3F & byte
-                    let byte2 = bytes[pcxIndex]
+                    guard pcxIndex < end else { break decoding }
+                    let count = min(Int(0x3F & byte), lineLength - x)
+                    line.advanced(by: x).initialize(repeating: bytes[pcxIndex], count: count)
                     pcxIndex += 1
-                    for _ in 0..<count {
-                        setPixel(line + pixelX, to: byte2, palette: palette)
-                        x += 1
-                        pixelX += 3
-                    }
+                    x += count
                 }
                 else {
-                    setPixel(line + pixelX, to: byte, palette: palette)
+                    line[x] = byte
                     x += 1
-                    pixelX += 3
                 }
             }
-            line += Int(header.bytesPerLine * 3)
+            line += lineLength
+        }
+        
+        let colors = stride(from: palette.startIndex, to: palette.startIndex + 768, by: 3).map {
+            Palette.Color(red: palette[$0], green: palette[$0 + 1], blue: palette[$0 + 2], alpha: 255)
         }
+        Palette(colors).expandIndices(indices, bytesPerRow: lineLength, size: size,
+                                      into: pixelBuffer, bytesPerRow: size.width * 3, layout: .rgb)
     }
     
     enum DecodeError: Error {
@@ -127,14 +138,6 @@ public extension Pcx {
     
 }
 
-private func setPixel(_ pixel: UnsafeMutablePointer<UInt8>, to colorIndex: UInt8, palette: UnsafeRawBufferPointer.SubSequence) {
-    let colorOffset = Int(colorIndex) * 3
-    let paletteOffset = palette.startIndex + colorOffset
-    pixel[0] = palette[paletteOffset + 0]
-    pixel[1] = palette[paletteOffset + 1]
-    pixel[2] = palette[paletteOffset + 2]
-}
-
 // MARK:- Analysis (Image or Palette)
 
 public extension Pcx {
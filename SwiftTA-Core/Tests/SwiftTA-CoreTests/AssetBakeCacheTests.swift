@@ -0,0 +1,167 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class AssetBakeCacheTests: XCTestCase {
+
+    private var directory: URL!
+    private var bakeDirectory: URL { return directory.appendingPathComponent("bake", isDirectory: true) }
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try! FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    func testBakedAssetsMatchDecoded() throws {
+        let fileSystem = try writeSampleFileSystem()
+
+        let cold = try AssetBakeCache(directory: bakeDirectory)
+        assertEqual(try cold.model(contentsOf: fileSystem.openFile(at: "objects3d/test.3do")), try decodedModel(in: fileSystem))
+        assertEqual(try cold.script(contentsOf: fileSystem.openFile(at: "scripts/test.cob")), try decodedScript(in: fileSystem))
+        let (item, gaf) = try gafItem(in: fileSystem)
+        assertEqual(try cold.frames(of: item, in: gaf), try item.extractFrames(from: gaf))
+        XCTAssertEqual(try bakedFiles().count, 3)
+
+        // A new cache over the same directory reads the baked assets.
+        let warm = try AssetBakeCache(directory: bakeDirectory)
+        assertEqual(try warm.model(contentsOf: fileSystem.openFile(at: "objects3d/test.3do")), try decodedModel(in: fileSystem))
+        assertEqual(try warm.script(contentsOf: fileSystem.openFile(at: "scripts/test.cob")), try decodedScript(in: fileSystem))
+        assertEqual(try warm.frames(of: item, in: gaf), try item.extractFrames(from: gaf))
+        XCTAssertEqual(try bakedFiles().count, 3)
+    }
+
+    func testChangedArchiveIsBakedAgain() throws {
+        let original = try writeSampleFileSystem()
+        _ = try AssetBakeCache(directory: bakeDirectory).model(contentsOf: original.openFile(at: "objects3d/test.3do"))
+
+        // The archive's size changes too; its modification time alone might not, on a file system with coarse timestamps.
+        let changed = try writeSampleFileSystem(turretOffset: 3 * 65536, modelPadding: 4)
+        let model = try AssetBakeCache(directory: bakeDirectory).model(contentsOf: changed.openFile(at: "objects3d/test.3do"))
+        assertEqual(model, try decodedModel(in: changed))
+        XCTAssertEqual(try bakedFiles().count, 2)
+    }
+
+    func testCorruptBakeIsDecodedAgain() throws {
+        let fileSystem = try writeSampleFileSystem()
+        _ = try AssetBakeCache(directory: bakeDirectory).script(contentsOf: fileSystem.openFile(at: "scripts/test.cob"))
+
+        for url in try bakedFiles() {
+            var data = try Data(contentsOf: url)
+            data.removeLast(data.count / 2)
+            try data.write(to: url)
+        }
+
+        let script = try AssetBakeCache(directory: bakeDirectory).script(contentsOf: fileSystem.openFile(at: "scripts/test.cob"))
+        assertEqual(script, try decodedScript(in: fileSystem))
+    }
+
+    static var allTests = [
+        ("testBakedAssetsMatchDecoded", testBakedAssetsMatchDecoded),
+        ("testChangedArchiveIsBakedAgain", testChangedArchiveIsBakedAgain),
+        ("testCorruptBakeIsDecodedAgain", testCorruptBakeIsDecodedAgain),
+    ]
+}
+
+private extension AssetBakeCacheTests {
+
+    func decodedModel(in fileSystem: FileSystem) throws -> UnitModel {
+        return try UnitModel(contentsOf: fileSystem.openFile(at: "objects3d/test.3do"))
+    }
+
+    func decodedScript(in fileSystem: FileSystem) throws -> UnitScript {
+        return try UnitScript(contentsOf: fileSystem.openFile(at: "scripts/test.cob"))
+    }
+
+    func gafItem(in fileSystem: FileSystem) throws -> (GafItem, FileSystem.FileHandle) {
+        let gaf = try fileSystem.openFile(at: "anims/test.gaf")
+        return (try GafListing(withContentsOf: gaf).items[0], gaf)
+    }
+
+    func bakedFiles() throws -> [URL] {
+        return try FileManager.default.contentsOfDirectory(at: bakeDirectory, includingPropertiesForKeys: nil)
+    }
+
+    func assertEqual(_ a: UnitModel, _ b: UnitModel, file: StaticString = #file, line: UInt = #line) {
+        XCTAssertEqual(a.pieces.map { $0.name }, b.pieces.map { $0.name }, file: file, line: line)
+        XCTAssertEqual(a.pieces.map { $0.offset }, b.pieces.map { $0.offset }, file: file, line: line)
+        XCTAssertEqual(a.pieces.map { $0.primitives }, b.pieces.map { $0.primitives }, file: file, line: line)
+        XCTAssertEqual(a.pieces.map { $0.children }, b.pieces.map { $0.children }, file: file, line: line)
+        XCTAssertEqual(a.primitives.map { $0.texture }, b.primitives.map { $0.texture }, file: file, line: line)
+        XCTAssertEqual(a.primitives.map { $0.indices }, b.primitives.map { $0.indices }, file: file, line: line)
+        XCTAssertEqual(a.vertices, b.vertices, file: file, line: line)
+        XCTAssertEqual(a.textures, b.textures, file: file, line: line)
+        XCTAssertEqual(a.root, b.root, file: file, line: line)
+        XCTAssertEqual(a.groundPlate, b.groundPlate, file: file, line: line)
+        XCTAssertEqual(a.nameLookup, b.nameLookup, file: file, line: line)
+    }
+
+    func assertEqual(_ a: UnitScript, _ b: UnitScript, file: StaticString = #file, line: UInt = #line) {
+        XCTAssertEqual(a.code, b.code, file: file, line: line)
+        XCTAssertEqual(a.modules.map { $0.name }, b.modules.map { $0.name }, file: file, line: line)
+        XCTAssertEqual(a.modules.map { $0.offset }, b.modules.map { $0.offset }, file: file, line: line)
+        XCTAssertEqual(a.modules.map { $0.localCount }, b.modules.map { $0.localCount }, file: file, line: line)
+        XCTAssertEqual(a.numberOfStaticVariables, b.numberOfStaticVariables, file: file, line: line)
+        XCTAssertEqual(a.pieces, b.pieces, file: file, line: line)
+    }
+
+    func assertEqual(_ a: [GafItem.Frame], _ b: [GafItem.Frame], file: StaticString = #file, line: UInt = #line) {
+        XCTAssertEqual(a.map { $0.data }, b.map { $0.data }, file: file, line: line)
+        XCTAssertEqual(a.map { $0.size }, b.map { $0.size }, file: file, line: line)
+        XCTAssertEqual(a.map { $0.offset }, b.map { $0.offset }, file: file, line: line)
+        XCTAssertEqual(a.map { $0.format }, b.map { $0.format }, file: file, line: line)
+    }
+
+    /// Writes an archive with a small model, script & GAF and mounts it.
+    func writeSampleFileSystem(turretOffset: Int32 = 65536, modelPadding: Int = 0) throws -> FileSystem {
+        let entries: [TestArchive.Entry] = [
+            .directory("objects3d", [ .file("test.3do", sampleModel(turretOffset: turretOffset) + repeatElement(0, count: modelPadding)) ]),
+            .directory("scripts", [ .file("test.cob", sampleScript()) ]),
+            .directory("anims", [ .file("test.gaf", sampleGaf()) ]),
+        ]
+        try TestArchive.write(entries, to: directory.appendingPathComponent("sample.hpi"))
+        return try FileSystem(mergingHpisIn: directory)
+    }
+
+    /// A 3DO with a "base" piece (a single triangle, which is also the ground plate) and a "turret" child piece.
+    func sampleModel(turretOffset: Int32) -> [UInt8] {
+        var bytes: [UInt8] = []
+        // base @0
+        bytes.append(le: [1, 3, 1, 0, 0, 0, 0, 104, 0, 116, 152, 0, 52] as [UInt32])
+        // turret @52
+        bytes.append(le: [1, 0, 0, UInt32(bitPattern: -1), UInt32(bitPattern: turretOffset), 0, 0, 109, 0, 116, 152, 0, 0] as [UInt32])
+        bytes.append(contentsOf: Array("base\0turret\0".utf8))
+        // vertices @116
+        bytes.append(le: [0, 0, 0, 65536, 0, 0, 0, 0, 65536] as [UInt32])
+        // primitive @152; indices @184
+        bytes.append(le: [5, 3, 0, 184, 0, 0, 0, 0] as [UInt32])
+        bytes.append(le: [0, 1, 2] as [UInt16])
+        return bytes
+    }
+
+    /// A COB with two modules ("Create" having two locals) and one piece.
+    func sampleScript() -> [UInt8] {
+        var bytes: [UInt8] = []
+        bytes.append(le: [4, 2, 1, 10, 3, 0, 92, 100, 108, 52, 112, 131, 0] as [UInt32])
+        // code @52
+        bytes.append(le: [0x10022000, 0x10022000, 0x10021001, 1, 0x10023002, 0, 0x10065000,
+                          0x10021001, 0, 0x10065000] as [UInt32])
+        // module offsets @92, module names @100, piece names @108
+        bytes.append(le: [0, 7, 112, 119, 126] as [UInt32])
+        bytes.append(contentsOf: Array("Create\0Killed\0base\0".utf8))
+        return bytes
+    }
+
+    /// A GAF with a single item of two frames: one paletted and one 4444.
+    func sampleGaf() -> [UInt8] {
+        var pixels4444: [UInt8] = []
+        pixels4444.append(le: [0xF123, 0xF456, 0x0789, 0xFABC] as [UInt16])
+        return makeSampleGaf(frames: [
+            SampleGafFrame(size: (4, 3), offset: (2, 1), encoding: 0, data: (0..<12).map { UInt8($0 * 7) }),
+            SampleGafFrame(size: (2, 2), offset: (1, 1), encoding: 4, data: pixels4444),
+        ])
+    }
+
+}
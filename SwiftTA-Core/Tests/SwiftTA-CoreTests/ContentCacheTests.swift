@@ -0,0 +1,116 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class ContentCacheTests: XCTestCase {
+
+    private typealias ContentCache = FileSystem.ContentCache
+
+    func testEvictsLeastRecentlyUsedWhenOverBudget() {
+        let cache = ContentCache(byteBudget: 300)
+        cache.insert(contents(100), for: key(1))
+        cache.insert(contents(100), for: key(2))
+        cache.insert(contents(100), for: key(3))
+
+        // Touching the oldest file makes the second one the next to go.
+        XCTAssertNotNil(cache.data(for: key(1)))
+        cache.insert(contents(100), for: key(4))
+
+        XCTAssertNil(cache.data(for: key(2)))
+        XCTAssertNotNil(cache.data(for: key(1)))
+        XCTAssertNotNil(cache.data(for: key(3)))
+        XCTAssertNotNil(cache.data(for: key(4)))
+
+        // A larger file pushes out as many of the oldest as it needs to.
+        cache.insert(contents(250), for: key(5))
+        XCTAssertNil(cache.data(for: key(3)))
+        XCTAssertNil(cache.data(for: key(1)))
+        XCTAssertNil(cache.data(for: key(4)))
+        XCTAssertEqual(cache.data(for: key(5)), contents(250))
+
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.count, 1)
+        XCTAssertEqual(statistics.byteCount, 250)
+        XCTAssertEqual(statistics.evictions, 4)
+    }
+
+    func testRejectsFileLargerThanBudget() {
+        let cache = ContentCache(byteBudget: 100)
+        cache.insert(contents(60), for: key(1))
+        cache.insert(contents(101), for: key(2))
+
+        XCTAssertNil(cache.data(for: key(2)))
+        XCTAssertEqual(cache.data(for: key(1)), contents(60))
+
+        let statistics = cache.statistics
+        XCTAssertEqual(statistics.count, 1)
+        XCTAssertEqual(statistics.byteCount, 60)
+        XCTAssertEqual(statistics.evictions, 0)
+    }
+
+    func testCountsHitsMissesAndEvictions() {
+        let cache = ContentCache(byteBudget: 100)
+        XCTAssertNil(cache.data(for: key(1)))
+        cache.insert(contents(50), for: key(1))
+        XCTAssertNotNil(cache.data(for: key(1)))
+        XCTAssertNotNil(cache.data(for: key(1)))
+        cache.insert(contents(60), for: key(2))
+        XCTAssertNil(cache.data(for: key(1)))
+
+        var statistics = cache.statistics
+        XCTAssertEqual(statistics.hits, 2)
+        XCTAssertEqual(statistics.misses, 2)
+        XCTAssertEqual(statistics.evictions, 1)
+        XCTAssertEqual(statistics.count, 1)
+        XCTAssertEqual(statistics.byteCount, 60)
+
+        // Emptying the cache keeps the running totals.
+        cache.removeAll()
+        statistics = cache.statistics
+        XCTAssertEqual(statistics.hits, 2)
+        XCTAssertEqual(statistics.count, 0)
+        XCTAssertEqual(statistics.byteCount, 0)
+    }
+
+    func testHandlesShareCachedFile() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let bytes = (0 ..< 100_000).map { UInt8(truncatingIfNeeded: $0 &* 7) }
+        let url = directory.appendingPathComponent("test.hpi")
+        try TestArchive.write([ .directory("data", [ .chunkedFile("shared.bin", bytes) ]) ], to: url)
+
+        let fileSystem = try FileSystem(hpi: url)
+        fileSystem.contentCache = ContentCache(byteBudget: 1 << 20)
+
+        let first = try fileSystem.openFile(at: "data/shared.bin")
+        let second = try fileSystem.openFile(at: "data/shared.bin")
+        XCTAssertEqual(first.readDataToEndOfFile(), Data(bytes))
+        XCTAssertEqual(second.readDataToEndOfFile(), Data(bytes))
+
+        let statistics = fileSystem.contentCache!.statistics
+        XCTAssertEqual(statistics.count, 1)
+        XCTAssertEqual(statistics.byteCount, bytes.count)
+        XCTAssertEqual(statistics.misses, 1)
+        XCTAssertEqual(statistics.hits, 1)
+    }
+
+    static var allTests = [
+        ("testEvictsLeastRecentlyUsedWhenOverBudget", testEvictsLeastRecentlyUsedWhenOverBudget),
+        ("testRejectsFileLargerThanBudget", testRejectsFileLargerThanBudget),
+        ("testCountsHitsMissesAndEvictions", testCountsHitsMissesAndEvictions),
+        ("testHandlesShareCachedFile", testHandlesShareCachedFile),
+    ]
+}
+
+private extension ContentCacheTests {
+
+    func key(_ n: Int) -> ContentCache.Key {
+        return ContentCache.Key(archiveURL: URL(fileURLWithPath: "/test.hpi"), offset: n * 1000)
+    }
+
+    func contents(_ size: Int) -> Data {
+        return Data((0 ..< size).map { UInt8(truncatingIfNeeded: $0) })
+    }
+
+}
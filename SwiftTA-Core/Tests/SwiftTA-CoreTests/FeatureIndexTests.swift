@@ -0,0 +1,78 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class FeatureIndexTests: XCTestCase {
+
+    private var directory: URL!
+    private var indexURL: URL { return directory.appendingPathComponent("filesystem.index") }
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try! FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    func testIndexesEveryTopLevelObject() throws {
+        let index = try writeSampleFileSystem().featureIndex
+
+        XCTAssertEqual(index.count, 4)
+        XCTAssertEqual(index.entries(for: FeatureTypeId(named: "Rock")).map { index.directory(of: $0) }, ["All Worlds", "green"])
+        XCTAssertEqual(index.entries(for: FeatureTypeId(named: "tree1")).map { index.file(of: $0).name }, ["trees.tdf"])
+        XCTAssertTrue(index.entries(for: FeatureTypeId(named: "inner")).isEmpty)
+
+        XCTAssertEqual(index.preferredEntry(for: FeatureTypeId(named: "rock"), planetDirectory: "green").map { index.directory(of: $0) }, "green")
+        XCTAssertEqual(index.preferredEntry(for: FeatureTypeId(named: "rock"), planetDirectory: "moon").map { index.directory(of: $0) }, "All Worlds")
+    }
+
+    func testCollectsFeaturesAndWhatTheyBecome() throws {
+        let fileSystem = try writeSampleFileSystem()
+
+        let features = MapFeatureInfo.collectFeatures([FeatureTypeId(named: "tree1"), FeatureTypeId(named: "rock")], planet: "Green Planet", filesystem: fileSystem)
+        XCTAssertEqual(Set(features.keys.map { $0.name }), ["tree1", "rock", "tree1dead", "smudge01"])
+        XCTAssertEqual(features[FeatureTypeId(named: "rock")]?.footprint, Size2<Int>(width: 2, height: 2))
+        XCTAssertEqual(features[FeatureTypeId(named: "tree1dead")]?.height, 7)
+
+        let elsewhere = MapFeatureInfo.collectFeatures([FeatureTypeId(named: "rock")], planet: "Lunar", filesystem: fileSystem)
+        XCTAssertEqual(elsewhere[FeatureTypeId(named: "rock")]?.footprint, Size2<Int>(width: 1, height: 1))
+    }
+
+    func testCachedIndexMatchesScanned() throws {
+        let scanned = try writeSampleFileSystem(indexed: true).featureIndex
+        XCTAssertTrue(FileManager.default.fileExists(atPath: indexURL.appendingPathExtension("features").path))
+
+        let cached = try FileSystem(mergingHpisIn: directory, indexURL: indexURL).featureIndex
+        XCTAssertEqual(cached.count, scanned.count)
+        for name in ["rock", "tree1", "tree1dead", "smudge01"] {
+            let id = FeatureTypeId(named: name)
+            XCTAssertEqual(cached.entries(for: id).map { $0.offset }, scanned.entries(for: id).map { $0.offset })
+            XCTAssertEqual(cached.entries(for: id).map { cached.file(of: $0).info.offset }, scanned.entries(for: id).map { scanned.file(of: $0).info.offset })
+        }
+    }
+
+    static var allTests = [
+        ("testIndexesEveryTopLevelObject", testIndexesEveryTopLevelObject),
+        ("testCollectsFeaturesAndWhatTheyBecome", testCollectsFeaturesAndWhatTheyBecome),
+        ("testCachedIndexMatchesScanned", testCachedIndexMatchesScanned),
+    ]
+}
+
+private extension FeatureIndexTests {
+
+    /// Writes an archive with a few features in "green" & "All Worlds" and mounts it.
+    func writeSampleFileSystem(indexed: Bool = false) throws -> FileSystem {
+        let trees = "[TREE1]\n{\n\tworld=greenworld;\n\tfeaturedead=tree1dead;\n\t[inner]{ x=1; }\n}\n[rock]{ footprintx=2; footprintz=2; indestructible=1; }\n"
+        let common = "// Shared features\n[Tree1Dead]\n{\n\theight=7;\n}\n[smudge01]{ indestructible=1; }\n[rock]{ indestructible=1; }\n"
+        let entries: [TestArchive.Entry] = [
+            .directory("features", [
+                .directory("All Worlds", [ .file("common.tdf", Array(common.utf8)) ]),
+                .directory("green", [ .file("trees.tdf", Array(trees.utf8)) ]),
+            ]),
+        ]
+        try TestArchive.write(entries, to: directory.appendingPathComponent("sample.hpi"))
+        return try FileSystem(mergingHpisIn: directory, indexURL: indexed ? indexURL : nil)
+    }
+
+}
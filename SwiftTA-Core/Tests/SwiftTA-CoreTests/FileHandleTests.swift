@@ -0,0 +1,93 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class FileHandleTests: XCTestCase {
+
+    private var directory: URL!
+    private var fileSystem: FileSystem!
+    /// The chunked file's contents, extracted whole.
+    private var whole: Data!
+
+    private let chunkSize = TestArchive.chunkSize
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try! FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        // Seven chunks; more than a handle caches, so the file is read a chunk at a time.
+        let bytes = (0 ..< chunkSize * 6 + 1000).map { UInt8(truncatingIfNeeded: ($0 &* 31) ^ ($0 >> 16)) }
+        let url = directory.appendingPathComponent("test.hpi")
+        try! TestArchive.write([ .chunkedFile("big.bin", bytes) ], to: url)
+
+        fileSystem = try! FileSystem(hpi: url)
+        fileSystem.contentCache = FileSystem.ContentCache(byteBudget: 1 << 24)
+        whole = try! HpiArchive(contentsOf: url).extract(file: fileSystem.root[file: "big.bin"]!.info)
+        XCTAssertEqual(whole, Data(bytes))
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    func testReadSpanningChunkBoundary() throws {
+        let handle = try fileSystem.openFile(at: "big.bin")
+
+        let extracted = try countingChunkExtracts {
+            handle.seek(toFileOffset: chunkSize - 100)
+            XCTAssertEqual(handle.readData(ofLength: 300), whole[(chunkSize - 100) ..< (chunkSize + 200)])
+            XCTAssertEqual(handle.fileOffset, chunkSize + 200)
+        }
+
+        XCTAssertEqual(extracted, 2)
+        XCTAssertEqual(fileSystem.contentCache!.statistics.count, 0)
+    }
+
+    func testRepeatedReadIsServedFromChunkCache() throws {
+        let handle = try fileSystem.openFile(at: "big.bin")
+        let range = (chunkSize * 3 + 10) ..< (chunkSize * 3 + 5000)
+
+        let extracted = try countingChunkExtracts {
+            handle.seek(toFileOffset: range.lowerBound)
+            XCTAssertEqual(handle.readData(ofLength: range.count), whole[range])
+            handle.seek(toFileOffset: range.lowerBound)
+            XCTAssertEqual(handle.readData(ofLength: range.count), whole[range])
+        }
+
+        XCTAssertEqual(extracted, 1)
+    }
+
+    func testReadOfManyChunksExtractsWhole() throws {
+        let handle = try fileSystem.openFile(at: "big.bin")
+        let range = 100 ..< (100 + chunkSize * 5)
+
+        let extracted = try countingChunkExtracts {
+            handle.seek(toFileOffset: range.lowerBound)
+            XCTAssertEqual(handle.readData(ofLength: range.count), whole[range])
+            XCTAssertEqual(handle.readDataToEndOfFile(), whole[range.upperBound...])
+        }
+
+        // The whole file was extracted at once (and so shared through the content cache), rather than chunk by chunk.
+        XCTAssertEqual(extracted, 0)
+        XCTAssertEqual(fileSystem.contentCache!.statistics.count, 1)
+        XCTAssertEqual(fileSystem.contentCache!.statistics.byteCount, whole.count)
+    }
+
+    static var allTests = [
+        ("testReadSpanningChunkBoundary", testReadSpanningChunkBoundary),
+        ("testRepeatedReadIsServedFromChunkCache", testRepeatedReadIsServedFromChunkCache),
+        ("testReadOfManyChunksExtractsWhole", testReadOfManyChunksExtractsWhole),
+    ]
+}
+
+private extension FileHandleTests {
+
+    /// The number of chunks individually extracted from the archive during `body`; as recorded by `Trace`.
+    func countingChunkExtracts(_ body: () throws -> Void) throws -> Int {
+        Trace.start()
+        defer { Trace.stop() }
+        try body()
+        let json = String(decoding: Trace.chromeTraceJSON(), as: UTF8.self)
+        return json.components(separatedBy: "\"name\":\"HPI Extract Chunk\"").count - 1
+    }
+
+}
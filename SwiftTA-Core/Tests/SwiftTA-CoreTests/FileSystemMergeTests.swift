@@ -0,0 +1,199 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class FileSystemMergeTests: XCTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try! FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    func testConcurrentParsingMatchesSequential() throws {
+        let archives = try (0..<24).map { try HpiArchive(contentsOf: writeSampleArchive(number: $0, extension: "hpi")) }
+
+        let sequential = try archives.map { FileSystem.Directory(from: try $0.loadDirectory(), in: $0.url) }
+        let concurrent = try FileSystem.loadDirectories(of: archives)
+
+        XCTAssertEqual(sequential.map { listing(of: $0) }, concurrent.map { listing(of: $0) })
+        XCTAssertEqual(listing(of: FileSystem.merge(sequential)), listing(of: FileSystem.merge(concurrent)))
+    }
+
+    func testMergedFileSystemMatchesSequentialMerge() throws {
+        // One archive per weighted extension, so that the merge order is fully determined.
+        let urls = try FileSystem.weightedArchiveExtensions.enumerated().map { try writeSampleArchive(number: $0, extension: $1) }
+        let sequential = try urls
+            .map { (url) -> FileSystem.Directory in FileSystem.Directory(from: try HpiArchive(contentsOf: url).loadDirectory(), in: url) }
+            .reduce(FileSystem.Directory()) { $0.adding(directory: $1) }
+
+        let fileSystem = try FileSystem(mergingHpisIn: directory)
+        XCTAssertEqual(listing(of: sequential), listing(of: fileSystem.root))
+
+        // The highest weighted archive wins.
+        let shared = fileSystem.root[directory: "units"]?[file: "ARMCOM.FBI"]
+        XCTAssertEqual(shared?.archiveURL.pathExtension, FileSystem.weightedArchiveExtensions.first)
+
+        // Building and then reading the index gives the same tree.
+        let indexURL = directory.appendingPathComponent("filesystem.index")
+        let indexed1 = try FileSystem(mergingHpisIn: directory, indexURL: indexURL)
+        let indexed2 = try FileSystem(mergingHpisIn: directory, indexURL: indexURL)
+        XCTAssertEqual(listing(of: sequential), listing(of: indexed1.root))
+        XCTAssertEqual(listing(of: sequential), listing(of: indexed2.root))
+    }
+
+    func testRejectsCyclicIndexTree() throws {
+        // A root whose only child is a directory that claims the root as its own child.
+        var writer = BinaryWriter()
+        writer.write(UInt32(0))                             // root
+        writer.write(UInt32(0))                             // archives
+        writer.write(UInt32(2)); writer.write(""); writer.write("units")
+        writer.write(UInt32(2)); writer.write(""); writer.write("units")
+        writer.write(UInt32(2))
+        [0, 0, 1, 1, 1, 1, 0, 1].forEach { writer.write(UInt32($0)) }
+        writer.write(UInt32(0))                             // files
+
+        let url = directory.appendingPathComponent("cyclic.index")
+        try writer.data.write(to: url)
+        var reader = BinaryReader(index: try MappedFile(contentsOf: url))
+        XCTAssertThrowsError(try reader.readTree(archiveURLs: [], indexingPaths: true))
+    }
+
+    static var allTests = [
+        ("testConcurrentParsingMatchesSequential", testConcurrentParsingMatchesSequential),
+        ("testMergedFileSystemMatchesSequentialMerge", testMergedFileSystemMatchesSequentialMerge),
+        ("testRejectsCyclicIndexTree", testRejectsCyclicIndexTree),
+    ]
+}
+
+private extension FileSystemMergeTests {
+
+    /// A sorted, flattened description of every item in a directory tree, including where each file comes from.
+    func listing(of directory: FileSystem.Directory, path: String = "") -> [String] {
+        return directory.items.flatMap { (item) -> [String] in
+            switch item {
+            case .file(let f):
+                return ["\(path)/\(f.name) \(f.archiveURL.lastPathComponent) @\(f.info.offset) \(f.info.size)"]
+            case .directory(let d):
+                return ["\(path)/\(d.name)/"] + listing(of: d, path: path + "/" + d.name)
+            }
+        }.sorted()
+    }
+
+    /// Writes an archive that shares some of its files with every other sample archive (in varying case) and has some of its own.
+    func writeSampleArchive(number: Int, extension ext: String) throws -> URL {
+        let contents: (Int) -> [UInt8] = { (size) in (0..<size).map { UInt8(truncatingIfNeeded: $0 &+ number) } }
+        let entries: [TestArchive.Entry] = [
+            .directory("units", [
+                .file(number % 2 == 0 ? "armcom.fbi" : "ARMCOM.FBI", contents(10 + number)),
+                .file("unit\(number).fbi", contents(32)),
+            ]),
+            .directory(number % 3 == 0 ? "Objects3d" : "objects3d", [
+                .file("armcom.3do", contents(64 + number)),
+                .file("model\(number).3do", contents(16)),
+            ]),
+            .directory("mod\(number)", [
+                .directory("nested", [ .file("readme.txt", contents(number)) ]),
+            ]),
+            .file("archive\(number).txt", contents(number)),
+        ]
+        let url = directory.appendingPathComponent("archive\(number).\(ext)")
+        try TestArchive.write(entries, to: url)
+        return url
+    }
+
+}
+
+/// Writes minimal, unencrypted Total Annihilation HPI archives.
+enum TestArchive {
+
+    indirect enum Entry {
+        case file(String, [UInt8])
+        /// A file split into 64 KB chunks, as TA stores compressed files; each chunk is stored with the "none" chunk compression.
+        case chunkedFile(String, [UInt8])
+        /// A file of `size` bytes stored as a single LZ77 compressed chunk.
+        case lz77File(String, size: Int, compressed: [UInt8])
+        case directory(String, [Entry])
+    }
+
+    static let chunkSize = 65536
+
+    static func write(_ entries: [Entry], to url: URL) throws {
+        var data: [UInt8] = []
+
+        func append(_ value: UInt32) {
+            withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+        }
+        func patch(_ value: UInt32, at offset: Int) {
+            withUnsafeBytes(of: value.littleEndian) { data.replaceSubrange(offset ..< offset + 4, with: $0) }
+        }
+
+        func appendChunkedFile(_ name: String, size: Int, chunks: [(compression: UInt8, size: Int, data: ArraySlice<UInt8>)], at entry: Int) {
+            data.append(contentsOf: Array(name.utf8) + [0])
+            let contentsOffset = data.count
+            chunks.forEach { append(UInt32(19 + $0.data.count)) }
+            for chunk in chunks {
+                append(0x48535153) // 'SQSH'
+                data.append(contentsOf: [2, chunk.compression, 0]) // unencrypted
+                append(UInt32(chunk.data.count))
+                append(UInt32(chunk.size))
+                append(chunk.data.reduce(0) { $0 &+ UInt32($1) })
+                data.append(contentsOf: chunk.data)
+            }
+            patch(UInt32(data.count), at: entry + 4)
+            data[entry + 8] = 0
+            append(UInt32(contentsOffset))
+            append(UInt32(size))
+            data.append(1) // LZ77; so that the file is read as chunks
+        }
+
+        // The directory (with each file's contents inline) simply follows the header; all of its offsets are absolute.
+        func appendDirectory(_ entries: [Entry]) {
+            append(UInt32(entries.count))
+            append(UInt32(data.count + 4))
+            let entryArray = data.count
+            data.append(contentsOf: repeatElement(0, count: entries.count * 9))
+
+            for (i, entry) in entries.enumerated() {
+                let at = entryArray + i * 9
+                patch(UInt32(data.count), at: at)
+                switch entry {
+                case let .file(name, contents):
+                    data.append(contentsOf: Array(name.utf8) + [0])
+                    let contentsOffset = data.count
+                    data.append(contentsOf: contents)
+                    patch(UInt32(data.count), at: at + 4)
+                    data[at + 8] = 0
+                    append(UInt32(contentsOffset))
+                    append(UInt32(contents.count))
+                    data.append(0)
+                case let .chunkedFile(name, contents):
+                    let chunks = stride(from: 0, to: contents.count, by: chunkSize).map { contents[$0 ..< min($0 + chunkSize, contents.count)] }
+                    appendChunkedFile(name, size: contents.count, chunks: chunks.map { (compression: 0, size: $0.count, data: $0) }, at: at)
+                case let .lz77File(name, size, compressed):
+                    appendChunkedFile(name, size: size, chunks: [(compression: 1, size: size, data: compressed[...])], at: at)
+                case let .directory(name, children):
+                    data.append(contentsOf: Array(name.utf8) + [0])
+                    patch(UInt32(data.count), at: at + 4)
+                    data[at + 8] = 1
+                    appendDirectory(children)
+                }
+            }
+        }
+
+        append(0x49504148) // 'HAPI'
+        append(0x00010000) // Total Annihilation
+        append(0)          // directory size (patched below)
+        append(0)          // header key; unencrypted
+        append(20)         // offset to directory
+        appendDirectory(entries)
+        patch(UInt32(data.count - 20), at: 8)
+
+        try Data(data).write(to: url)
+    }
+
+}
@@ -0,0 +1,68 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class FileSystemPathTests: XCTestCase {
+
+    private let root = FileSystem.Directory(merging: [
+        FileSystem.Directory(from: HpiItem.Directory(name: "", items: [
+            .directory(HpiItem.Directory(name: "Objects3d", items: [
+                .file(HpiItem.File(name: "ARMCOM.3DO", size: 1, offset: 100, compression: .none, compressedSize: 0)),
+                .file(HpiItem.File(name: "corcom.3do", size: 2, offset: 200, compression: .none, compressedSize: 0)),
+            ])),
+            .directory(HpiItem.Directory(name: "anims", items: [
+                .directory(HpiItem.Directory(name: "units", items: [
+                    .file(HpiItem.File(name: "armcom.gaf", size: 3, offset: 300, compression: .none, compressedSize: 0)),
+                ])),
+            ])),
+            .file(HpiItem.File(name: "readme.txt", size: 4, offset: 400, compression: .none, compressedSize: 0)),
+        ]), in: URL(fileURLWithPath: "/test.hpi")),
+    ])
+
+    func testFindsEveryPathCaseInsensitively() {
+        XCTAssertEqual(root.file(atPath: "objects3d/armcom.3do")?.info.offset, 100)
+        XCTAssertEqual(root.file(atPath: "OBJECTS3D/CorCom.3DO")?.info.offset, 200)
+        XCTAssertEqual(root.file(atPath: "/anims/units/ARMCOM.GAF")?.info.offset, 300)
+        XCTAssertEqual(root.file(atPath: "readme.txt")?.info.offset, 400)
+        XCTAssertEqual(root.directory(atPath: "anims/units")?.name, "units")
+        XCTAssertEqual((try? root.resolve(path: "Objects3D/armcom.3do"))?.asFile()?.info.offset, 100)
+    }
+
+    func testRejectsPartialAndMisplacedPaths() {
+        XCTAssertNil(root.item(atPath: ""))
+        XCTAssertNil(root.item(atPath: "armcom.3do"))
+        XCTAssertNil(root.item(atPath: "anims/armcom.gaf"))
+        XCTAssertNil(root.item(atPath: "objects3d/armcom.3do/"))
+        XCTAssertNil(root.item(atPath: "objects3d//armcom.3do"))
+        XCTAssertNil(root.item(atPath: "units/armcom.gaf"))
+    }
+
+    func testLooksUpRelativeToSubdirectory() {
+        let anims = root.directory(atPath: "anims")
+        XCTAssertEqual(anims?.file(atPath: "units/armcom.gaf")?.info.offset, 300)
+        XCTAssertNil(anims?.item(atPath: "readme.txt"))
+        XCTAssertEqual(anims?[directory: "units"]?.file(atPath: "armcom.gaf")?.info.offset, 300)
+    }
+
+    func testByteLookup() {
+        let path = "anims/units/armcom.gaf"
+        let found = Array(path.utf8).withUnsafeBytes { root.item(atPath: $0) }
+        XCTAssertEqual(found?.asFile()?.info.offset, 300)
+    }
+
+    func testFindsChildByNameInAnyCase() {
+        XCTAssertEqual(root[directory: "OBJECTS3D"]?[file: "ArmCom.3do"]?.info.offset, 100)
+        XCTAssertEqual(root[directory: "objects3d"]?[file: "CORCOM.3DO"]?.info.offset, 200)
+        XCTAssertEqual(root[file: "README.TXT"]?.info.offset, 400)
+        XCTAssertNil(root["objects3"])
+        XCTAssertNil(root["objects3dx"])
+        XCTAssertNil(root[directory: "anims"]?["armcom.gaf"])
+    }
+
+    static var allTests = [
+        ("testFindsEveryPathCaseInsensitively", testFindsEveryPathCaseInsensitively),
+        ("testRejectsPartialAndMisplacedPaths", testRejectsPartialAndMisplacedPaths),
+        ("testLooksUpRelativeToSubdirectory", testLooksUpRelativeToSubdirectory),
+        ("testByteLookup", testByteLookup),
+        ("testFindsChildByNameInAnyCase", testFindsChildByNameInAnyCase),
+    ]
+}
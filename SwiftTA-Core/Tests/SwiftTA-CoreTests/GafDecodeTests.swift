@@ -0,0 +1,112 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class GafDecodeTests: XCTestCase {
+
+    private let runLengthEncoded: [UInt8] = [5, 5, 0, 0, 1, 2, 3, 4, 0, 7, 8, 0]
+    private let composited: [UInt8] = [14, 14, 0, 0, 0, 9, 0, 0, 0, 10, 11, 0]
+
+    func testExtractsFrames() throws {
+        let (item, gaf) = try sampleItem()
+        let frames = try item.extractFrames(from: gaf)
+        XCTAssertEqual(frames.map { Array($0.data) }, [runLengthEncoded, composited])
+    }
+
+    func testDecodesIntoStridedRect() throws {
+        let (item, gaf) = try sampleItem()
+
+        for (index, expected) in [runLengthEncoded, composited].enumerated() {
+            // A 6x5 image, with the frame going in at (1, 1).
+            var image = [UInt8](repeating: 0xFF, count: 6 * 5)
+            let metadata = try image.withUnsafeMutableBytes {
+                try item.decodeFrame(index: index, from: gaf, into: GafItem.FrameDestination(pixels: $0.baseAddress! + 7, bytesPerRow: 6, format: .native))
+            }
+            XCTAssertEqual(metadata.size, Size2<Int>(width: 4, height: 3))
+            XCTAssertEqual(metadata.format, .paletteIndex)
+
+            for y in 0 ..< 5 {
+                for x in 0 ..< 6 {
+                    let inside = (1 ..< 5).contains(x) && (1 ..< 4).contains(y)
+                    XCTAssertEqual(image[y * 6 + x], inside ? expected[(y - 1) * 4 + (x - 1)] : 0xFF, "frame \(index) at \(x), \(y)")
+                }
+            }
+        }
+    }
+
+    func testDecodesThroughPalette() throws {
+        let (item, gaf) = try sampleItem()
+        let palette = Palette((0 ..< 256).map { Palette.Color(red: UInt8($0), green: UInt8($0 / 2), blue: UInt8(255 - $0), alpha: $0 == 0 ? 0 : 255) })
+
+        for index in 0 ..< item.numberOfFrames {
+            let frame = try item.extractFrame(index: index, from: gaf)
+            var image = [UInt8](repeating: 0, count: frame.size.area * 4)
+            try image.withUnsafeMutableBytes {
+                try item.decodeFrame(index: index, from: gaf, into: GafItem.FrameDestination(pixels: $0.baseAddress!, bytesPerRow: frame.size.width * 4, format: .rgba(palette)))
+            }
+            XCTAssertEqual(Data(image), palette.mapIndicesRgba(frame.data, size: frame.size))
+        }
+    }
+
+    static var allTests = [
+        ("testExtractsFrames", testExtractsFrames),
+        ("testDecodesIntoStridedRect", testDecodesIntoStridedRect),
+        ("testDecodesThroughPalette", testDecodesThroughPalette),
+    ]
+}
+
+private extension GafDecodeTests {
+
+    func sampleItem() throws -> (GafItem, DataFileHandle) {
+        let gaf = DataFileHandle(sampleGaf())
+        return (try GafListing(withContentsOf: gaf).items[0], gaf)
+    }
+
+    /**
+     A GAF with a single item of two 4x3 frames:
+     a run-length encoded frame, and one composited from an uncompressed subframe and a run-length encoded subframe
+     (the latter hanging off the top-left of the frame).
+     */
+    func sampleGaf() -> [UInt8] {
+        // frame data: a run of two 5s then a transparent pixel; a copy of four; a transparent pixel then a copy of two.
+        return makeSampleGaf(frames: [
+            SampleGafFrame(size: (4, 3), encoding: 1, data: [3, 0, 0x06, 5, 0x03, 5, 0, 0x0C, 1, 2, 3, 4, 4, 0, 0x03, 0x04, 7, 8]),
+            SampleGafFrame(size: (4, 3), offset: (1, 1), subframes: [
+                SampleGafFrame(size: (2, 2), encoding: 0, data: [9, 0, 10, 11]),
+                SampleGafFrame(size: (3, 2), offset: (2, 2), encoding: 1, data: [4, 0, 0x08, 12, 0, 13, 2, 0, 0x0A, 14]),
+            ]),
+        ])
+    }
+
+}
+
+private final class DataFileHandle: FileReadHandle {
+
+    let data: Data
+    var fileOffset = 0
+
+    init(_ bytes: [UInt8]) { data = Data(bytes) }
+
+    var fileName: String { return "test.gaf" }
+    var fileSize: Int { return data.count }
+
+    func readDataToEndOfFile() -> Data {
+        return readData(ofLength: data.count - fileOffset)
+    }
+
+    func readData(ofLength length: Int) -> Data {
+        let end = min(fileOffset + length, data.count)
+        defer { fileOffset = end }
+        return data.subdata(in: fileOffset ..< end)
+    }
+
+    func readData(verifyingLength length: Int) throws -> Data {
+        let read = readData(ofLength: length)
+        guard read.count == length else { throw CocoaError(.fileReadCorruptFile) }
+        return read
+    }
+
+    func seek(toFileOffset offset: Int) {
+        fileOffset = offset
+    }
+
+}
@@ -0,0 +1,46 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class HeightMapTests: XCTestCase {
+
+    /// A map that isn't square, with a sample size that isn't either; so that strides & scales can't be mixed up.
+    private let heightMap = HeightMap(samples: (0 ..< 7 * 5).map { UInt8(truncatingIfNeeded: $0 * 37) },
+                                      count: Size2<Int>(width: 7, height: 5),
+                                      sampleSize: Size2<Int>(width: 16, height: 12))
+
+    func testSamplesByMapPosition() {
+        XCTAssertEqual(heightMap.index(ofMapPosition: Point2<Int>(3, 2)), 2 * 7 + 3)
+        XCTAssertEqual(heightMap.height(atMapPosition: Point2<Int>(3, 2)), Int(heightMap.samples[2 * 7 + 3]))
+        XCTAssertEqual(heightMap.height(atMapIndex: 34), Int(UInt8(truncatingIfNeeded: 34 * 37)))
+    }
+
+    func testInterpolatesAlongEdges() {
+        // Past the left edge, and within the last row of samples.
+        let h = heightMap.height(atWorldPosition: Point2f(-8, 4.5 * 12))
+        XCTAssertEqual(h, GameFloat(heightMap.samples[4 * 7]))
+        // Along the top edge, halfway between two samples.
+        let top = heightMap.height(atWorldPosition: Point2f(2.5 * 16, -1))
+        XCTAssertEqual(top, (GameFloat(heightMap.samples[2]) + GameFloat(heightMap.samples[3])) / 2)
+    }
+
+    func testBatchedHeightsMatchSingleQueries() {
+        // Positions all over (and off) the map, including right on its edges; a count that leaves a partial batch.
+        var positions: [Point2f] = []
+        for y in stride(from: -20 as GameFloat, through: 5 * 12 + 20, by: 6.5) {
+            for x in stride(from: -20 as GameFloat, through: 7 * 16 + 20, by: 7.25) {
+                positions.append(Point2f(x, y))
+            }
+        }
+        positions += [Point2f(0, 0), Point2f(6 * 16, 4 * 12), Point2f(6 * 16, 0), Point2f(0, 4 * 12), Point2f(3 * 16, 4 * 12)]
+        XCTAssertNotEqual(positions.count % 8, 0)
+
+        XCTAssertEqual(heightMap.heights(atWorldPositions: positions), positions.map { heightMap.height(atWorldPosition: $0) })
+        XCTAssertEqual(heightMap.heights(atWorldPositions: []), [])
+    }
+
+    static var allTests = [
+        ("testSamplesByMapPosition", testSamplesByMapPosition),
+        ("testInterpolatesAlongEdges", testInterpolatesAlongEdges),
+        ("testBatchedHeightsMatchSingleQueries", testBatchedHeightsMatchSingleQueries),
+    ]
+}
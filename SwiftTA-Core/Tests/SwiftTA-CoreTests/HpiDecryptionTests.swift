@@ -0,0 +1,87 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class HpiDecryptionTests: XCTestCase {
+    
+    /// An odd size, so that the scalar tail of the vector loops is exercised too.
+    private let sampleSize = 4 * 1024 * 1024 + 13
+    private let sampleKey: Int32 = ~( (0x7D &* 4) | (0x7D >> 6) )
+    
+    private func makeSample() -> [UInt8] {
+        var rng = SystemRandomNumberGenerator()
+        return (0..<sampleSize).map { _ in UInt8.random(in: 0...255, using: &rng) }
+    }
+    
+    func testDecryptMatchesScalar() {
+        let source = makeSample()
+        for fileOffset in [0, 1, 31, 255, 1_000_003] {
+            var expected = [UInt8](repeating: 0, count: source.count)
+            var actual = [UInt8](repeating: 0, count: source.count)
+            source.withUnsafeBytes { s in
+                expected.withUnsafeMutableBytes { HpiItem.decryptScalar(s, into: $0, fileOffset: fileOffset, key: sampleKey) }
+                actual.withUnsafeMutableBytes { HpiItem.decrypt(s, into: $0, fileOffset: fileOffset, key: sampleKey) }
+            }
+            XCTAssertEqual(expected, actual, "fileOffset: \(fileOffset)")
+        }
+    }
+    
+    func testDecryptChunkMatchesScalar() {
+        let source = makeSample()
+        var expected = [UInt8](repeating: 0, count: source.count)
+        var actual = [UInt8](repeating: 0, count: source.count)
+        source.withUnsafeBytes { s in
+            expected.withUnsafeMutableBytes { HpiItem.decryptChunkScalar(s, into: $0) }
+            actual.withUnsafeMutableBytes { HpiItem.decryptChunk(s, into: $0) }
+        }
+        XCTAssertEqual(expected, actual)
+    }
+    
+    func testDecryptScalarPerformance() {
+        let source = makeSample()
+        var destination = [UInt8](repeating: 0, count: source.count)
+        measure {
+            source.withUnsafeBytes { s in
+                destination.withUnsafeMutableBytes { HpiItem.decryptScalar(s, into: $0, fileOffset: 20, key: sampleKey) }
+            }
+        }
+    }
+    
+    func testDecryptPerformance() {
+        let source = makeSample()
+        var destination = [UInt8](repeating: 0, count: source.count)
+        measure {
+            source.withUnsafeBytes { s in
+                destination.withUnsafeMutableBytes { HpiItem.decrypt(s, into: $0, fileOffset: 20, key: sampleKey) }
+            }
+        }
+    }
+    
+    func testDecryptChunkScalarPerformance() {
+        let source = makeSample()
+        var destination = [UInt8](repeating: 0, count: source.count)
+        measure {
+            source.withUnsafeBytes { s in
+                destination.withUnsafeMutableBytes { HpiItem.decryptChunkScalar(s, into: $0) }
+            }
+        }
+    }
+    
+    func testDecryptChunkPerformance() {
+        let source = makeSample()
+        var destination = [UInt8](repeating: 0, count: source.count)
+        measure {
+            source.withUnsafeBytes { s in
+                destination.withUnsafeMutableBytes { HpiItem.decryptChunk(s, into: $0) }
+            }
+        }
+    }
+    
+    static var allTests = [
+        ("testDecryptMatchesScalar", testDecryptMatchesScalar),
+        ("testDecryptChunkMatchesScalar", testDecryptChunkMatchesScalar),
+        ("testDecryptScalarPerformance", testDecryptScalarPerformance),
+        ("testDecryptPerformance", testDecryptPerformance),
+        ("testDecryptChunkScalarPerformance", testDecryptChunkScalarPerformance),
+        ("testDecryptChunkPerformance", testDecryptChunkPerformance),
+    ]
+}
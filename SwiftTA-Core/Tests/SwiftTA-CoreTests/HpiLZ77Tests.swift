@@ -0,0 +1,62 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class HpiLZ77Tests: XCTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+        try! FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    func testDecodesBackReferences() throws {
+        let compressed: [UInt8] = [
+            0b1100_0100,    // flags: literal, literal, match, literal, literal, literal, match, match
+            0x61, 0x62,     // "ab"
+            0x18, 0x00,     // window position 1 (2 back), length 10; overlaps its own output
+            0x58, 0x59, 0x5A, // "XYZ"
+            0x13, 0x00,     // window position 1 (15 back), length 5
+            0x00, 0x00,     // end of stream
+        ]
+        let expected = Array("ab" + "ababababab" + "XYZ" + "ababa").map { $0.asciiValue! }
+        XCTAssertEqual(try decompress(compressed, size: expected.count), expected)
+    }
+
+    func testWindowBeforeOutputReadsAsZero() throws {
+        let compressed: [UInt8] = [
+            0b0000_0101,    // flags: match, literal, match
+            0x51, 0x00,     // window position 5, length 3; nothing has been written there yet
+            0x61,           // "a"
+            0x00, 0x00,     // end of stream
+        ]
+        XCTAssertEqual(try decompress(compressed, size: 4), [0, 0, 0, 0x61])
+    }
+
+    func testThrowsOnMissingEndOfStream() throws {
+        let compressed: [UInt8] = [0b0000_0000, 0x61, 0x62]
+        XCTAssertThrowsError(try decompress(compressed, size: 2))
+    }
+
+    static var allTests = [
+        ("testDecodesBackReferences", testDecodesBackReferences),
+        ("testWindowBeforeOutputReadsAsZero", testWindowBeforeOutputReadsAsZero),
+        ("testThrowsOnMissingEndOfStream", testThrowsOnMissingEndOfStream),
+    ]
+}
+
+private extension HpiLZ77Tests {
+
+    /// Extracts `compressed`, as a single LZ77 chunk decompressing to `size` bytes, from a test archive.
+    func decompress(_ compressed: [UInt8], size: Int) throws -> [UInt8] {
+        let url = directory.appendingPathComponent("\(UUID().uuidString).hpi")
+        try TestArchive.write([ .lz77File("test.bin", size: size, compressed: compressed) ], to: url)
+        let file = try FileSystem(hpi: url).root[file: "test.bin"]!
+        return Array(try HpiArchive(contentsOf: url).extract(file: file.info))
+    }
+
+}
@@ -0,0 +1,112 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class IncrementalUnitTextureAtlasTests: XCTestCase {
+
+    /// Index 0 is transparent black; just like the empty parts of an RGBA page.
+    private let palette = Palette((0 ..< 256).map { $0 == 0 ? Palette.Color(red: 0, green: 0, blue: 0, alpha: 0) : Palette.Color(red: UInt8($0), green: UInt8($0 / 2), blue: UInt8(255 - $0), alpha: 255) })
+
+    /// Pages of 16x16 hold four of the 8x8 color textures.
+    private func makeAtlas() -> IncrementalUnitTextureAtlas {
+        return IncrementalUnitTextureAtlas(palette: palette, filesystem: FileSystem(), pageSize: Size2<Int>(width: 16, height: 16))
+    }
+
+    func testSharesTexturesAndKeepsThemInPlace() {
+        let atlas = makeAtlas()
+        let (pageA, a) = atlas.add([.color(1), .color(2)], from: ModelTexturePack())
+        let (pageB, b) = atlas.add([.color(2), .color(3), .image("missing")], from: ModelTexturePack())
+
+        XCTAssertEqual(pageA, 0)
+        XCTAssertEqual(pageB, 0)
+        XCTAssertEqual(atlas.pageCount, 1)
+        XCTAssertEqual(b.textures[0].location, a.textures[1].location)
+        XCTAssertEqual(b.textures[2].location, .zero)
+        XCTAssertEqual(atlas.occupancy(ofPage: 0), 0.75)
+
+        // Adding B didn't disturb A.
+        XCTAssertEqual(a.size, atlas.size(ofPage: 0))
+        assertFilled(atlas, page: 0, rect: a.textures[0].location, with: 1)
+        assertFilled(atlas, page: 0, rect: a.textures[1].location, with: 2)
+        assertFilled(atlas, page: 0, rect: b.textures[1].location, with: 3)
+    }
+
+    func testReportsOnlyWhatChanged() {
+        let atlas = makeAtlas()
+        _ = atlas.add([.color(1), .color(2)], from: ModelTexturePack())
+
+        let first = atlas.takeUpdates()
+        XCTAssertEqual(first.map { $0.isNewPage }, [true])
+        XCTAssertEqual(first.first?.rect, TextureAtlasPacker.LocationRect(Size2<Int>(width: 16, height: 16)))
+
+        let (_, b) = atlas.add([.color(2), .color(3)], from: ModelTexturePack())
+        let second = atlas.takeUpdates()
+        XCTAssertEqual(second.map { $0.isNewPage }, [false])
+        XCTAssertEqual(second.first?.rect, b.textures[1].location)
+
+        XCTAssertTrue(atlas.takeUpdates().isEmpty)
+    }
+
+    func testSpillsOntoAnotherPage() {
+        let atlas = makeAtlas()
+        _ = atlas.add([.color(1), .color(2), .color(3)], from: ModelTexturePack())
+        _ = atlas.takeUpdates()
+
+        // Only one of these would fit on the first page; so all of them go on a second.
+        let (page, c) = atlas.add([.color(4), .color(5)], from: ModelTexturePack())
+        XCTAssertEqual(page, 1)
+        XCTAssertEqual(atlas.pageCount, 2)
+        XCTAssertEqual(atlas.takeUpdates().map { "\($0.page) \($0.isNewPage)" }, ["1 true"])
+        assertFilled(atlas, page: 1, rect: c.textures[0].location, with: 4)
+
+        // A model that won't fit on any page of the usual size gets a bigger one.
+        let (bigPage, big) = atlas.add((10 ..< 15).map { .color($0) }, from: ModelTexturePack())
+        XCTAssertEqual(bigPage, 2)
+        XCTAssertEqual(atlas.size(ofPage: 2), Size2<Int>(width: 32, height: 16))
+        XCTAssertEqual(big.size, Size2<Int>(width: 32, height: 16))
+    }
+
+    func testIndexedPagesMatchExpandedPages() {
+        let models: [[UnitModel.Texture]] = [[.color(1), .color(2)], [.color(2), .color(200)], [.color(3), .color(4), .color(5)]]
+        let rgba = makeAtlas()
+        let indexed = IncrementalUnitTextureAtlas(palette: palette, filesystem: FileSystem(), pageSize: Size2<Int>(width: 16, height: 16), format: .paletteIndex)
+        for model in models {
+            XCTAssertEqual(rgba.add(model, from: ModelTexturePack()).page, indexed.add(model, from: ModelTexturePack()).page)
+        }
+
+        XCTAssertEqual(indexed.pageCount, rgba.pageCount)
+        for page in 0 ..< indexed.pageCount {
+            let size = indexed.size(ofPage: page)
+            let expanded = indexed.withPixels(ofPage: page) { palette.mapIndicesRgba(Data($0), size: size) }
+            XCTAssertEqual(expanded, rgba.withPixels(ofPage: page) { Data($0) }, "page \(page)")
+        }
+
+        // A whole atlas, built both ways.
+        let atlas = UnitTextureAtlas(for: [.color(9), .color(10)], from: ModelTexturePack())
+        XCTAssertEqual(palette.mapIndicesRgba(atlas.buildIndices(from: FileSystem()), size: atlas.size), atlas.build(from: FileSystem(), using: palette))
+        XCTAssertEqual(palette.lookupTable().count, 256 * 4)
+    }
+
+    static var allTests = [
+        ("testSharesTexturesAndKeepsThemInPlace", testSharesTexturesAndKeepsThemInPlace),
+        ("testReportsOnlyWhatChanged", testReportsOnlyWhatChanged),
+        ("testSpillsOntoAnotherPage", testSpillsOntoAnotherPage),
+        ("testIndexedPagesMatchExpandedPages", testIndexedPagesMatchExpandedPages),
+    ]
+}
+
+private extension IncrementalUnitTextureAtlasTests {
+
+    func assertFilled(_ atlas: IncrementalUnitTextureAtlas, page: Int, rect: TextureAtlasPacker.LocationRect, with colorIndex: Int, file: StaticString = #file, line: UInt = #line) {
+        let color = palette[colorIndex]
+        let pitch = atlas.size(ofPage: page).width * 4
+        atlas.withPixels(ofPage: page) { pixels in
+            for y in rect.top ..< rect.bottom {
+                for x in rect.left ..< rect.right {
+                    let i = y * pitch + x * 4
+                    XCTAssertEqual(Array(pixels[i ..< i + 4]), [color.red, color.green, color.blue, color.alpha], "at \(x), \(y)", file: file, line: line)
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,92 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class PaletteExpansionTests: XCTestCase {
+
+    private let palette = Palette((0 ..< 256).map { Palette.Color(red: UInt8($0), green: UInt8($0 / 2), blue: UInt8(255 - $0), alpha: $0 == 0 ? 0 : 255) })
+
+    /// A width that exercises both the 16-wide blocks and the leftover pixels.
+    private let size = Size2<Int>(width: 37, height: 5)
+    private var indices: [UInt8] { return (0 ..< size.area).map { UInt8(truncatingIfNeeded: $0 * 7) } }
+
+    func testExpandsEveryLayout() {
+        for layout in [Palette.PixelLayout.rgba, .bgra, .rgb] {
+            let pixels = palette.expandIndices(Data(indices), size: size, layout: layout)
+            XCTAssertEqual(Array(pixels), expected(indices, layout: layout), "\(layout)")
+        }
+    }
+
+    func testExpandsFlipped() {
+        let pixels = palette.expandIndices(Data(indices), size: size, flipped: true)
+        let rows = (0 ..< size.height).reversed().flatMap { Array(indices[($0 * size.width) ..< (($0 + 1) * size.width)]) }
+        XCTAssertEqual(Array(pixels), expected(rows, layout: .rgba))
+    }
+
+    func testExpandsIntoStridedRect() {
+        // The indices go into a 40 pixel wide image at (2, 1), leaving everything else untouched.
+        let pitch = 40 * 4
+        var image = [UInt8](repeating: 0xAB, count: pitch * (size.height + 2))
+        let source = indices
+        image.withUnsafeMutableBytes { destination in
+            source.withUnsafeBytes { source in
+                palette.expandIndices(source.baseAddress!, bytesPerRow: size.width, size: size,
+                                      into: destination.baseAddress! + pitch + 8, bytesPerRow: pitch, opaque: true)
+            }
+        }
+
+        for y in 0 ..< (size.height + 2) {
+            let row = Array(image[(y * pitch) ..< ((y + 1) * pitch)])
+            guard (1 ... size.height).contains(y) else {
+                XCTAssertEqual(row, [UInt8](repeating: 0xAB, count: pitch), "row \(y)")
+                continue
+            }
+            let expandedRow = expected(Array(indices[((y - 1) * size.width) ..< (y * size.width)]), layout: .rgba, opaque: true)
+            XCTAssertEqual(Array(row[0 ..< 8]), [UInt8](repeating: 0xAB, count: 8), "row \(y)")
+            XCTAssertEqual(Array(row[8 ..< (8 + size.width * 4)]), expandedRow, "row \(y)")
+            XCTAssertEqual(Array(row[(8 + size.width * 4)...]), [UInt8](repeating: 0xAB, count: pitch - 8 - size.width * 4), "row \(y)")
+        }
+    }
+
+    func testExpandsLargeImagesConcurrently() {
+        let size = Size2<Int>(width: 640, height: 480)
+        let indices = (0 ..< size.area).map { UInt8(truncatingIfNeeded: $0 ^ ($0 >> 9)) }
+        let pixels = palette.expandIndices(Data(indices), size: size, layout: .bgra)
+        XCTAssertEqual(Array(pixels), expected(indices, layout: .bgra))
+    }
+
+    func testSinglePixelMatchesTable() {
+        for layout in [Palette.PixelLayout.rgba, .bgra] {
+            for opaque in [false, true] {
+                let table = PaletteExpansion(palette, layout: layout, opaque: opaque).table
+                XCTAssertEqual((0 ..< 256).map { palette.pixel(at: $0, layout: layout, opaque: opaque) }, table, "\(layout) opaque: \(opaque)")
+            }
+        }
+        // A color the palette lacks is transparent black.
+        XCTAssertEqual(Palette().pixel(at: 255), 0)
+    }
+
+    static var allTests = [
+        ("testExpandsEveryLayout", testExpandsEveryLayout),
+        ("testExpandsFlipped", testExpandsFlipped),
+        ("testExpandsIntoStridedRect", testExpandsIntoStridedRect),
+        ("testExpandsLargeImagesConcurrently", testExpandsLargeImagesConcurrently),
+        ("testSinglePixelMatchesTable", testSinglePixelMatchesTable),
+    ]
+}
+
+private extension PaletteExpansionTests {
+
+    /// The pixels expanded one at a time, the long way around.
+    func expected(_ indices: [UInt8], layout: Palette.PixelLayout, opaque: Bool = false) -> [UInt8] {
+        return indices.flatMap { index -> [UInt8] in
+            let color = palette[index]
+            let alpha = opaque ? 255 : color.alpha
+            switch layout {
+            case .rgba: return [color.red, color.green, color.blue, alpha]
+            case .bgra: return [color.blue, color.green, color.red, alpha]
+            case .rgb: return [color.red, color.green, color.blue]
+            }
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+import Foundation
+
+/// A frame (or subframe) of a GAF built by `makeSampleGaf(named:frames:)`.
+struct SampleGafFrame {
+    var size: (Int, Int)
+    var offset: (Int, Int) = (0, 0)
+    /// The frame's `GafFrameEncoding`; ignored for a frame with subframes.
+    var encoding: UInt8 = 0
+    /// The frame's encoded pixels; ignored for a frame with subframes.
+    var data: [UInt8] = []
+    var subframes: [SampleGafFrame] = []
+}
+
+/**
+ The bytes of a GAF file with a single item of `frames`.
+
+ Everything is laid out in order: the header, the item's entry & its frame entries, the frame headers,
+ each composited frame's subframe offsets & subframe headers, and then every frame's (and subframe's) pixel data.
+ */
+func makeSampleGaf(named name: String = "test", frames: [SampleGafFrame]) -> [UInt8] {
+    let headerLength = 24
+    let framesOffset = 56 + frames.count * 8
+
+    var subframeTables: [Int] = []
+    var offset = framesOffset + frames.count * headerLength
+    for frame in frames where !frame.subframes.isEmpty {
+        subframeTables.append(offset)
+        offset += frame.subframes.count * (4 + headerLength)
+    }
+
+    var pixels: [UInt8] = []
+    func pixelOffset(of frame: SampleGafFrame) -> Int {
+        defer { pixels.append(contentsOf: frame.data) }
+        return offset + pixels.count
+    }
+    let pixelOffsets = frames.map { frame in frame.subframes.isEmpty ? [pixelOffset(of: frame)] : frame.subframes.map(pixelOffset) }
+
+    var bytes: [UInt8] = []
+    bytes.append(le: [0x00010100, 1, 0, 16] as [UInt32])
+    bytes.append(le: [UInt16(frames.count), 0])
+    bytes.append(le: [0] as [UInt32])
+    bytes.append(contentsOf: Array(name.utf8.prefix(31)) + [UInt8](repeating: 0, count: 32 - min(name.utf8.count, 31)))
+    for i in frames.indices {
+        bytes.append(le: [UInt32(framesOffset + i * headerLength), 0])
+    }
+
+    var tables = subframeTables.makeIterator()
+    for (frame, dataOffsets) in zip(frames, pixelOffsets) {
+        if frame.subframes.isEmpty {
+            bytes.append(frame: frame, data: dataOffsets[0])
+        }
+        else {
+            var sub = frame
+            sub.subframes = []
+            bytes.append(frame: sub, subframes: UInt16(frame.subframes.count), data: tables.next()!)
+        }
+    }
+    for (frame, dataOffsets) in zip(frames, pixelOffsets) where !frame.subframes.isEmpty {
+        let table = bytes.count
+        bytes.append(le: frame.subframes.indices.map { UInt32(table + frame.subframes.count * 4 + $0 * headerLength) })
+        for (subframe, dataOffset) in zip(frame.subframes, dataOffsets) {
+            bytes.append(frame: subframe, data: dataOffset)
+        }
+    }
+
+    return bytes + pixels
+}
+
+extension Array where Element == UInt8 {
+
+    /// Appends each of `values` as little-endian bytes.
+    mutating func append<T: FixedWidthInteger>(le values: [T]) {
+        for value in values {
+            Swift.withUnsafeBytes(of: value.littleEndian) { append(contentsOf: $0) }
+        }
+    }
+
+    fileprivate mutating func append(frame: SampleGafFrame, subframes: UInt16 = 0, data: Int) {
+        append(le: [UInt16(frame.size.0), UInt16(frame.size.1), UInt16(bitPattern: Int16(frame.offset.0)), UInt16(bitPattern: Int16(frame.offset.1))])
+        append(contentsOf: [0, frame.encoding])
+        append(le: [subframes])
+        append(le: [0, UInt32(data), 0] as [UInt32])
+    }
+
+}
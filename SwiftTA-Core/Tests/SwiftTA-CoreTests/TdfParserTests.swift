@@ -0,0 +1,148 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class TdfParserTests: XCTestCase {
+
+    func testTokenizesNestedObjects() {
+        let tdf = "[UNITINFO]\r\n\t{\r\n\tName = Commander ;\r\n\tUnitName=ARMCOM;\r\n\t[SUB]{ a=1; }\r\n\t}\r\n"
+        XCTAssertEqual(tokens(of: tdf), [
+            .objectBegin("UNITINFO"),
+            .property("Name", "Commander"),
+            .property("UnitName", "ARMCOM"),
+            .objectBegin("SUB"),
+            .property("a", "1"),
+            .objectEnd("SUB"),
+            .objectEnd("UNITINFO"),
+        ])
+    }
+
+    func testTrimsOnlyOuterWhitespace() {
+        XCTAssertEqual(tokens(of: "[a]{  key with\tspace  =  some  value \r\n;}"), [
+            .objectBegin("a"),
+            .property("key with\tspace", "some  value"),
+            .objectEnd("a"),
+        ])
+    }
+
+    func testSkipsComments() {
+        let tdf = "// [NOTASECTION] {}\n[a]\n{\n// x=0;\nx=1; // trailing\n}// done"
+        XCTAssertEqual(tokens(of: tdf), [.objectBegin("a"), .property("x", "1"), .objectEnd("a")])
+    }
+
+    func testDropsUnterminatedTokens() {
+        XCTAssertEqual(tokens(of: "[a]{ x=1; y=2"), [.objectBegin("a"), .property("x", "1")])
+        XCTAssertEqual(tokens(of: "[a"), [])
+    }
+
+    func testTokensSpanningManyBlocks() {
+        let values = (0..<40).map { String(repeating: "v\($0) ", count: $0 % 7 + 1) }
+        let tdf = "[long]\n{\n" + values.enumerated().map { "\tkey\($0)=\($1);\n" }.joined() + "}\n"
+        let expected: [TdfParser.Token] = [.objectBegin("long")]
+            + values.enumerated().map { .property("key\($0)", $1.trimmingCharacters(in: .whitespaces)) }
+            + [.objectEnd("long")]
+        XCTAssertEqual(tokens(of: tdf), expected)
+    }
+
+    func testDecodesNonAsciiAsLatin1() {
+        let tdf = Data("[a]{name=Caf".utf8) + Data([0xE9]) + Data(";}".utf8)
+        var found: [TdfParser.Token] = []
+        TdfParser.parse(tdf) { found.append($0) }
+        XCTAssertEqual(found, [.objectBegin("a"), .property("name", "Café"), .objectEnd("a")])
+    }
+
+    func testExtractAllAndSkipping() {
+        let tdf = "[one]{a=1;[inner]{b=2;}}[two]{c=3;}"
+        let all = TdfParser.extractAll(from: Data(tdf.utf8))
+        XCTAssertEqual(all["one"]?["a"], "1")
+        XCTAssertEqual(all["one"]?[object: "inner"]?["b"], "2")
+        XCTAssertEqual(all["two"]?["c"], "3")
+
+        let parser = TdfParser(Data(tdf.utf8))
+        XCTAssertTrue(parser.skipToObject(named: "two"))
+        XCTAssertEqual(parser.currentObjects, ["two"])
+        var properties: [String: String] = [:]
+        parser.forEachProperty { properties[$0] = $1 }
+        XCTAssertEqual(properties, ["c": "3"])
+        XCTAssertNil(parser.nextToken())
+        XCTAssertTrue(parser.isAtEnd)
+    }
+
+    func testDecodesWithSchema() throws {
+        let tdf = "[Thing]{ NAME=Rock; Size = 3 ; [sub]{ size=9; } weight=-2.5; flag=1; bogus=7; }[next]{ size=4; }"
+        let parser = TdfParser(Data(tdf.utf8))
+        parser.skipToObject(named: "Thing")
+        var thing = Thing()
+        try parser.decodeObject(into: &thing, using: Thing.schema)
+        XCTAssertEqual(thing.name, "Rock")
+        XCTAssertEqual(thing.size, 3)
+        XCTAssertEqual(thing.weight, -2.5)
+        XCTAssertTrue(thing.flag)
+        XCTAssertEqual(parser.skipToNextObject(), "next")
+    }
+
+    func testSchemaRequiredProperties() {
+        let parser = TdfParser(Data("[Thing]{ size=3; }".utf8))
+        parser.skipToObject(named: "Thing")
+        var thing = Thing()
+        XCTAssertThrowsError(try parser.decodeObject(into: &thing, using: Thing.schema))
+    }
+
+    func testSchemaValuesParseLikeStrings() {
+        let integers = ["0", "-0", "+12", "007", "-9223372036854775808", "9223372036854775807", "9223372036854775808", "", "-", "1.5", "1 2", "x"]
+        for text in integers {
+            XCTAssertEqual(value(text) { $0.integer(default: -1) }, Int(text) ?? -1, text)
+        }
+        let floats = ["0", "-0", "1.5", "-12.25", ".5", "5.", "0.1", "3.14159", "16777217", "1e3", "0.00000000001", "nan", "", ".", "-", "1.2.3"]
+        for text in floats {
+            let parsed = value(text) { $0.float(default: 42) }
+            let expected = Float(text) ?? 42
+            XCTAssertTrue(parsed == expected || (parsed.isNaN && expected.isNaN), text)
+            XCTAssertEqual(parsed.sign, expected.sign, text)
+        }
+    }
+
+    static var allTests = [
+        ("testTokenizesNestedObjects", testTokenizesNestedObjects),
+        ("testTrimsOnlyOuterWhitespace", testTrimsOnlyOuterWhitespace),
+        ("testSkipsComments", testSkipsComments),
+        ("testDropsUnterminatedTokens", testDropsUnterminatedTokens),
+        ("testTokensSpanningManyBlocks", testTokensSpanningManyBlocks),
+        ("testDecodesNonAsciiAsLatin1", testDecodesNonAsciiAsLatin1),
+        ("testExtractAllAndSkipping", testExtractAllAndSkipping),
+        ("testDecodesWithSchema", testDecodesWithSchema),
+        ("testSchemaRequiredProperties", testSchemaRequiredProperties),
+        ("testSchemaValuesParseLikeStrings", testSchemaValuesParseLikeStrings),
+    ]
+}
+
+private extension TdfParserTests {
+
+    func tokens(of tdf: String) -> [TdfParser.Token] {
+        let parser = TdfParser(Data(tdf.utf8))
+        var tokens: [TdfParser.Token] = []
+        while let token = parser.nextToken() {
+            tokens.append(token)
+        }
+        return tokens
+    }
+
+    func value<T>(_ text: String, _ decode: (TdfValue) -> T) -> T {
+        var bytes = Array(text.utf8)
+        return bytes.withUnsafeMutableBytes { decode(TdfValue(bytes: UnsafeRawBufferPointer($0))) }
+    }
+
+    struct Thing {
+        var name = ""
+        var size = 0
+        var weight: Float = 0
+        var flag = false
+
+        static let schema = TdfSchema<Thing>([
+            .field("name", required: true) { $0.name = $1.string },
+            .field("size") { $0.size = $1.integer(default: 0) },
+            .field("weight") { $0.weight = $1.float(default: 0) },
+            .field("flag") { $0.flag = $1.bool(default: false) },
+        ])
+    }
+
+}
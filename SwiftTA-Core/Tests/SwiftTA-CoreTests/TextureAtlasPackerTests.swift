@@ -0,0 +1,98 @@
+import XCTest
+@testable import SwiftTA_Core
+
+final class TextureAtlasPackerTests: XCTestCase {
+
+    func testPacksEveryTextureWithoutOverlap() {
+        let textures = sampleTextures(count: 200)
+        let (atlasSize, locations) = TextureAtlasPacker.pack(textures)
+
+        XCTAssertEqual(locations.count, textures.count)
+        XCTAssertEqual(atlasSize.width & (atlasSize.width - 1), 0, "power of two")
+        XCTAssertEqual(atlasSize.height & (atlasSize.height - 1), 0, "power of two")
+        assertPlaced(textures, at: locations, within: atlasSize)
+
+        // Random sizes like these should cover at least half the atlas.
+        let used = textures.reduce(0) { $0 + $1.size.area }
+        XCTAssertGreaterThan(Double(used) / Double(atlasSize.area), 0.5)
+    }
+
+    func testGrowsRatherThanDropping() {
+        // Three 48x48 textures have the area for a 128x64 atlas, but only two of them fit in it.
+        let textures = [Texture(48, 48), Texture(48, 48), Texture(48, 48)]
+        let (atlasSize, locations) = TextureAtlasPacker.pack(textures)
+        XCTAssertEqual(atlasSize, Size2<Int>(width: 128, height: 128))
+        assertPlaced(textures, at: locations, within: atlasSize)
+    }
+
+    func testSpillsOntoMorePages() {
+        let textures = sampleTextures(count: 300) + [Texture(300, 40), Texture(8, 8)]
+        let maxPageSize = Size2<Int>(width: 256, height: 256)
+        let packing = TextureAtlasPacker.pack(textures, maxPageSize: maxPageSize)
+
+        XCTAssertEqual(packing.locations.count, textures.count)
+        XCTAssertGreaterThan(packing.pages.count, 1)
+        XCTAssertEqual(packing.pages.reduce(0) { $0 + $1.usedArea }, textures.reduce(0) { $0 + $1.size.area })
+
+        for (page, pageInfo) in packing.pages.enumerated() {
+            let onPage = packing.locations.indices.filter { packing.locations[$0].page == page }
+            XCTAssertFalse(onPage.isEmpty, "page \(page) is empty")
+            assertPlaced(onPage.map { textures[$0] }, at: onPage.map { packing.locations[$0].rect }, within: pageInfo.size)
+            XCTAssertGreaterThan(pageInfo.occupancy, 0)
+            XCTAssertLessThanOrEqual(pageInfo.occupancy, 1)
+
+            // Only the oversized texture gets a page bigger than the maximum.
+            let isOversized = onPage.contains(textures.count - 2)
+            XCTAssertEqual(pageInfo.size.width <= maxPageSize.width && pageInfo.size.height <= maxPageSize.height, !isOversized)
+        }
+    }
+
+    func testZeroSizedTexturesTakeNoSpace() {
+        let textures = [Texture(0, 0), Texture(16, 16)]
+        let (atlasSize, locations) = TextureAtlasPacker.pack(textures)
+        XCTAssertEqual(atlasSize, Size2<Int>(width: 16, height: 16))
+        XCTAssertEqual(locations[0], .zero)
+        XCTAssertEqual(locations[1], TextureAtlasPacker.LocationRect(left: 0, top: 0, right: 16, bottom: 16))
+    }
+
+    static var allTests = [
+        ("testPacksEveryTextureWithoutOverlap", testPacksEveryTextureWithoutOverlap),
+        ("testGrowsRatherThanDropping", testGrowsRatherThanDropping),
+        ("testSpillsOntoMorePages", testSpillsOntoMorePages),
+        ("testZeroSizedTexturesTakeNoSpace", testZeroSizedTexturesTakeNoSpace),
+    ]
+}
+
+private struct Texture: PackableTexture {
+    var size: Size2<Int>
+    init(_ width: Int, _ height: Int) { size = Size2<Int>(width: width, height: height) }
+}
+
+private extension TextureAtlasPackerTests {
+
+    /// A deterministic spread of texture sizes, from 4 to 67 pixels to a side.
+    func sampleTextures(count: Int) -> [Texture] {
+        var state: UInt32 = 12345
+        func next() -> Int {
+            state = state &* 1103515245 &+ 12345
+            return Int((state >> 16) & 63)
+        }
+        return (0 ..< count).map { _ in Texture(4 + next(), 4 + next()) }
+    }
+
+    func assertPlaced(_ textures: [Texture], at locations: [TextureAtlasPacker.LocationRect], within atlasSize: Size2<Int>, file: StaticString = #file, line: UInt = #line) {
+        for (texture, rect) in zip(textures, locations) {
+            XCTAssertEqual(Size2<Int>(width: rect.width, height: rect.height), texture.size, file: file, line: line)
+            XCTAssertTrue(rect.left >= 0 && rect.top >= 0 && rect.right <= atlasSize.width && rect.bottom <= atlasSize.height,
+                          "\(rect) is outside of \(atlasSize)", file: file, line: line)
+        }
+        for i in locations.indices {
+            for j in locations.indices where j > i {
+                let (a, b) = (locations[i], locations[j])
+                let overlaps = a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom
+                XCTAssertFalse(overlaps, "\(a) overlaps \(b)", file: file, line: line)
+            }
+        }
+    }
+
+}
@@ -4,6 +4,20 @@ import XCTest
 public func allTests() -> [XCTestCaseEntry] {
     return [
         testCase(SwiftTA_CoreTests.allTests),
+        testCase(HpiDecryptionTests.allTests),
+        testCase(FileSystemMergeTests.allTests),
+        testCase(FileSystemPathTests.allTests),
+        testCase(AssetBakeCacheTests.allTests),
+        testCase(TdfParserTests.allTests),
+        testCase(FeatureIndexTests.allTests),
+        testCase(GafDecodeTests.allTests),
+        testCase(PaletteExpansionTests.allTests),
+        testCase(TextureAtlasPackerTests.allTests),
+        testCase(IncrementalUnitTextureAtlasTests.allTests),
+        testCase(HeightMapTests.allTests),
+        testCase(ContentCacheTests.allTests),
+        testCase(FileHandleTests.allTests),
+        testCase(HpiLZ77Tests.allTests),
     ]
 }
 #endif
@@ -5,3 +5,4 @@
 #include "ta_GAF.h"
 #include "ta_HPI.h"
 #include "ta_TNT.h"
+#include "atomics.h"
@@ -0,0 +1,24 @@
+//
+//  atomics.h
+//  SwiftTA-Ctypes
+//
+//  Created by Logan Jones on 10/16/26.
+//
+#ifndef atomics_h
+#define atomics_h
+#include <stdbool.h>
+
+// A flag that may be read & written from any thread.
+// Writes are released and reads acquired; so anything written before a flag is set is visible once it is seen to be set.
+
+static inline bool swiftta_atomic_load_flag(const bool *flag)
+{
+    return __atomic_load_n(flag, __ATOMIC_ACQUIRE);
+}
+
+static inline void swiftta_atomic_store_flag(bool *flag, bool value)
+{
+    __atomic_store_n(flag, value, __ATOMIC_RELEASE);
+}
+
+#endif /* atomics_h */
@@ -146,6 +146,9 @@ extension MetalRenderer: MTKViewDelegate {
     }
     
     public func draw(in view: MTKView) {
+        let span = Trace.begin("Draw Frame", category: "render")
+        defer { span.end() }
+        
         let viewState = self.viewState
         
         guard let commandBuffer = commandQueue.makeCommandBuffer() else { return }
@@ -124,20 +124,19 @@ private extension OpenglCore3FeatureDrawable {
             
             guard let featureIndex = map.features.firstIndex(of: name) else { return }
             guard let occurrences = occurrences[featureIndex], !occurrences.isEmpty else { return }
-            guard let gafFrames = try? item.extractFrames(from: gafHandle) else { return }
+            guard item.numberOfFrames > 0 else { return }
             guard let palette = palettes[info.world ?? ""] else { return }
             
-            if gafFrames.count == 1 {
-                if let texture = try? makeTexture(for: gafFrames[0], using: palette),
-                    let instances = buildInstances(of: (gafFrames[0].size, gafFrames[0].offset, info.footprint), from: occurrences, in: map)
+            if item.numberOfFrames == 1 {
+                if case let (texture, frame)? = try? makeTexture(for: item, from: gafHandle, using: palette),
+                    let instances = buildInstances(of: (frame.size, frame.offset, info.footprint), from: occurrences, in: map)
                 {
-                    features.append(.static(StaticFeature(texture: texture, textureSize: gafFrames[0].size, instancesVertexBuffer: instances.0, instancesVertexCount: instances.1)))
+                    features.append(.static(StaticFeature(texture: texture, textureSize: frame.size, instancesVertexBuffer: instances.0, instancesVertexCount: instances.1)))
                 }
                 
                 if let shadowName = info.shadowGafItemName,
                     let shadowItem = gafListing[shadowName],
-                    let shadowFrame = try? shadowItem.extractFrame(index: 0, from: gafHandle),
-                    let shadowTexture = try? makeTexture(for: shadowFrame, using: shadowPalette),
+                    case let (shadowTexture, shadowFrame)? = try? makeTexture(for: shadowItem, from: gafHandle, using: shadowPalette),
                     let shadowInstances = buildInstances(of: (shadowFrame.size, shadowFrame.offset, info.footprint), from: occurrences, in: map)
                 {
                     shadows.append(.static(StaticFeature(texture: shadowTexture, textureSize: shadowFrame.size, instancesVertexBuffer: shadowInstances.0, instancesVertexCount: shadowInstances.1)))
@@ -145,17 +144,23 @@ private extension OpenglCore3FeatureDrawable {
             }
             else {
                 // TEMP
-                print("TODO: Support animated map feature \(name) (\(gafFrames.count) frames)")
-                let texture = try! makeTexture(for: gafFrames[0], using: palette)
-                let instances = buildInstances(of: (gafFrames[0].size, gafFrames[0].offset, info.footprint), from: occurrences, in: map)!
-                features.append(.static(StaticFeature(texture: texture, textureSize: gafFrames[0].size, instancesVertexBuffer: instances.0, instancesVertexCount: instances.1)))
+                print("TODO: Support animated map feature \(name) (\(item.numberOfFrames) frames)")
+                let (texture, frame) = try! makeTexture(for: item, from: gafHandle, using: palette)
+                let instances = buildInstances(of: (frame.size, frame.offset, info.footprint), from: occurrences, in: map)!
+                features.append(.static(StaticFeature(texture: texture, textureSize: frame.size, instancesVertexBuffer: instances.0, instancesVertexCount: instances.1)))
             }
         }
         
         return (features, shadows)
     }
     
-    func makeTexture(for gafFrame: GafItem.Frame, using palette: Palette) throws -> OpenglTextureResource {
+    /// Makes a texture of the item's first frame; decoded and expanded through the palette straight into the upload buffer.
+    func makeTexture(for item: GafItem, from gaf: FileSystem.FileHandle, using palette: Palette) throws -> (OpenglTextureResource, GafItem.FrameMetadata) {
+        
+        let frame = try item.readFrameMetadata(atIndex: 0, from: gaf)
+        let image = UnsafeMutableRawBufferPointer.allocate(byteCount: max(frame.size.area, 1) * 4, alignment: MemoryLayout<UInt32>.alignment)
+        defer { image.deallocate() }
+        try item.decodeFrame(index: 0, from: gaf, into: GafItem.FrameDestination(pixels: image.baseAddress!, bytesPerRow: frame.size.width * 4, format: .rgba(palette)))
         
         let texture = OpenglTextureResource()
         glBindTexture(GLenum(GL_TEXTURE_2D), texture.id)
@@ -164,31 +169,18 @@ private extension OpenglCore3FeatureDrawable {
         glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_S), GL_REPEAT )
         glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_T), GL_REPEAT )
         
-        let image = UnsafeMutableBufferPointer<UInt8>.allocate(capacity: gafFrame.size.area * 4)
-        defer { image.deallocate() }
-        gafFrame.data.withUnsafeBytes() { (source) in
-            for sourceIndex in 0..<gafFrame.size.area {
-                let destinationIndex = sourceIndex * 4
-                let colorIndex = Int(source[sourceIndex])
-                image[destinationIndex+0] = palette[colorIndex].red
-                image[destinationIndex+1] = palette[colorIndex].green
-                image[destinationIndex+2] = palette[colorIndex].blue
-                image[destinationIndex+3] = palette[colorIndex].alpha
-            }
-        }
-        
         glTexImage2D(
             GLenum(GL_TEXTURE_2D),
             0,
             GLint(GL_RGBA),
-            GLsizei(gafFrame.size.width),
-            GLsizei(gafFrame.size.height),
+            GLsizei(frame.size.width),
+            GLsizei(frame.size.height),
             0,
             GLenum(GL_RGBA),
             GLenum(GL_UNSIGNED_BYTE),
             image.baseAddress!)
         
-        return texture
+        return (texture, frame)
     }
     
     enum TextureError: Swift.Error {
@@ -217,7 +209,7 @@ private extension OpenglCore3FeatureDrawable {
             let boundingBox = map.worldPosition(ofMapIndex: i)
                 .center(inFootprint: feature.footprint)
                 .offset(by: feature.offset)
-                .adjust(forHeight: map.heightMap.samples[i])
+                .adjust(forHeight: map.heightMap.height(atMapIndex: i))
                 .makeRect(size: Size2f(feature.size))
             
             createRect(boundingBox, in: &vertices, &index)
@@ -21,19 +21,28 @@ class OpenglCore3OneTextureTntDrawable: OpenglCore3TntDrawable {
     
     private let program: TntProgram
     private let texture: OpenglTextureResource
+    /// Only when the `texture` is palette indices.
+    private let paletteTexture: OpenglTextureResource?
     private let textureSize: Size2<Int>
     private let quad: TntQuadModel
     
-    init(for map: MapModel, from filesystem: FileSystem) throws {
+    init(for map: MapModel, from filesystem: FileSystem, textureFormat: OpenglTextureFormat = .rgba) throws {
         
-        program = try makeProgram()
+        program = try makeProgram(textureFormat)
         quad = TntQuadModel()
         
         switch map {
             
         case .ta(let map):
             let palette = try Palette.standardTaPalette(from: filesystem)
-            texture = makeTexture(for: map, using: palette)
+            switch textureFormat {
+            case .rgba:
+                texture = makeTexture(for: map, using: palette)
+                paletteTexture = nil
+            case .paletteIndex:
+                texture = makeIndexTexture(for: map)
+                paletteTexture = makePaletteTexture(palette, opaque: true)
+            }
             textureSize = map.resolution
             
         case .tak(_):
@@ -53,6 +62,7 @@ class OpenglCore3OneTextureTntDrawable: OpenglCore3TntDrawable {
         glUseProgram(program.id)
         glUniform4x4(program.uniform_mvp, projectionMatrix * viewMatrix * modelMatrix)
         glUniform1i(program.uniform_texture, 0)
+        glUniform1i(program.uniform_palette, 1)
         
         quad.setupNextFrame(viewportPosition, Vector2(viewState.viewport.size), Vector2(textureSize))
     }
@@ -70,6 +80,10 @@ class OpenglCore3OneTextureTntDrawable: OpenglCore3TntDrawable {
         glTexEnvf(GLenum(GL_TEXTURE_ENV), GLenum(GL_TEXTURE_ENV_MODE), GLfloat(GL_MODULATE))
         
         glUseProgram(program.id)
+        if let paletteTexture = paletteTexture {
+            glActiveTexture(GLenum(GL_TEXTURE1))
+            glBindTexture(GLenum(GL_TEXTURE_2D), paletteTexture.id)
+        }
         glActiveTexture(GLenum(GL_TEXTURE0))
         glBindTexture(GLenum(GL_TEXTURE_2D), texture.id)
         quad.draw()
@@ -151,6 +165,53 @@ private func makeTexture(for map: TaMapModel, using palette: Palette) -> OpenglT
     return texture
 }
 
+/// Makes the map texture straight from the tile set's palette indices; no conversion required.
+private func makeIndexTexture(for map: TaMapModel) -> OpenglTextureResource {
+    let begin = Date()
+    
+    let textureSize = map.resolution
+    let tntTileSize = map.tileSet.tileSize
+    
+    let texture = OpenglTextureResource()
+    glBindTexture(GLenum(GL_TEXTURE_2D), texture.id)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MAG_FILTER), GL_NEAREST)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MIN_FILTER), GL_NEAREST)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_S), GL_REPEAT )
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_T), GL_REPEAT )
+    
+    glTexImage2D(
+        GLenum(GL_TEXTURE_2D),
+        0,
+        GLint(GL_R8),
+        GLsizei(textureSize.width),
+        GLsizei(textureSize.height),
+        0,
+        GLenum(GL_RED),
+        GLenum(GL_UNSIGNED_BYTE),
+        nil)
+    
+    glPixelStorei(GLenum(GL_UNPACK_ALIGNMENT), 1)
+    map.tileSet.tiles.withUnsafeBytes { (tiles: UnsafeRawBufferPointer) in
+        map.tileIndexMap.eachIndex(inColumns: 0 ..< map.tileIndexMap.size.width, rows: 0 ..< map.tileIndexMap.size.height) {
+            (index, column, row) in
+            glTexSubImage2D(
+                GLenum(GL_TEXTURE_2D), 0,
+                GLint(column * tntTileSize.width), GLint(row * tntTileSize.height),
+                GLsizei(tntTileSize.width), GLsizei(tntTileSize.height),
+                GLenum(GL_RED), GLenum(GL_UNSIGNED_BYTE),
+                tiles.baseAddress! + (index * tntTileSize.area))
+        }
+    }
+    glPixelStorei(GLenum(GL_UNPACK_ALIGNMENT), 4)
+    
+    print("""
+        Tnt Index Texture load time: \(Date().timeIntervalSince(begin)) seconds
+          Texture: \(textureSize) -> \(textureSize.area) bytes
+        """)
+    printGlErrors(prefix: "Map Texture: ")
+    return texture
+}
+
 // MARK:- Shader Loading
 
 private struct TntProgram {
@@ -159,17 +220,20 @@ private struct TntProgram {
     
     let uniform_mvp: GLint
     let uniform_texture: GLint
+    let uniform_palette: GLint
     
     init(_ program: GLuint) {
         id = program
         uniform_mvp = glGetUniformLocation(program, "mvpMatrix")
         uniform_texture = glGetUniformLocation(program, "colorTexture")
+        uniform_palette = glGetUniformLocation(program, "paletteTexture")
     }
     
     init() {
         id = 0
         uniform_mvp = -1
         uniform_texture = -1
+        uniform_palette = -1
     }
     
     static var unset: TntProgram { return TntProgram() }
@@ -181,10 +245,10 @@ private func loadShaderCode(forResource name: String, withExtension ext: String)
     return try String(contentsOf: url)
 }
 
-private func makeProgram() throws -> TntProgram {
+private func makeProgram(_ textureFormat: OpenglTextureFormat) throws -> TntProgram {
     
     let vertexShader = try compileShader(GLenum(GL_VERTEX_SHADER), source: vertexShaderCode)
-    let fragmentShader = try compileShader(GLenum(GL_FRAGMENT_SHADER), source: fragmentShaderCode)
+    let fragmentShader = try compileShader(GLenum(GL_FRAGMENT_SHADER), source: textureFormat == .paletteIndex ? indexedFragmentShaderCode : fragmentShaderCode)
     let program = try linkShaders(vertexShader, fragmentShader)
     
     glDeleteShader(fragmentShader)
@@ -224,6 +288,22 @@ private let fragmentShaderCode: String = """
     }
     """
 
+private let indexedFragmentShaderCode: String = """
+    #version 330 core
+    precision highp float;
+
+    smooth in vec2 fragment_texture;
+    out vec4 out_color;
+
+    uniform sampler2D colorTexture;
+    uniform sampler2D paletteTexture;
+
+    void main(void) {
+        int index = int(texture(colorTexture, fragment_texture).r * 255.0 + 0.5);
+        out_color = texelFetch(paletteTexture, ivec2(index, 0), 0);
+    }
+    """
+
 // MARK:- Model
 
 private class TntQuadModel {
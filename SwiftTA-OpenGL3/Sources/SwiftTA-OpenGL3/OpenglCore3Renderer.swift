@@ -19,6 +19,8 @@ import Cgl
 public class OpenglCore3Renderer: RunLoopGameRenderer {
     
     public var viewState: GameViewState
+    /// How the map & unit textures are kept on the GPU; takes effect at the next `load(state:)`.
+    public var textureFormat: OpenglTextureFormat = .rgba
     private var tnt: OpenglCore3TntDrawable?
     private var features: OpenglCore3FeatureDrawable?
     private var units: OpenglCore3UnitDrawable?
@@ -37,12 +39,12 @@ public class OpenglCore3Renderer: RunLoopGameRenderer {
             }
             else {
                 print("Using simple tnt renderer")
-                tnt = try OpenglCore3OneTextureTntDrawable(for: loaded.map, from: loaded.filesystem)
+                tnt = try OpenglCore3OneTextureTntDrawable(for: loaded.map, from: loaded.filesystem, textureFormat: textureFormat)
             }
             
             self.tnt = tnt
             features = try OpenglCore3FeatureDrawable(loaded.features, containedIn: loaded.map, filesystem: loaded.filesystem)
-            units = try OpenglCore3UnitDrawable(loaded.units, sides: loaded.sides, filesystem: loaded.filesystem)
+            units = try OpenglCore3UnitDrawable(loaded.units, sides: loaded.sides, filesystem: loaded.filesystem, textureFormat: textureFormat)
         }
         catch {
             print("Failed to load map: \(error)")
@@ -50,7 +52,18 @@ public class OpenglCore3Renderer: RunLoopGameRenderer {
         }
     }
     
+    /**
+     Makes unit types that were loaded after `load(state:)` drawable, without reloading anything else.
+     Their textures are added to the existing atlases. Call this on the thread that draws frames.
+     */
+    public func addUnitTypes(_ units: [UnitTypeId: UnitData]) {
+        self.units?.addUnitTypes(units)
+    }
+    
     public func drawFrame() {
+        let span = Trace.begin("Draw Frame", category: "render")
+        defer { span.end() }
+        
         guard let tnt = tnt, let features = features, let units = units else { return }
         
         tnt.setupNextFrame(viewState)
@@ -66,6 +79,17 @@ public class OpenglCore3Renderer: RunLoopGameRenderer {
     
 }
 
+/**
+ Every TA texture is 8-bit palette indices. They can either be expanded to RGBA before they are uploaded,
+ or uploaded as they are (a quarter of the size) for the shaders to look up each pixel's color in a palette texture.
+ */
+public enum OpenglTextureFormat {
+    /// Textures are expanded through their palette to 32-bit RGBA on the CPU.
+    case rgba
+    /// Textures are single channel (`GL_R8`) palette indices, drawn through a 256x1 palette texture.
+    case paletteIndex
+}
+
 protocol OpenglCore3TntDrawable {
     func setupNextFrame(_ viewState: GameViewState)
     func drawFrame()
@@ -20,8 +20,15 @@ import Cgl
 class OpenglCore3UnitDrawable {
     
     private let program: UnitProgram
+    private let textureFormat: OpenglTextureFormat
     private var models: [UnitTypeId: Model] = [:]
     
+    private let sides: [SideInfo]
+    private let filesystem: FileSystem
+    private let textures: ModelTexturePack
+    /// The model textures of each side (each with its own palette), keyed by side name.
+    private var atlases: [String: TextureAtlas] = [:]
+    
     struct FrameState {
         fileprivate let instances: [UnitTypeId: [Instance]]
         fileprivate init(_ instances: [UnitTypeId: [Instance]]) {
@@ -29,12 +36,38 @@ class OpenglCore3UnitDrawable {
         }
     }
     
-    init(_ units: [UnitTypeId: UnitData], sides: [SideInfo], filesystem: FileSystem) throws {
+    init(_ units: [UnitTypeId: UnitData], sides: [SideInfo], filesystem: FileSystem, textureFormat: OpenglTextureFormat = .rgba) throws {
         
-        program = try makeProgram()
+        program = try makeProgram(textureFormat)
         
-        let textures = ModelTexturePack(loadFrom: filesystem)
-        models = units.mapValues { try! Model($0, textures, sides, filesystem) }
+        self.textureFormat = textureFormat
+        self.sides = sides
+        self.filesystem = filesystem
+        textures = ModelTexturePack(loadFrom: filesystem)
+        addUnitTypes(units)
+    }
+    
+    /// Makes any of `units` not seen before drawable.
+    /// Their textures are added to their side's atlas; only the parts of the atlas that change are uploaded.
+    /// A unit whose side (or its palette) can't be found is skipped, and won't be drawn.
+    func addUnitTypes(_ units: [UnitTypeId: UnitData]) {
+        for (unitType, unit) in units where models[unitType] == nil {
+            do {
+                models[unitType] = Model(unit, try textureAtlas(for: unit))
+            }
+            catch {
+                print("!!! Skipping unit \(unit.info.name); failed to load its texture palette: \(error)")
+            }
+        }
+        atlases.values.forEach { $0.upload() }
+    }
+    
+    private func textureAtlas(for unit: UnitData) throws -> TextureAtlas {
+        if let atlas = atlases[unit.info.side] { return atlas }
+        let palette = try Palette.texturePalette(for: unit.info, in: sides, from: filesystem)
+        let atlas = TextureAtlas(IncrementalUnitTextureAtlas(palette: palette, filesystem: filesystem, format: textureFormat.atlasFormat), textures)
+        atlases[unit.info.side] = atlas
+        return atlas
     }
     
     func setupNextFrame(_ viewState: GameViewState) -> FrameState {
@@ -49,10 +82,16 @@ class OpenglCore3UnitDrawable {
         glActiveTexture(GLenum(GL_TEXTURE0))
         glUseProgram(program.id)
         glUniform1i(program.uniform_texture, 0)
+        glUniform1i(program.uniform_palette, 1)
         
         for (unitType, instances) in frameState.instances {
             guard let model = models[unitType] else { continue }
-            glBindTexture(GLenum(GL_TEXTURE_2D), model.texture.id)
+            if let palette = model.textures.paletteTexture {
+                glActiveTexture(GLenum(GL_TEXTURE1))
+                glBindTexture(GLenum(GL_TEXTURE_2D), palette.id)
+                glActiveTexture(GLenum(GL_TEXTURE0))
+            }
+            glBindTexture(GLenum(GL_TEXTURE_2D), model.textures.pages[model.page].id)
             glBindVertexArray(model.buffer.vao)
             for instance in instances {
                 glUniform4x4(program.uniform_vpMatrix, instance.vpMatrix)
@@ -89,17 +128,17 @@ private extension OpenglCore3UnitDrawable {
     struct Model {
         var buffer: OpenglVertexBufferResource
         var vertexCount: Int
-        var texture: OpenglTextureResource
+        var textures: TextureAtlas
+        /// The page of `textures` with all of this model's textures on it.
+        var page: Int
     }
 }
 
 private extension OpenglCore3UnitDrawable.Model {
     
-    init(_ unit: UnitData, _ textures: ModelTexturePack, _ sides: [SideInfo], _ filesystem: FileSystem) throws {
+    init(_ unit: UnitData, _ textures: OpenglCore3UnitDrawable.TextureAtlas) {
         
-        let palette = try Palette.texturePalette(for: unit.info, in: sides, from: filesystem)
-        let atlas = UnitTextureAtlas(for: unit.model.textures, from: textures)
-        let texture = try makeTexture(atlas, palette, filesystem)
+        let (page, atlas) = textures.add(unit.model)
         
         let vertexCount = countVertices(in: unit.model)
         var arrays = VertexArrays(capacity: vertexCount)
@@ -137,7 +176,8 @@ private extension OpenglCore3UnitDrawable.Model {
         
         self.buffer = buffer
         self.vertexCount = vertexCount
-        self.texture = texture
+        self.textures = textures
+        self.page = page
     }
     
 }
@@ -278,9 +318,85 @@ private struct VertexArrays {
     }
 }
 
-private func makeTexture(_ textureAtlas: UnitTextureAtlas, _ palette: Palette, _ filesystem: FileSystem) throws -> OpenglTextureResource {
+// MARK:- Texture Atlas
+
+private extension OpenglCore3UnitDrawable {
     
-    let data = textureAtlas.build(from: filesystem, using: palette)
+    /// An `IncrementalUnitTextureAtlas`, along with a texture for each of its pages
+    /// (and the atlas' palette, when the pages are palette indices).
+    final class TextureAtlas {
+        
+        let atlas: IncrementalUnitTextureAtlas
+        let texturePack: ModelTexturePack
+        private(set) var pages: [OpenglTextureResource] = []
+        let paletteTexture: OpenglTextureResource?
+        
+        init(_ atlas: IncrementalUnitTextureAtlas, _ texturePack: ModelTexturePack) {
+            self.atlas = atlas
+            self.texturePack = texturePack
+            switch atlas.format {
+            case .rgba: paletteTexture = nil
+            case .paletteIndex: paletteTexture = makePaletteTexture(atlas.palette)
+            }
+        }
+        
+        func add(_ model: UnitModel) -> (page: Int, atlas: UnitTextureAtlas) {
+            return atlas.add(model.textures, from: texturePack)
+        }
+        
+        /// Creates the texture of any new page and uploads every rect that has changed in the others.
+        func upload() {
+            let updates = atlas.takeUpdates()
+            guard !updates.isEmpty else { return }
+            
+            let (internalFormat, format) = atlas.format == .paletteIndex ? (GL_R8, GL_RED) : (GL_RGBA, GL_RGBA)
+            let bytesPerPixel = atlas.format.bytesPerPixel
+            glPixelStorei(GLenum(GL_UNPACK_ALIGNMENT), 1)
+            
+            for update in updates {
+                let pageSize = atlas.size(ofPage: update.page)
+                if update.isNewPage {
+                    pages.append(makePageTexture(sized: pageSize, internalFormat: internalFormat, format: format))
+                }
+                else {
+                    glBindTexture(GLenum(GL_TEXTURE_2D), pages[update.page].id)
+                }
+                
+                // The rect is uploaded straight out of the page's pixels.
+                glPixelStorei(GLenum(GL_UNPACK_ROW_LENGTH), GLint(pageSize.width))
+                atlas.withPixels(ofPage: update.page) {
+                    glTexSubImage2D(
+                        GLenum(GL_TEXTURE_2D), 0,
+                        GLint(update.rect.left), GLint(update.rect.top),
+                        GLsizei(update.rect.width), GLsizei(update.rect.height),
+                        GLenum(format), GLenum(GL_UNSIGNED_BYTE),
+                        $0.baseAddress! + (update.rect.top * pageSize.width + update.rect.left) * bytesPerPixel)
+                }
+                glPixelStorei(GLenum(GL_UNPACK_ROW_LENGTH), 0)
+            }
+            
+            glPixelStorei(GLenum(GL_UNPACK_ALIGNMENT), 4)
+            
+            printGlErrors(prefix: "Model Texture: ")
+        }
+        
+    }
+    
+}
+
+private extension OpenglTextureFormat {
+    
+    /// The format of an atlas' pages when drawing textures in this format.
+    var atlasFormat: IncrementalUnitTextureAtlas.Format {
+        switch self {
+        case .rgba: return .rgba
+        case .paletteIndex: return .paletteIndex
+        }
+    }
+    
+}
+
+private func makePageTexture(sized size: Size2<Int>, internalFormat: Int32, format: Int32) -> OpenglTextureResource {
     
     let texture = OpenglTextureResource()
     glBindTexture(GLenum(GL_TEXTURE_2D), texture.id)
@@ -289,20 +405,17 @@ private func makeTexture(_ textureAtlas: UnitTextureAtlas, _ palette: Palette, _
     glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_S), GL_REPEAT )
     glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_T), GL_REPEAT )
     
-    data.withUnsafeBytes {
-        glTexImage2D(
-            GLenum(GL_TEXTURE_2D),
-            0,
-            GLint(GL_RGBA),
-            GLsizei(textureAtlas.size.width),
-            GLsizei(textureAtlas.size.height),
-            0,
-            GLenum(GL_RGBA),
-            GLenum(GL_UNSIGNED_BYTE),
-            $0.baseAddress!)
-    }
+    glTexImage2D(
+        GLenum(GL_TEXTURE_2D),
+        0,
+        GLint(internalFormat),
+        GLsizei(size.width),
+        GLsizei(size.height),
+        0,
+        GLenum(format),
+        GLenum(GL_UNSIGNED_BYTE),
+        nil)
     
-    printGlErrors(prefix: "Model Texture: ")
     return texture
 }
 
@@ -397,6 +510,7 @@ private struct UnitProgram {
     let uniform_normalMatrix: GLint
     let uniform_pieces: GLint
     let uniform_texture: GLint
+    let uniform_palette: GLint
     
     init(_ program: GLuint) {
         id = program
@@ -404,6 +518,7 @@ private struct UnitProgram {
         uniform_normalMatrix = glGetUniformLocation(program, "normalMatrix")
         uniform_pieces = glGetUniformLocation(program, "pieces")
         uniform_texture = glGetUniformLocation(program, "colorTexture")
+        uniform_palette = glGetUniformLocation(program, "paletteTexture")
     }
     
     init() {
@@ -412,16 +527,17 @@ private struct UnitProgram {
         uniform_normalMatrix = -1
         uniform_pieces = -1
         uniform_texture = -1
+        uniform_palette = -1
     }
     
     static var unset: UnitProgram { return UnitProgram() }
     
 }
 
-private func makeProgram() throws -> UnitProgram {
+private func makeProgram(_ textureFormat: OpenglTextureFormat) throws -> UnitProgram {
     
     let vertexShader = try compileShader(GLenum(GL_VERTEX_SHADER), source: vertexShaderCode)
-    let fragmentShader = try compileShader(GLenum(GL_FRAGMENT_SHADER), source: fragmentShaderCode)
+    let fragmentShader = try compileShader(GLenum(GL_FRAGMENT_SHADER), source: textureFormat == .paletteIndex ? indexedFragmentShaderCode : fragmentShaderCode)
     let program = try linkShaders(vertexShader, fragmentShader)
     
     glDeleteShader(fragmentShader)
@@ -470,6 +586,23 @@ private let fragmentShaderCode: String = """
         out_color = texture(colorTexture, fragment_texture);
     }
     """
+
+private let indexedFragmentShaderCode: String = """
+    #version 330 core
+    precision highp float;
+
+    smooth in vec2 fragment_texture;
+
+    out vec4 out_color;
+
+    uniform sampler2D colorTexture;
+    uniform sampler2D paletteTexture;
+
+    void main(void) {
+        int index = int(texture(colorTexture, fragment_texture).r * 255.0 + 0.5);
+        out_color = texelFetch(paletteTexture, ivec2(index, 0), 0);
+    }
+    """
 //private let fragmentShaderCode: String = """
 //    #version 330 core
 //    precision highp float;
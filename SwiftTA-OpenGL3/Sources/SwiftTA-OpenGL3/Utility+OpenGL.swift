@@ -203,6 +203,33 @@ class OpenglTextureResource {
     }
 }
 
+/// Makes a 256x1 texture of the palette's colors, for shaders to look up palette indices in.
+func makePaletteTexture(_ palette: Palette, opaque: Bool = false) -> OpenglTextureResource {
+    
+    let texture = OpenglTextureResource()
+    glBindTexture(GLenum(GL_TEXTURE_2D), texture.id)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MAG_FILTER), GL_NEAREST)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MIN_FILTER), GL_NEAREST)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_S), GL_CLAMP_TO_EDGE)
+    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_T), GL_CLAMP_TO_EDGE)
+    
+    palette.lookupTable(opaque: opaque).withUnsafeBytes {
+        glTexImage2D(
+            GLenum(GL_TEXTURE_2D),
+            0,
+            GLint(GL_RGBA),
+            256,
+            1,
+            0,
+            GLenum(GL_RGBA),
+            GLenum(GL_UNSIGNED_BYTE),
+            $0.baseAddress!)
+    }
+    
+    printGlErrors(prefix: "Palette Texture: ")
+    return texture
+}
+
 class OpenglVertexBufferResource {
     let vao: GLuint
     let vbo: [GLuint]
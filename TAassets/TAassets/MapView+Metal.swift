@@ -455,7 +455,7 @@ extension MetalMapFeatureRenderer {
             let boundingBox = map.worldPosition(ofMapIndex: i)
                 .center(inFootprint: feature.footprint)
                 .offset(by: feature.offset)
-                .adjust(forHeight: map.heightMap.samples[i])
+                .adjust(forHeight: map.heightMap.height(atMapIndex: i))
                 .makeRect(size: Size2f(feature.size))
             
             createRect(boundingBox, in: vertices)
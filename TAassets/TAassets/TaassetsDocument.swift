@@ -31,7 +31,7 @@ class TaassetsDocument: NSDocument {
             else { throw NSError(domain: NSOSStatusErrorDomain, code: readErr, userInfo: nil) }
         
         let begin = Date()
-        filesystem = try! FileSystem(mergingHpisIn: directoryURL)
+        filesystem = try! FileSystem(mergingHpisIn: directoryURL, indexURL: FileSystem.cachedIndexURL(for: directoryURL))
         let end = Date()
         Swift.print("\(directoryURL.lastPathComponent) filesystem load time: \(end.timeIntervalSince(begin)) seconds")
         